@@ -13,18 +13,56 @@
 extern "C" {
 #endif
 
-#define FILENAME_LENGTH 128
-#define DATA_LENGTH 1024
-#define DIRNAME_LENGTH 256
-#define MAX_FILES 10
-#define MAX_FILENAMES_LENGTH 128
+#define MAX_FILENAME_LENGTH 128
+#define MAX_FILES 50
+#define MAX_PATH_LENGTH 4096
+#define MAX_XFER_SIZE 7168
+#define MAX_BULK_FILES 64
+#define MAX_EXTENTS 256
+#define MAX_SIGS 512
+#define SUM_SIZE 32
+#define CODEC_NONE 0
+#define CODEC_LZ4 1
+#define CODEC_ZSTD 2
+#define SUM_SHA256 0
+#define SUM_CRC32C 1
+#define ERR_CHECKSUM -2
+#define CAS_CHUNK_SIZE 4096
+#define MAX_CAS_HASHES 128
+#define ERR_NO_CAS -3
+#define ERR_MISSING_CHUNK -4
+#define LEASE_SECONDS 10
+#define LEASE_NONE 0
+#define LEASE_READ 1
+#define LEASE_WRITE 2
+#define MAX_RECALLS 32
+#define ERR_LOCKED -5
+#define ERR_DELAY -6
+#define ERR_TOO_BIG -7
+#define BUSY_MARK 1112888153
+#define MAX_EVENTS 128
+#define EV_CREATE 1
+#define EV_DELETE 2
+#define EV_MODIFY 3
+#define EV_RENAME_FROM 4
+#define EV_RENAME_TO 5
+#define MAX_FIND_ENTRIES 64
+#define FIND_ANY 0
+#define FIND_FILE 1
+#define FIND_DIR 2
+#define BULK_OK 0
+#define BULK_ERROR -1
+#define BULK_TOO_BIG -2
 
 struct request {
 	char *filename;
-	int start;
-	int src_offset;
-	int dest_offset;
-	int size;
+	u_int size;
+	u_int src_offset;
+	u_int dest_offset;
+	int codec;
+	int level;
+	bool_t want_crc;
+	u_quad_t client;
 };
 typedef struct request request;
 
@@ -35,15 +73,76 @@ struct chunk {
 		char *data_val;
 	} data;
 	int size;
-	int dest_offset;
+	u_int dest_offset;
+	bool_t eof;
+	u_int file_size;
+	int codec;
+	bool_t has_crc;
+	u_int crc;
+	u_quad_t client;
 };
 typedef struct chunk chunk;
 
+struct extent {
+	u_int offset;
+	u_int length;
+};
+typedef struct extent extent;
 
-struct opendir_args {
-	char *dirname;
+struct extent_result {
+	int status;
+	u_int file_size;
+	struct {
+		u_int extents_len;
+		extent *extents_val;
+	} extents;
+	bool_t more;
+};
+typedef struct extent_result extent_result;
+
+struct sig_args {
+	char *filename;
+	u_int block_size;
+	u_int start_block;
+	u_quad_t client;
+};
+typedef struct sig_args sig_args;
+
+struct block_sig {
+	u_int weak;
+	u_quad_t strong;
+};
+typedef struct block_sig block_sig;
+
+struct sig_result {
+	int status;
+	u_int file_size;
+	u_int block_size;
+	struct {
+		u_int sigs_len;
+		block_sig *sigs_val;
+	} sigs;
+	bool_t more;
+};
+typedef struct sig_result sig_result;
+
+struct sum_args {
+	char *filename;
+	u_int offset;
+	u_int length;
+	int algo;
+	u_quad_t client;
+};
+typedef struct sum_args sum_args;
+
+struct sum_result {
+	int status;
+	u_int file_size;
+	char sum[SUM_SIZE];
 };
-typedef struct opendir_args opendir_args;
+typedef struct sum_result sum_result;
+
+typedef char *filename_t;
 
 struct readdir_args {
 	char *dirname;
@@ -51,11 +150,215 @@ struct readdir_args {
 typedef struct readdir_args readdir_args;
 
 struct readdir_result {
-	char **filenames;
-	bool_t more;
+	struct {
+		u_int filenames_len;
+		filename_t *filenames_val;
+	} filenames;
 };
 typedef struct readdir_result readdir_result;
 
+struct bulk_args {
+	struct {
+		u_int paths_len;
+		filename_t *paths_val;
+	} paths;
+	char *dirname;
+	char *pattern;
+	u_int cookie;
+	u_int max_bytes;
+};
+typedef struct bulk_args bulk_args;
+
+struct bulk_entry {
+	filename_t filename;
+	int status;
+	u_int file_size;
+	struct {
+		u_int data_len;
+		char *data_val;
+	} data;
+};
+typedef struct bulk_entry bulk_entry;
+
+struct bulk_result {
+	struct {
+		u_int entries_len;
+		bulk_entry *entries_val;
+	} entries;
+	u_int cookie;
+	bool_t more;
+};
+typedef struct bulk_result bulk_result;
+
+typedef char cas_hash[SUM_SIZE];
+
+struct cas_query {
+	struct {
+		u_int hashes_len;
+		cas_hash *hashes_val;
+	} hashes;
+};
+typedef struct cas_query cas_query;
+
+struct cas_have {
+	int status;
+	struct {
+		u_int have_len;
+		char *have_val;
+	} have;
+};
+typedef struct cas_have cas_have;
+
+struct cas_chunk {
+	cas_hash hash;
+	struct {
+		u_int data_len;
+		char *data_val;
+	} data;
+	int size;
+	int codec;
+};
+typedef struct cas_chunk cas_chunk;
+
+struct cas_manifest {
+	char *filename;
+	u_int file_size;
+	u_int start;
+	struct {
+		u_int hashes_len;
+		cas_hash *hashes_val;
+	} hashes;
+	bool_t last;
+	u_quad_t client;
+};
+typedef struct cas_manifest cas_manifest;
+
+struct lock_args {
+	u_quad_t client;
+	char *filename;
+	u_int offset;
+	u_int length;
+	bool_t exclusive;
+};
+typedef struct lock_args lock_args;
+
+struct lease_args {
+	u_quad_t client;
+	char *filename;
+	int type;
+};
+typedef struct lease_args lease_args;
+
+struct lease_result {
+	int status;
+	int type;
+	u_int seconds;
+	u_int file_size;
+};
+typedef struct lease_result lease_result;
+
+struct renew_result {
+	int status;
+	struct {
+		u_int recalled_len;
+		filename_t *recalled_val;
+	} recalled;
+};
+typedef struct renew_result renew_result;
+
+struct watch_args {
+	char *dirname;
+	u_int cookie;
+};
+typedef struct watch_args watch_args;
+
+struct watch_event {
+	int type;
+	filename_t name;
+};
+typedef struct watch_event watch_event;
+
+struct watch_result {
+	int status;
+	u_int cookie;
+	bool_t overflow;
+	struct {
+		u_int events_len;
+		watch_event *events_val;
+	} events;
+	bool_t more;
+};
+typedef struct watch_result watch_result;
+
+struct list_args {
+	char *dirname;
+	u_int cookie;
+	bool_t sorted;
+};
+typedef struct list_args list_args;
+
+struct list_result {
+	int status;
+	u_int total;
+	u_int count;
+	u_int cookie;
+	bool_t more;
+	char *names;
+};
+typedef struct list_result list_result;
+
+struct find_args {
+	char *dirname;
+	char *pattern;
+	bool_t regex;
+	int type;
+	u_quad_t min_size;
+	u_quad_t max_size;
+	quad_t newer_than;
+	quad_t older_than;
+	u_int cookie;
+};
+typedef struct find_args find_args;
+
+struct find_entry {
+	char *path;
+	int type;
+	u_quad_t size;
+	quad_t mtime;
+};
+typedef struct find_entry find_entry;
+
+struct find_result {
+	int status;
+	u_int total;
+	u_int cookie;
+	bool_t more;
+	struct {
+		u_int entries_len;
+		find_entry *entries_val;
+	} entries;
+};
+typedef struct find_result find_result;
+
+struct du_result {
+	int status;
+	u_quad_t bytes;
+	u_quad_t blocks;
+	u_int files;
+	u_int dirs;
+	bool_t cached;
+};
+typedef struct du_result du_result;
+
+struct attr_result {
+	int status;
+	int type;
+	u_int file_size;
+	quad_t mtime;
+	u_int mtime_nsec;
+};
+typedef struct attr_result attr_result;
+
 #define NFS_PROGRAM 0x21000001
 #define NFS_VERSION_1 1
 
@@ -78,24 +381,72 @@ extern  int * send_file_1_svc(chunk *, struct svc_req *);
 #define mynfs_mkdir 6
 extern  int * mynfs_mkdir_1(char **, CLIENT *);
 extern  int * mynfs_mkdir_1_svc(char **, struct svc_req *);
-#define mynfs_open 7
-extern  int * mynfs_open_1(char **, CLIENT *);
-extern  int * mynfs_open_1_svc(char **, struct svc_req *);
-#define mynfs_close 8
-extern  int * mynfs_close_1(char **, CLIENT *);
-extern  int * mynfs_close_1_svc(char **, struct svc_req *);
-#define mynfs_read 9
+#define mynfs_remdir 7
+extern  int * mynfs_remdir_1(char **, CLIENT *);
+extern  int * mynfs_remdir_1_svc(char **, struct svc_req *);
+#define mynfs_read 8
 extern  chunk * mynfs_read_1(request *, CLIENT *);
 extern  chunk * mynfs_read_1_svc(request *, struct svc_req *);
-#define mynfs_write 10
+#define mynfs_write 9
 extern  int * mynfs_write_1(chunk *, CLIENT *);
 extern  int * mynfs_write_1_svc(chunk *, struct svc_req *);
-#define mynfs_opendir 11
-extern  int * mynfs_opendir_1(opendir_args *, CLIENT *);
-extern  int * mynfs_opendir_1_svc(opendir_args *, struct svc_req *);
-#define mynfs_readdir 12
+#define mynfs_readdir 10
 extern  readdir_result * mynfs_readdir_1(readdir_args *, CLIENT *);
 extern  readdir_result * mynfs_readdir_1_svc(readdir_args *, struct svc_req *);
+#define mynfs_bulk_read 11
+extern  bulk_result * mynfs_bulk_read_1(bulk_args *, CLIENT *);
+extern  bulk_result * mynfs_bulk_read_1_svc(bulk_args *, struct svc_req *);
+#define mynfs_extents 12
+extern  extent_result * mynfs_extents_1(request *, CLIENT *);
+extern  extent_result * mynfs_extents_1_svc(request *, struct svc_req *);
+#define mynfs_truncate 13
+extern  int * mynfs_truncate_1(request *, CLIENT *);
+extern  int * mynfs_truncate_1_svc(request *, struct svc_req *);
+#define mynfs_signatures 14
+extern  sig_result * mynfs_signatures_1(sig_args *, CLIENT *);
+extern  sig_result * mynfs_signatures_1_svc(sig_args *, struct svc_req *);
+#define mynfs_checksum 15
+extern  sum_result * mynfs_checksum_1(sum_args *, CLIENT *);
+extern  sum_result * mynfs_checksum_1_svc(sum_args *, struct svc_req *);
+#define mynfs_codecs 16
+extern  int * mynfs_codecs_1(void *, CLIENT *);
+extern  int * mynfs_codecs_1_svc(void *, struct svc_req *);
+#define mynfs_has_chunks 17
+extern  cas_have * mynfs_has_chunks_1(cas_query *, CLIENT *);
+extern  cas_have * mynfs_has_chunks_1_svc(cas_query *, struct svc_req *);
+#define mynfs_put_chunk 18
+extern  int * mynfs_put_chunk_1(cas_chunk *, CLIENT *);
+extern  int * mynfs_put_chunk_1_svc(cas_chunk *, struct svc_req *);
+#define mynfs_put_manifest 19
+extern  int * mynfs_put_manifest_1(cas_manifest *, CLIENT *);
+extern  int * mynfs_put_manifest_1_svc(cas_manifest *, struct svc_req *);
+#define mynfs_lock 20
+extern  int * mynfs_lock_1(lock_args *, CLIENT *);
+extern  int * mynfs_lock_1_svc(lock_args *, struct svc_req *);
+#define mynfs_unlock 21
+extern  int * mynfs_unlock_1(lock_args *, CLIENT *);
+extern  int * mynfs_unlock_1_svc(lock_args *, struct svc_req *);
+#define mynfs_lease 22
+extern  lease_result * mynfs_lease_1(lease_args *, CLIENT *);
+extern  lease_result * mynfs_lease_1_svc(lease_args *, struct svc_req *);
+#define mynfs_renew 23
+extern  renew_result * mynfs_renew_1(u_quad_t *, CLIENT *);
+extern  renew_result * mynfs_renew_1_svc(u_quad_t *, struct svc_req *);
+#define mynfs_watch 24
+extern  watch_result * mynfs_watch_1(watch_args *, CLIENT *);
+extern  watch_result * mynfs_watch_1_svc(watch_args *, struct svc_req *);
+#define mynfs_list 25
+extern  list_result * mynfs_list_1(list_args *, CLIENT *);
+extern  list_result * mynfs_list_1_svc(list_args *, struct svc_req *);
+#define mynfs_find 26
+extern  find_result * mynfs_find_1(find_args *, CLIENT *);
+extern  find_result * mynfs_find_1_svc(find_args *, struct svc_req *);
+#define mynfs_du 27
+extern  du_result * mynfs_du_1(char **, CLIENT *);
+extern  du_result * mynfs_du_1_svc(char **, struct svc_req *);
+#define mynfs_getattr 28
+extern  attr_result * mynfs_getattr_1(char **, CLIENT *);
+extern  attr_result * mynfs_getattr_1_svc(char **, struct svc_req *);
 extern int nfs_program_1_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
 
 #else /* K&R C */
@@ -117,24 +468,72 @@ extern  int * send_file_1_svc();
 #define mynfs_mkdir 6
 extern  int * mynfs_mkdir_1();
 extern  int * mynfs_mkdir_1_svc();
-#define mynfs_open 7
-extern  int * mynfs_open_1();
-extern  int * mynfs_open_1_svc();
-#define mynfs_close 8
-extern  int * mynfs_close_1();
-extern  int * mynfs_close_1_svc();
-#define mynfs_read 9
+#define mynfs_remdir 7
+extern  int * mynfs_remdir_1();
+extern  int * mynfs_remdir_1_svc();
+#define mynfs_read 8
 extern  chunk * mynfs_read_1();
 extern  chunk * mynfs_read_1_svc();
-#define mynfs_write 10
+#define mynfs_write 9
 extern  int * mynfs_write_1();
 extern  int * mynfs_write_1_svc();
-#define mynfs_opendir 11
-extern  int * mynfs_opendir_1();
-extern  int * mynfs_opendir_1_svc();
-#define mynfs_readdir 12
+#define mynfs_readdir 10
 extern  readdir_result * mynfs_readdir_1();
 extern  readdir_result * mynfs_readdir_1_svc();
+#define mynfs_bulk_read 11
+extern  bulk_result * mynfs_bulk_read_1();
+extern  bulk_result * mynfs_bulk_read_1_svc();
+#define mynfs_extents 12
+extern  extent_result * mynfs_extents_1();
+extern  extent_result * mynfs_extents_1_svc();
+#define mynfs_truncate 13
+extern  int * mynfs_truncate_1();
+extern  int * mynfs_truncate_1_svc();
+#define mynfs_signatures 14
+extern  sig_result * mynfs_signatures_1();
+extern  sig_result * mynfs_signatures_1_svc();
+#define mynfs_checksum 15
+extern  sum_result * mynfs_checksum_1();
+extern  sum_result * mynfs_checksum_1_svc();
+#define mynfs_codecs 16
+extern  int * mynfs_codecs_1();
+extern  int * mynfs_codecs_1_svc();
+#define mynfs_has_chunks 17
+extern  cas_have * mynfs_has_chunks_1();
+extern  cas_have * mynfs_has_chunks_1_svc();
+#define mynfs_put_chunk 18
+extern  int * mynfs_put_chunk_1();
+extern  int * mynfs_put_chunk_1_svc();
+#define mynfs_put_manifest 19
+extern  int * mynfs_put_manifest_1();
+extern  int * mynfs_put_manifest_1_svc();
+#define mynfs_lock 20
+extern  int * mynfs_lock_1();
+extern  int * mynfs_lock_1_svc();
+#define mynfs_unlock 21
+extern  int * mynfs_unlock_1();
+extern  int * mynfs_unlock_1_svc();
+#define mynfs_lease 22
+extern  lease_result * mynfs_lease_1();
+extern  lease_result * mynfs_lease_1_svc();
+#define mynfs_renew 23
+extern  renew_result * mynfs_renew_1();
+extern  renew_result * mynfs_renew_1_svc();
+#define mynfs_watch 24
+extern  watch_result * mynfs_watch_1();
+extern  watch_result * mynfs_watch_1_svc();
+#define mynfs_list 25
+extern  list_result * mynfs_list_1();
+extern  list_result * mynfs_list_1_svc();
+#define mynfs_find 26
+extern  find_result * mynfs_find_1();
+extern  find_result * mynfs_find_1_svc();
+#define mynfs_du 27
+extern  du_result * mynfs_du_1();
+extern  du_result * mynfs_du_1_svc();
+#define mynfs_getattr 28
+extern  attr_result * mynfs_getattr_1();
+extern  attr_result * mynfs_getattr_1_svc();
 extern int nfs_program_1_freeresult ();
 #endif /* K&R C */
 
@@ -143,18 +542,74 @@ extern int nfs_program_1_freeresult ();
 #if defined(__STDC__) || defined(__cplusplus)
 extern  bool_t xdr_request (XDR *, request*);
 extern  bool_t xdr_chunk (XDR *, chunk*);
-extern  bool_t xdr_chunk (XDR *, chunk*);
-extern  bool_t xdr_opendir_args (XDR *, opendir_args*);
+extern  bool_t xdr_extent (XDR *, extent*);
+extern  bool_t xdr_extent_result (XDR *, extent_result*);
+extern  bool_t xdr_sig_args (XDR *, sig_args*);
+extern  bool_t xdr_block_sig (XDR *, block_sig*);
+extern  bool_t xdr_sig_result (XDR *, sig_result*);
+extern  bool_t xdr_sum_args (XDR *, sum_args*);
+extern  bool_t xdr_sum_result (XDR *, sum_result*);
+extern  bool_t xdr_filename_t (XDR *, filename_t*);
 extern  bool_t xdr_readdir_args (XDR *, readdir_args*);
 extern  bool_t xdr_readdir_result (XDR *, readdir_result*);
+extern  bool_t xdr_bulk_args (XDR *, bulk_args*);
+extern  bool_t xdr_bulk_entry (XDR *, bulk_entry*);
+extern  bool_t xdr_bulk_result (XDR *, bulk_result*);
+extern  bool_t xdr_cas_hash (XDR *, cas_hash);
+extern  bool_t xdr_cas_query (XDR *, cas_query*);
+extern  bool_t xdr_cas_have (XDR *, cas_have*);
+extern  bool_t xdr_cas_chunk (XDR *, cas_chunk*);
+extern  bool_t xdr_cas_manifest (XDR *, cas_manifest*);
+extern  bool_t xdr_lock_args (XDR *, lock_args*);
+extern  bool_t xdr_lease_args (XDR *, lease_args*);
+extern  bool_t xdr_lease_result (XDR *, lease_result*);
+extern  bool_t xdr_renew_result (XDR *, renew_result*);
+extern  bool_t xdr_watch_args (XDR *, watch_args*);
+extern  bool_t xdr_watch_event (XDR *, watch_event*);
+extern  bool_t xdr_watch_result (XDR *, watch_result*);
+extern  bool_t xdr_list_args (XDR *, list_args*);
+extern  bool_t xdr_list_result (XDR *, list_result*);
+extern  bool_t xdr_find_args (XDR *, find_args*);
+extern  bool_t xdr_find_entry (XDR *, find_entry*);
+extern  bool_t xdr_find_result (XDR *, find_result*);
+extern  bool_t xdr_du_result (XDR *, du_result*);
+extern  bool_t xdr_attr_result (XDR *, attr_result*);
 
 #else /* K&R C */
 extern bool_t xdr_request ();
 extern bool_t xdr_chunk ();
-extern bool_t xdr_chunk ();
-extern bool_t xdr_opendir_args ();
+extern bool_t xdr_extent ();
+extern bool_t xdr_extent_result ();
+extern bool_t xdr_sig_args ();
+extern bool_t xdr_block_sig ();
+extern bool_t xdr_sig_result ();
+extern bool_t xdr_sum_args ();
+extern bool_t xdr_sum_result ();
+extern bool_t xdr_filename_t ();
 extern bool_t xdr_readdir_args ();
 extern bool_t xdr_readdir_result ();
+extern bool_t xdr_bulk_args ();
+extern bool_t xdr_bulk_entry ();
+extern bool_t xdr_bulk_result ();
+extern bool_t xdr_cas_hash ();
+extern bool_t xdr_cas_query ();
+extern bool_t xdr_cas_have ();
+extern bool_t xdr_cas_chunk ();
+extern bool_t xdr_cas_manifest ();
+extern bool_t xdr_lock_args ();
+extern bool_t xdr_lease_args ();
+extern bool_t xdr_lease_result ();
+extern bool_t xdr_renew_result ();
+extern bool_t xdr_watch_args ();
+extern bool_t xdr_watch_event ();
+extern bool_t xdr_watch_result ();
+extern bool_t xdr_list_args ();
+extern bool_t xdr_list_result ();
+extern bool_t xdr_find_args ();
+extern bool_t xdr_find_entry ();
+extern bool_t xdr_find_result ();
+extern bool_t xdr_du_result ();
+extern bool_t xdr_attr_result ();
 
 #endif /* K&R C */
 
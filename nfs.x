@@ -1,6 +1,68 @@
 const MAX_FILENAME_LENGTH = 128;
 const MAX_FILES           = 50;
 const MAX_PATH_LENGTH     = 4096;
+const MAX_XFER_SIZE       = 7168;   /* payload maxim intr-un raspuns UDP */
+const MAX_BULK_FILES      = 64;
+const MAX_EXTENTS         = 256;
+const MAX_SIGS            = 512;
+const SUM_SIZE            = 32;     /* sha256 */
+
+/* compresie pe chunk */
+const CODEC_NONE          = 0;
+const CODEC_LZ4           = 1;
+const CODEC_ZSTD          = 2;
+
+/* algoritmi pt mynfs_checksum */
+const SUM_SHA256          = 0;
+const SUM_CRC32C          = 1;      /* in primii 4 bytes din sum, big-endian */
+
+/* raspuns la scriere: chunk-ul nu a trecut de verificarea CRC32C */
+const ERR_CHECKSUM        = -2;
+
+/* depozit deduplicat: chunk-uri fixe adresate prin sha256 */
+const CAS_CHUNK_SIZE      = 4096;
+const MAX_CAS_HASHES      = 128;    /* hash-uri per apel */
+const ERR_NO_CAS          = -3;     /* serverul nu ruleaza cu depozitul deduplicat */
+const ERR_MISSING_CHUNK   = -4;     /* manifestul cere chunk-uri pe care serverul nu le are */
+
+/* blocari pe intervale si lease-uri; starea unui client expira daca nu
+   reinnoieste in LEASE_SECONDS */
+const LEASE_SECONDS       = 10;
+const LEASE_NONE          = 0;      /* cerut la mynfs_lease = lease-ul se preda */
+const LEASE_READ          = 1;
+const LEASE_WRITE         = 2;
+const MAX_RECALLS         = 32;
+const ERR_LOCKED          = -5;     /* interval blocat de alt client */
+const ERR_DELAY           = -6;     /* lease in curs de rechemare, se reincearca */
+
+/* fisier de 4 GiB sau mai mare: offset-urile si dimensiunile din protocol
+   sunt pe 32 de biti, deci nu se poate transfera corect */
+const ERR_TOO_BIG         = -7;
+
+/* cerere respinsa de planificatorul serverului inainte sa fie executata:
+   raspuns RPC MSG_DENIED / RPC_MISMATCH cu low = high = BUSY_MARK, pe care
+   un server nu-l da altfel unui apel RPC versiunea 2; se poate retrimite */
+const BUSY_MARK           = 1112888153;     /* "BUSY" */
+
+/* evenimente mynfs_watch */
+const MAX_EVENTS          = 128;
+const EV_CREATE           = 1;
+const EV_DELETE           = 2;
+const EV_MODIFY           = 3;
+const EV_RENAME_FROM      = 4;      /* numele vechi, urmat de EV_RENAME_TO */
+const EV_RENAME_TO        = 5;
+
+/* mynfs_find */
+const MAX_FIND_ENTRIES    = 64;
+const FIND_ANY            = 0;
+const FIND_FILE           = 1;
+const FIND_DIR            = 2;
+
+/* status per fisier in bulk_read */
+const BULK_OK             = 0;
+const BULK_ERROR          = -1;
+const BULK_TOO_BIG        = -2;     /* nu incape, se citeste cu mynfs_read */
+/* ERR_DELAY: alt client are lease de scriere, se citeste cu mynfs_read */
 
 
 struct request {
@@ -8,16 +70,75 @@ struct request {
     unsigned int size;
     unsigned int src_offset;
     unsigned int dest_offset;
+    int    codec;             /* compresia acceptata in raspuns, CODEC_* */
+    int    level;
+    bool   want_crc;          /* raspunsul sa aiba CRC32C */
+    unsigned hyper client;    /* id-ul clientului, 0 = anonim */
 };
 
 struct chunk {
     string filename<MAX_FILENAME_LENGTH>;
-    opaque data<>;            /* payload variabil */
-    int    size;
+    opaque data<>;            /* payload variabil, comprimat daca codec != 0 */
+    int    size;              /* dimensiunea necomprimata */
     unsigned int dest_offset;
+    bool   eof;               /* raspuns: s-a ajuns la sfarsitul fisierului */
+    unsigned int file_size;   /* raspuns: dimensiunea curenta a fisierului */
+    int    codec;             /* CODEC_* folosit pt data */
+    bool   has_crc;
+    unsigned int crc;         /* CRC32C pe datele necomprimate */
+    unsigned hyper client;
 };
 
 
+/* zona cu date dintr-un fisier sparse */
+struct extent {
+    unsigned int offset;
+    unsigned int length;
+};
+
+struct extent_result {
+    int          status;
+    unsigned int file_size;
+    extent       extents<MAX_EXTENTS>;   /* doar zonele cu date, in ordine */
+    bool         more;                   /* se reia de la ultimul extent */
+};
+
+/* semnaturi pe blocuri pt delta-sync */
+struct sig_args {
+    string       filename<MAX_FILENAME_LENGTH>;
+    unsigned int block_size;    /* 0 = implicit */
+    unsigned int start_block;
+    unsigned hyper client;      /* lease-ul propriu nu e conflict */
+};
+
+struct block_sig {
+    unsigned int   weak;        /* suma rostogolita tip rsync */
+    unsigned hyper strong;      /* primii 8 bytes din sha256 */
+};
+
+struct sig_result {
+    int          status;
+    unsigned int file_size;
+    unsigned int block_size;
+    block_sig    sigs<MAX_SIGS>;
+    bool         more;
+};
+
+/* suma pe [offset, offset + length), length 0 = pana la sfarsit */
+struct sum_args {
+    string       filename<MAX_FILENAME_LENGTH>;
+    unsigned int offset;
+    unsigned int length;
+    int          algo;          /* SUM_* */
+    unsigned hyper client;
+};
+
+struct sum_result {
+    int          status;
+    unsigned int file_size;
+    opaque       sum[SUM_SIZE];
+};
+
 typedef string filename_t<MAX_FILENAME_LENGTH>;
 
 struct readdir_args {
@@ -28,6 +149,166 @@ struct readdir_result {
     filename_t filenames<MAX_FILES>;
 };
 
+/* fie lista explicita de cai, fie director + glob */
+struct bulk_args {
+    filename_t   paths<MAX_BULK_FILES>;
+    string       dirname<MAX_PATH_LENGTH>;
+    string       pattern<MAX_FILENAME_LENGTH>;
+    unsigned int cookie;        /* de unde se reia listarea */
+    unsigned int max_bytes;     /* 0 = MAX_XFER_SIZE */
+};
+
+struct bulk_entry {
+    filename_t   filename;
+    int          status;
+    unsigned int file_size;
+    opaque       data<>;
+};
+
+struct bulk_result {
+    bulk_entry   entries<MAX_BULK_FILES>;
+    unsigned int cookie;        /* urmatorul index */
+    bool         more;
+};
+
+typedef opaque cas_hash[SUM_SIZE];
+
+struct cas_query {
+    cas_hash     hashes<MAX_CAS_HASHES>;
+};
+
+struct cas_have {
+    int          status;
+    opaque       have<MAX_CAS_HASHES>;   /* 1 daca chunk-ul exista deja */
+};
+
+struct cas_chunk {
+    cas_hash     hash;          /* sha256 pe datele necomprimate */
+    opaque       data<>;
+    int          size;          /* dimensiunea necomprimata */
+    int          codec;
+};
+
+/* manifestul se trimite pe bucati, de la start; last il publica */
+struct cas_manifest {
+    string       filename<MAX_FILENAME_LENGTH>;
+    unsigned int file_size;
+    unsigned int start;
+    cas_hash     hashes<MAX_CAS_HASHES>;
+    bool         last;
+    unsigned hyper client;
+};
+
+/* length 0 = pana la sfarsitul fisierului */
+struct lock_args {
+    unsigned hyper client;
+    string       filename<MAX_FILENAME_LENGTH>;
+    unsigned int offset;
+    unsigned int length;
+    bool         exclusive;
+};
+
+struct lease_args {
+    unsigned hyper client;
+    string       filename<MAX_FILENAME_LENGTH>;
+    int          type;          /* LEASE_* */
+};
+
+struct lease_result {
+    int          status;
+    int          type;
+    unsigned int seconds;       /* valabil atat fara reinnoire */
+    unsigned int file_size;
+};
+
+/* fisierele ale caror lease-uri trebuie predate */
+struct renew_result {
+    int          status;
+    filename_t   recalled<MAX_RECALLS>;
+};
+
+/* cookie 0 = abonare noua, raspunsul da doar cookie-ul de start */
+struct watch_args {
+    string       dirname<MAX_PATH_LENGTH>;
+    unsigned int cookie;
+};
+
+struct watch_event {
+    int          type;          /* EV_* */
+    filename_t   name;
+};
+
+struct watch_result {
+    int          status;
+    unsigned int cookie;        /* de aici continua urmatorul apel */
+    bool         overflow;      /* s-au pierdut evenimente, se listeaza din nou */
+    watch_event  events<MAX_EVENTS>;
+    bool         more;
+};
+
+/* listare pe pagini, pt directoare mari */
+struct list_args {
+    string       dirname<MAX_PATH_LENGTH>;
+    unsigned int cookie;        /* indexul primei intrari */
+    bool         sorted;
+};
+
+struct list_result {
+    int          status;
+    unsigned int total;         /* intrari in director */
+    unsigned int count;         /* intrari in pagina asta */
+    unsigned int cookie;        /* urmatorul index */
+    bool         more;
+    string       names<>;       /* separate prin '\n', ca la ls */
+};
+
+/* cautare recursiva; filtrele cu 0 nu se aplica */
+struct find_args {
+    string         dirname<MAX_PATH_LENGTH>;
+    string         pattern<MAX_FILENAME_LENGTH>;   /* pe nume, gol = orice */
+    bool           regex;       /* pattern e regex extins, nu glob */
+    int            type;        /* FIND_* */
+    unsigned hyper min_size;
+    unsigned hyper max_size;
+    hyper          newer_than;  /* mtime, in secunde de la epoch */
+    hyper          older_than;
+    unsigned int   cookie;      /* indexul primului rezultat */
+};
+
+struct find_entry {
+    string         path<MAX_PATH_LENGTH>;          /* fata de dirname */
+    int            type;        /* FIND_FILE / FIND_DIR, FIND_ANY = altceva */
+    unsigned hyper size;
+    hyper          mtime;
+};
+
+struct find_result {
+    int            status;
+    unsigned int   total;       /* rezultate in tot subarborele */
+    unsigned int   cookie;      /* urmatorul index */
+    bool           more;
+    find_entry     entries<MAX_FIND_ENTRIES>;
+};
+
+/* spatiul ocupat de un subarbore */
+struct du_result {
+    int            status;
+    unsigned hyper bytes;       /* dimensiunea fisierelor, vazuta de clienti */
+    unsigned hyper blocks;      /* blocuri de 512 bytes ocupate pe disc */
+    unsigned int   files;
+    unsigned int   dirs;        /* subdirectoare, fara cel cerut */
+    bool           cached;      /* raspuns fara parcurgere */
+};
+
+/* atributele unui fisier, de ex. ca un transfer reluat sa stie daca sursa s-a schimbat */
+struct attr_result {
+    int            status;
+    int            type;        /* FIND_FILE / FIND_DIR, FIND_ANY = altceva */
+    unsigned int   file_size;
+    hyper          mtime;
+    unsigned int   mtime_nsec;
+};
+
 
 program NFS_PROGRAM {
     version NFS_VERSION_1 {
@@ -45,5 +326,46 @@ program NFS_PROGRAM {
         int             mynfs_write(chunk)            = 9;
 
         readdir_result  mynfs_readdir(readdir_args)   = 10;
+
+        /* mai multe fisiere mici intr-un singur apel */
+        bulk_result     mynfs_bulk_read(bulk_args)    = 11;
+
+        /* fisiere sparse: extenturile cu date (src_offset = de unde) */
+        extent_result   mynfs_extents(request)        = 12;
+        /* seteaza dimensiunea fisierului la request.size */
+        int             mynfs_truncate(request)       = 13;
+
+        /* delta-sync: semnaturile blocurilor si suma intregului fisier */
+        sig_result      mynfs_signatures(sig_args)    = 14;
+        sum_result      mynfs_checksum(sum_args)      = 15;
+
+        /* bitmask cu codec-urile suportate de server (1 << CODEC_*) */
+        int             mynfs_codecs(void)            = 16;
+
+        /* upload deduplicat: ce chunk-uri lipsesc, chunk-urile, manifestul */
+        cas_have        mynfs_has_chunks(cas_query)   = 17;
+        int             mynfs_put_chunk(cas_chunk)    = 18;
+        int             mynfs_put_manifest(cas_manifest) = 19;
+
+        /* blocari pe intervale si lease-uri pt cache-ul clientului */
+        int             mynfs_lock(lock_args)         = 20;
+        int             mynfs_unlock(lock_args)       = 21;
+        lease_result    mynfs_lease(lease_args)       = 22;
+        renew_result    mynfs_renew(unsigned hyper)   = 23;
+
+        /* schimbarile dintr-un director de la cookie incoace */
+        watch_result    mynfs_watch(watch_args)       = 24;
+
+        /* ls complet pe pagini, optional sortat */
+        list_result     mynfs_list(list_args)         = 25;
+
+        /* cautare in subarbore dupa nume, tip, dimensiune, mtime */
+        find_result     mynfs_find(find_args)         = 26;
+
+        /* dimensiune recursiva, numar de fisiere si blocuri */
+        du_result       mynfs_du(string)              = 27;
+
+        /* dimensiune si mtime; suma pe interval vine de la mynfs_checksum */
+        attr_result     mynfs_getattr(string)         = 28;
     } = 1;
 } = 0x21000001;
\ No newline at end of file
@@ -0,0 +1,443 @@
+#define _GNU_SOURCE   // memfd_create
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "nfs.h"
+#include "nfs_cas.h"
+
+// manifest: magic, dimensiunea pe 20 de cifre, apoi cate un hash hex pe linie;
+// liniile au lungime fixa ca bucatile sa se poata scrie direct la pozitia lor
+#define MANIFEST_MAGIC "MYNFSCAS1\n"
+#define MAGIC_LEN 10
+#define HEADER_LEN (MAGIC_LEN + 21)
+#define LINE_LEN 65
+#define MANIFEST_TMP ".mynfs-manifest"
+#define UNPACK_TMP ".mynfs-unpack"
+
+static char cas_dir[PATH_MAX];
+static char cas_root[PATH_MAX];
+static int cas_on = 0;
+
+// ultimul manifest reconstituit; citirile pe chunk-uri ale aceluiasi fisier
+// nu il mai refac de fiecare data
+static struct {
+    dev_t dev;
+    ino_t ino;
+    struct timespec mtime;
+    int fd;
+} cache = { .fd = -1 };
+
+static void to_hex(const unsigned char *hash, char *out) {
+    static const char digits[] = "0123456789abcdef";
+    for (int i = 0; i < NFS_SHA256_LEN; i++) {
+        out[2 * i] = digits[hash[i] >> 4];
+        out[2 * i + 1] = digits[hash[i] & 15];
+    }
+    out[2 * NFS_SHA256_LEN] = '\0';
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static int from_hex(const char *s, unsigned char *hash) {
+    for (int i = 0; i < NFS_SHA256_LEN; i++) {
+        int hi = hex_digit(s[2 * i]), lo = hex_digit(s[2 * i + 1]);
+        if (hi < 0 || lo < 0) return -1;
+        hash[i] = (unsigned char)(hi << 4 | lo);
+    }
+    return 0;
+}
+
+static void sha256(const void *data, size_t len, unsigned char out[NFS_SHA256_LEN]) {
+    nfs_sha256_ctx ctx;
+    nfs_sha256_init(&ctx);
+    nfs_sha256_update(&ctx, data, len);
+    nfs_sha256_final(&ctx, out);
+}
+
+static int object_path(char *path, size_t len, const unsigned char *hash) {
+    char hex[2 * NFS_SHA256_LEN + 1];
+    to_hex(hash, hex);
+    int n = snprintf(path, len, "%s/%.2s/%s", cas_dir, hex, hex);
+    return n < 0 || (size_t)n >= len ? -1 : 0;
+}
+
+static int is_zero(const char *buf, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        if (buf[i]) return 0;
+    return 1;
+}
+
+// 1 daca fd e un manifest (si *size dimensiunea fisierului), 0 daca nu
+static int read_header(int fd, off_t *size) {
+    char header[HEADER_LEN + 1];
+    if (pread(fd, header, HEADER_LEN, 0) != HEADER_LEN) return 0;
+    if (memcmp(header, MANIFEST_MAGIC, MAGIC_LEN) != 0) return 0;
+    header[HEADER_LEN] = '\0';
+    *size = (off_t)strtoull(header + MAGIC_LEN, NULL, 10);
+    return 1;
+}
+
+int nfs_cas_init(const char *root) {
+    int n = snprintf(cas_dir, sizeof(cas_dir), "%s/%s", root, NFS_CAS_DIR);
+    if (n < 0 || (size_t)n >= sizeof(cas_dir)) return -1;
+    snprintf(cas_root, sizeof(cas_root), "%s", root);
+    if (mkdir(cas_dir, 0777) != 0 && errno != EEXIST) {
+        perror("nfs_cas_init mkdir");
+        return -1;
+    }
+    cas_on = 1;
+    return 0;
+}
+
+int nfs_cas_enabled(void) {
+    return cas_on;
+}
+
+int nfs_cas_has(const unsigned char hash[NFS_SHA256_LEN]) {
+    char path[PATH_MAX];
+    struct stat st;
+    return cas_on && object_path(path, sizeof(path), hash) == 0 && stat(path, &st) == 0;
+}
+
+int nfs_cas_put(const unsigned char hash[NFS_SHA256_LEN], const void *data, size_t len) {
+    if (!cas_on) return ERR_NO_CAS;
+    if (len > CAS_CHUNK_SIZE) return -1;
+
+    unsigned char check[NFS_SHA256_LEN];
+    sha256(data, len, check);
+    if (memcmp(check, hash, NFS_SHA256_LEN) != 0) return ERR_CHECKSUM;
+    if (nfs_cas_has(hash)) return 0;
+
+    // obiectele sunt impartite dupa primul byte, ca directoarele sa ramana mici
+    char path[PATH_MAX], tmp[PATH_MAX];
+    if (object_path(path, sizeof(path), hash) != 0) return -1;
+    char *slash = strrchr(path, '/');
+    *slash = '\0';
+    if (mkdir(path, 0777) != 0 && errno != EEXIST) {
+        perror("nfs_cas_put mkdir");
+        return -1;
+    }
+    *slash = '/';
+
+    // scris complet sau deloc: un chunk pe jumatate ar strica toate fisierele.
+    // Cu -w mai multe procese pot scrie acelasi chunk, deci fiecare are
+    // fisierul lui temporar (pid + contor)
+    static unsigned int tmp_seq = 0;
+    int n = snprintf(tmp, sizeof(tmp), "%s.%ld.%u.tmp", path, (long)getpid(), tmp_seq++);
+    if (n < 0 || (size_t)n >= sizeof(tmp)) return -1;
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL, 0666);
+    if (fd < 0) {
+        if (nfs_cas_has(hash)) return 0;   // publicat intre timp de alt worker
+        perror("nfs_cas_put open");
+        return -1;
+    }
+    int ok = write(fd, data, len) == (ssize_t)len;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(tmp, path) != 0) {
+        int err = errno;
+        unlink(tmp);
+        if (nfs_cas_has(hash)) return 0;
+        errno = err;
+        perror("nfs_cas_put write");
+        return -1;
+    }
+    return 0;
+}
+
+int nfs_cas_put_manifest(const char *path, off_t file_size, unsigned int start,
+                         const unsigned char (*hashes)[NFS_SHA256_LEN], unsigned int n, int last) {
+    if (!cas_on) return ERR_NO_CAS;
+
+    char tmp[PATH_MAX];
+    int len = snprintf(tmp, sizeof(tmp), "%s" MANIFEST_TMP, path);
+    if (len < 0 || (size_t)len >= sizeof(tmp)) return -1;
+
+    int fd = open(tmp, O_RDWR | O_CREAT | (start == 0 ? O_TRUNC : 0), 0666);
+    if (fd < 0) {
+        perror("nfs_cas_put_manifest open");
+        return -1;
+    }
+
+    char header[HEADER_LEN + 1];
+    char line[LINE_LEN + 1];
+    snprintf(header, sizeof(header), MANIFEST_MAGIC "%020llu\n", (unsigned long long)file_size);
+    int status = pwrite(fd, header, HEADER_LEN, 0) == HEADER_LEN ? 0 : -1;
+    for (unsigned int i = 0; status == 0 && i < n; i++) {
+        to_hex(hashes[i], line);
+        line[LINE_LEN - 1] = '\n';
+        off_t pos = HEADER_LEN + (off_t)(start + i) * LINE_LEN;
+        if (pwrite(fd, line, LINE_LEN, pos) != LINE_LEN) status = -1;
+    }
+    if (status != 0 || !last) {
+        if (status != 0) perror("nfs_cas_put_manifest write");
+        close(fd);
+        return status;
+    }
+
+    // se publica doar un manifest complet, cu toate chunk-urile pe disc
+    off_t count = (off_t)start + n;
+    if (count != (file_size + CAS_CHUNK_SIZE - 1) / CAS_CHUNK_SIZE ||
+        ftruncate(fd, HEADER_LEN + count * LINE_LEN) != 0) {
+        fprintf(stderr, "nfs_cas_put_manifest: %s has %lld chunks for %lld bytes\n",
+                path, (long long)count, (long long)file_size);
+        status = -1;
+    }
+    unsigned char hash[NFS_SHA256_LEN];
+    for (off_t i = 0; status == 0 && i < count; i++) {
+        if (pread(fd, line, LINE_LEN, HEADER_LEN + i * LINE_LEN) != LINE_LEN ||
+            from_hex(line, hash) != 0)
+            status = -1;
+        else if (!nfs_cas_has(hash))
+            status = ERR_MISSING_CHUNK;
+    }
+    close(fd);
+
+    if (status == 0 && rename(tmp, path) != 0) {
+        perror("nfs_cas_put_manifest rename");
+        status = -1;
+    }
+    if (status != 0) unlink(tmp);
+    return status;
+}
+
+// reconstituie continutul unui manifest intr-un fisier anonim din memorie;
+// chunk-urile cu zero raman gauri
+static int materialize(int mfd, off_t size) {
+    int out = memfd_create("mynfs-cas", 0);
+    if (out < 0) {
+        perror("nfs_cas memfd_create");
+        return -1;
+    }
+    if (ftruncate(out, size) != 0) goto fail;
+
+    char line[LINE_LEN], buf[CAS_CHUNK_SIZE], path[PATH_MAX];
+    unsigned char hash[NFS_SHA256_LEN];
+    off_t count = (size + CAS_CHUNK_SIZE - 1) / CAS_CHUNK_SIZE;
+    for (off_t i = 0; i < count; i++) {
+        off_t pos = i * CAS_CHUNK_SIZE;
+        size_t want = size - pos < CAS_CHUNK_SIZE ? (size_t)(size - pos) : CAS_CHUNK_SIZE;
+        if (pread(mfd, line, LINE_LEN, HEADER_LEN + i * LINE_LEN) != LINE_LEN ||
+            from_hex(line, hash) != 0 || object_path(path, sizeof(path), hash) != 0)
+            goto fail;
+
+        int cfd = open(path, O_RDONLY);
+        if (cfd < 0) goto fail;
+        ssize_t got = pread(cfd, buf, want, 0);
+        close(cfd);
+        if (got != (ssize_t)want) goto fail;
+
+        if (!is_zero(buf, want) && pwrite(out, buf, want, pos) != (ssize_t)want) goto fail;
+    }
+    return out;
+
+fail:
+    fprintf(stderr, "nfs_cas: cannot rebuild file from manifest (missing chunk?)\n");
+    close(out);
+    errno = EIO;
+    return -1;
+}
+
+int nfs_cas_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    off_t size;
+    if (fd < 0 || !cas_on || !read_header(fd, &size)) return fd;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (cache.fd < 0 || cache.dev != st.st_dev || cache.ino != st.st_ino ||
+        cache.mtime.tv_sec != st.st_mtim.tv_sec || cache.mtime.tv_nsec != st.st_mtim.tv_nsec) {
+        int out = materialize(fd, size);
+        if (out < 0) {
+            close(fd);
+            return -1;
+        }
+        if (cache.fd >= 0) close(cache.fd);
+        cache.dev = st.st_dev;
+        cache.ino = st.st_ino;
+        cache.mtime = st.st_mtim;
+        cache.fd = out;
+    }
+    close(fd);
+
+    // descriptor nou cu offset propriu, nu un dup al celui din cache
+    char proc[64];
+    snprintf(proc, sizeof(proc), "/proc/self/fd/%d", cache.fd);
+    return open(proc, O_RDONLY);
+}
+
+off_t nfs_cas_size(int dirfd, const char *name, const struct stat *st) {
+    if (!cas_on || !S_ISREG(st->st_mode) || st->st_size < HEADER_LEN) return st->st_size;
+    int fd = openat(dirfd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return st->st_size;
+    off_t size;
+    if (!read_header(fd, &size)) size = st->st_size;
+    close(fd);
+    return size;
+}
+
+FILE *nfs_cas_fopen(const char *path) {
+    int fd = nfs_cas_open(path);
+    if (fd < 0) return NULL;
+    FILE *file = fdopen(fd, "rb");
+    if (!file) close(fd);
+    return file;
+}
+
+int nfs_cas_unpack(const char *path) {
+    if (!cas_on) return 0;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;   // nu exista, se creeaza ca fisier obisnuit
+    off_t size;
+    int manifest = read_header(fd, &size);
+    close(fd);
+    if (!manifest) return 0;
+
+    int src = nfs_cas_open(path);
+    if (src < 0) return -1;
+
+    char tmp[PATH_MAX];
+    int len = snprintf(tmp, sizeof(tmp), "%s" UNPACK_TMP, path);
+    int out = len < 0 || (size_t)len >= sizeof(tmp) ? -1 : open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (out < 0) {
+        perror("nfs_cas_unpack open");
+        close(src);
+        return -1;
+    }
+
+    int status = ftruncate(out, size) == 0 ? 0 : -1;
+    char buf[CAS_CHUNK_SIZE];
+    for (off_t pos = 0; status == 0 && pos < size; pos += CAS_CHUNK_SIZE) {
+        ssize_t n = pread(src, buf, sizeof(buf), pos);
+        if (n <= 0) status = -1;
+        else if (!is_zero(buf, n) && pwrite(out, buf, n, pos) != n) status = -1;
+    }
+    close(src);
+    if (close(out) != 0) status = -1;
+
+    if (status == 0 && rename(tmp, path) != 0) status = -1;
+    if (status != 0) {
+        perror("nfs_cas_unpack");
+        unlink(tmp);
+    }
+    return status;
+}
+
+// gc: hash-urile din toate manifestele, sortate
+typedef struct {
+    unsigned char (*hashes)[NFS_SHA256_LEN];
+    size_t count, cap;
+} hash_set;
+
+static int cmp_hash(const void *a, const void *b) {
+    return memcmp(a, b, NFS_SHA256_LEN);
+}
+
+static int collect_manifest(const char *path, hash_set *set) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    off_t size;
+    if (!read_header(fd, &size)) {
+        close(fd);
+        return 0;
+    }
+
+    // si manifestele incomplete tin chunk-urile in viata
+    char line[LINE_LEN];
+    for (off_t pos = HEADER_LEN; pread(fd, line, LINE_LEN, pos) == LINE_LEN; pos += LINE_LEN) {
+        if (set->count == set->cap) {
+            size_t cap = set->cap ? set->cap * 2 : 1024;
+            void *tmp = realloc(set->hashes, cap * NFS_SHA256_LEN);
+            if (!tmp) {
+                close(fd);
+                return -1;
+            }
+            set->hashes = tmp;
+            set->cap = cap;
+        }
+        if (from_hex(line, set->hashes[set->count]) == 0) set->count++;
+    }
+    close(fd);
+    return 0;
+}
+
+static int collect_dir(const char *dir, hash_set *set) {
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+
+    int status = 0;
+    struct dirent *entry;
+    while (status == 0 && (entry = readdir(d)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0 ||
+            strcmp(entry->d_name, NFS_CAS_DIR) == 0)
+            continue;
+
+        char child[PATH_MAX];
+        struct stat st;
+        snprintf(child, sizeof(child), "%s/%s", dir, entry->d_name);
+        if (lstat(child, &st) != 0) continue;
+        if (S_ISDIR(st.st_mode))
+            status = collect_dir(child, set);
+        else if (S_ISREG(st.st_mode))
+            status = collect_manifest(child, set);
+    }
+    closedir(d);
+    return status;
+}
+
+int nfs_cas_gc(void) {
+    if (!cas_on) return 0;
+
+    hash_set set = { NULL, 0, 0 };
+    if (collect_dir(cas_root, &set) != 0) {
+        // mai bine chunk-uri in plus decat manifeste stricate
+        fprintf(stderr, "nfs_cas_gc: cannot scan %s, skipping\n", cas_root);
+        free(set.hashes);
+        return -1;
+    }
+    if (set.count > 1) qsort(set.hashes, set.count, NFS_SHA256_LEN, cmp_hash);
+
+    unsigned int removed = 0;
+    DIR *top = opendir(cas_dir);
+    struct dirent *sub;
+    while (top && (sub = readdir(top)) != NULL) {
+        if (sub->d_name[0] == '.') continue;
+        char dir[PATH_MAX];
+        int n = snprintf(dir, sizeof(dir), "%s/%s", cas_dir, sub->d_name);
+        if (n < 0 || (size_t)n >= sizeof(dir)) continue;
+        DIR *d = opendir(dir);
+        struct dirent *entry;
+        while (d && (entry = readdir(d)) != NULL) {
+            if (entry->d_name[0] == '.') continue;
+            unsigned char hash[NFS_SHA256_LEN];
+            int keep = strlen(entry->d_name) == 2 * NFS_SHA256_LEN &&
+                       from_hex(entry->d_name, hash) == 0 && set.count &&
+                       bsearch(hash, set.hashes, set.count, NFS_SHA256_LEN, cmp_hash);
+            if (keep) continue;
+
+            // obiecte nefolosite sau .tmp ramase de la o scriere intrerupta
+            char path[PATH_MAX];
+            n = snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+            if (n >= 0 && (size_t)n < sizeof(path) && unlink(path) == 0) removed++;
+        }
+        if (d) closedir(d);
+    }
+    if (top) closedir(top);
+    free(set.hashes);
+
+    printf("nfs_cas_gc: removed %u unused chunks\n", removed);
+    return 0;
+}
@@ -0,0 +1,44 @@
+#ifndef NFS_CAS_H
+#define NFS_CAS_H
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "nfs_hash.h"
+
+// depozit deduplicat pt directorul partajat: chunk-uri de CAS_CHUNK_SIZE
+// salvate o singura data in <root>/.cas/xx/<sha256>, iar fisierul propriu-zis
+// e un manifest text cu dimensiunea si lista de hash-uri
+
+#define NFS_CAS_DIR ".cas"
+
+// activeaza depozitul sub root; pana atunci functiile de mai jos se comporta
+// ca open/fopen obisnuite
+int nfs_cas_init(const char *root);
+int nfs_cas_enabled(void);
+
+// 1 daca chunk-ul exista deja
+int nfs_cas_has(const unsigned char hash[NFS_SHA256_LEN]);
+
+// salveaza un chunk; ERR_CHECKSUM daca datele nu au hash-ul dat
+int nfs_cas_put(const unsigned char hash[NFS_SHA256_LEN], const void *data, size_t len);
+
+// scrie hash-urile [start, start + n) in manifestul lui path; la last manifestul
+// inlocuieste fisierul, dupa ce toate chunk-urile au fost gasite
+int nfs_cas_put_manifest(const char *path, off_t file_size, unsigned int start,
+                         const unsigned char (*hashes)[NFS_SHA256_LEN], unsigned int n, int last);
+
+// deschidere pt citire; un manifest e reconstituit intr-un memfd
+int nfs_cas_open(const char *path);
+FILE *nfs_cas_fopen(const char *path);
+
+// dimensiunea vazuta de clienti pt name din dirfd (a fisierului, nu a manifestului)
+off_t nfs_cas_size(int dirfd, const char *name, const struct stat *st);
+
+// inainte de modificare: manifestul redevine fisier obisnuit
+int nfs_cas_unpack(const char *path);
+
+// sterge chunk-urile la care nu mai trimite niciun manifest
+int nfs_cas_gc(void);
+
+#endif
@@ -1,9 +1,23 @@
+#define _GNU_SOURCE   // SEEK_DATA / SEEK_HOLE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <rpc/rpc.h>
 #include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "nfs.h"
+#include "nfs_compress.h"
+#include "nfs_crc32c.h"
+#include "nfs_hash.h"
+#include "nfs_journal.h"
+#include "nfs_pool.h"
+#include "nfs_xdr_fast.h"
 
 #define COLOR_RESET   "\x1b[0m"
 #define COLOR_GREEN   "\x1b[32m"
@@ -18,12 +32,35 @@
 #endif
 
 
+#define DELTA_BLOCK_SIZE 4096   // bloc pt pull/push
+#define CHUNK_SIZE 512          // cat se transfera per apel
+#define CHUNK_SIZE_PACKED 4096  // cu compresie, comprimat tot incape intr-un datagram
+#define CRC_RETRIES 3           // de cate ori se reia un chunk cu CRC32C gresit
+#define DELAY_RETRIES 30        // cat se asteapta (s) un lease rechemat de la alt client
+#define CACHE_ENTRIES 16        // fisiere tinute local sub lease
+#define CACHE_MAX_FILE (1024 * 1024)
+#define MMAP_MIN_FILE (256 * 1024)  // de aici download-ul scrie direct in fisierul mapat
+#define WATCH_SECONDS 10        // cat ruleaza watch fara argument
+#define STRIPE_MIN_FILE (1024 * 1024)  // de aici transferurile se impart pe mai multe conexiuni
+#define STRIPE_PIECE (1024 * 1024)     // cat ia o conexiune odata din coada
+
+// compresia negociata cu serverul pt download/upload
+static int codec = CODEC_NONE;
+static int codec_level = 0;
+static int stripes = 4;   // conexiuni pt un transfer mare; 1 = doar cea din REPL
+
 static char current_dir[PATH_MAX] = ".";
 
+// identitatea clientului pt blocari si lease-uri
+static u_quad_t client_id;
+
+// ca in nfs_clnt.c, pt apelurile facute direct cu clnt_call
+static struct timeval rpc_timeout = { 25, 0 };
+
 static const char *commands[] = {
     "list", "make", "remove", "download", "upload",
     "makedr", "remdr", "read", "edit", "chdir",
-    "wherepd", "clear", "help", "bye", NULL
+    "fetch", "pull", "push", "compress", "checksum", "lock", "rlock", "unlock", "watch", "find", "du", "stripes", "wherepd", "clear", "help", "bye", NULL
 };
 
 void suggest_commands(const char *prefix) {
@@ -41,11 +78,23 @@ void print_help() {
     printf("  remove <file>     - delete a file\n");
     printf("  download <r> <l>  - download remote file to local\n");
     printf("  upload <l> <r>    - upload local file to remote\n");
+    printf("  pull <r> <l>      - download only the blocks that changed\n");
+    printf("  push <l> <r>      - upload only the blocks that changed\n");
     printf("  makedr <folder>   - create directory\n");
     printf("  remdr <folder>    - remove directory recursively\n");
     printf("  read <file>       - display file contents\n");
     printf("  edit <file>       - edit file interactively\n");
     printf("  chdir <folder>    - change directory\n");
+    printf("  fetch <glob> <l>  - download matching small files into local dir\n");
+    printf("  compress <c> [n]  - compress transfers: none, lz4, zstd (level n)\n");
+    printf("  checksum <r> [l]  - CRC32C of remote file, compared with local\n");
+    printf("  lock <r> [o:n]    - exclusive lock on n bytes from o (whole file)\n");
+    printf("  rlock <r> [o:n]   - shared lock\n");
+    printf("  unlock <r> [o:n]  - release a lock\n");
+    printf("  watch [sec]       - show changes in current directory (10 s)\n");
+    printf("  find <glob> [o,..]- search subtree; f, d, re, >size, <size, new=s, old=s\n");
+    printf("  du [folder]       - disk usage of a directory tree\n");
+    printf("  stripes [n]       - connections used by large transfers (4)\n");
     printf("  wherepd           - print current directory\n");
     printf("  clear             - clear the screen\n");
     printf("  help              - show this help\n");
@@ -53,12 +102,126 @@ void print_help() {
 }
 
 
+/* serverul recheama lease-ul altui client: se asteapta si se reia */
+static int retry_delay(int status, int *tries) {
+    if (status != ERR_DELAY || ++*tries > DELAY_RETRIES) return 0;
+    sleep(1);
+    return 1;
+}
+
+/* ultima listare, tinuta la zi din evenimentele de pe server */
+static struct {
+    char dir[PATH_MAX];
+    char *text;                  // nume separate prin '\n', ca la ls_1
+    u_int cookie;
+} listing;
+
+static void listing_reset(void) {
+    free(listing.text);
+    listing.text = NULL;
+    listing.cookie = 0;
+}
+
+// linia cu name din listare, NULL daca nu e
+static char *listing_find(const char *name) {
+    size_t n = strlen(name);
+    for (char *p = listing.text; p && *p; ) {
+        char *nl = strchr(p, '\n');
+        size_t len = nl ? (size_t)(nl - p) : strlen(p);
+        if (len == n && strncmp(p, name, n) == 0) return p;
+        p += nl ? len + 1 : len;
+    }
+    return NULL;
+}
+
+static int listing_apply(const watch_event *ev) {
+    char *line = listing_find(ev->name);
+    if ((ev->type == EV_CREATE || ev->type == EV_RENAME_TO) && !line) {
+        size_t used = strlen(listing.text), n = strlen(ev->name);
+        char *grown = realloc(listing.text, used + n + 2);
+        if (!grown) return -1;
+        listing.text = grown;
+
+        // listarea vine sortata, numele nou intra la locul lui
+        char *at = grown;
+        while (*at) {
+            char *nl = strchr(at, '\n');
+            size_t len = nl ? (size_t)(nl - at) : strlen(at);
+            int cmp = strncmp(at, ev->name, len < n ? len : n);
+            if (cmp > 0 || (cmp == 0 && len > n)) break;
+            at += nl ? len + 1 : len;
+        }
+        memmove(at + n + 1, at, strlen(at) + 1);
+        memcpy(at, ev->name, n);
+        at[n] = '\n';
+    } else if ((ev->type == EV_DELETE || ev->type == EV_RENAME_FROM) && line) {
+        char *next = line + strlen(ev->name);
+        if (*next == '\n') next++;
+        memmove(line, next, strlen(next) + 1);
+    }
+    return 0;
+}
 
-/* wrapper pt ls_1 */
+// 0 daca listarea din cache e la zi; altfel trebuie reluata de la zero
+static int listing_update(CLIENT *clnt) {
+    if (!listing.text || strcmp(listing.dir, current_dir) != 0) return -1;
+
+    watch_args args;
+    args.dirname = current_dir;
+    int more = 1;
+    while (more) {
+        args.cookie = listing.cookie;
+        watch_result *res = BUSY_RETRY(clnt, mynfs_watch_1(&args, clnt));
+        if (!res) return -1;
+        int ok = res->status == 0 && !res->overflow;
+        for (u_int i = 0; ok && i < res->events.events_len; i++)
+            if (listing_apply(&res->events.events_val[i]) != 0) ok = 0;
+        listing.cookie = res->cookie;
+        more = res->more;
+        xdr_free((xdrproc_t)xdr_watch_result, (caddr_t)res);
+        if (!ok) return -1;
+    }
+    return 0;
+}
+
+// tot directorul curent, sortat, pagina cu pagina
+static int list_all(CLIENT *clnt, char **text) {
+    list_args args;
+    args.dirname = current_dir;
+    args.cookie = 0;
+    args.sorted = TRUE;
+
+    char *out = NULL;
+    size_t len = 0;
+    int more = 1;
+    while (more) {
+        list_result *res = BUSY_RETRY(clnt, mynfs_list_1(&args, clnt));
+        if (!res || res->status != 0) {
+            if (res) xdr_free((xdrproc_t)xdr_list_result, (caddr_t)res);
+            free(out);
+            return -1;
+        }
+        size_t n = strlen(res->names);
+        char *grown = realloc(out, len + n + 1);
+        if (!grown) {
+            xdr_free((xdrproc_t)xdr_list_result, (caddr_t)res);
+            free(out);
+            return -1;
+        }
+        memcpy(grown + len, res->names, n + 1);
+        out = grown;
+        len += n;
+        args.cookie = res->cookie;
+        // o pagina goala cu more ar bucla la nesfarsit
+        more = res->more && res->count > 0;
+        xdr_free((xdrproc_t)xdr_list_result, (caddr_t)res);
+    }
+    *text = out;
+    return 0;
+}
+
+/* wrapper pt ls_1; listarea se reia doar cand serverul nu poate spune ce s-a schimbat */
 char **safe_ls(CLIENT *clnt) {
-    char *arg = current_dir;         
-    char **res = ls_1(&arg, clnt);    
-    if (!res) return NULL;
     // copie locala pt parsing
     static char *copy[MAX_FILES + 1] = {NULL};
     for (int i = 0; i < MAX_FILES; i++) {
@@ -67,13 +230,39 @@ char **safe_ls(CLIENT *clnt) {
             copy[i] = NULL;
         }
     }
-    for (int i = 0; i < MAX_FILES; i++) { copy[i] = NULL; }
-    if (*res) {
-        copy[0] = strdup(*res);       // rpcgen intoarce char* intr-un char**
-    }
     copy[MAX_FILES] = NULL;
-    xdr_free((xdrproc_t)xdr_wrapstring, (char*)res);
 
+    if (listing_update(clnt) == 0) {
+        copy[0] = strdup(listing.text);
+        return copy;
+    }
+    listing_reset();
+
+    // abonarea inainte de listare: ce se schimba intre ele vine ca eveniment
+    watch_args args;
+    args.dirname = current_dir;
+    args.cookie = 0;
+    watch_result *wres = BUSY_RETRY(clnt, mynfs_watch_1(&args, clnt));
+    int subscribed = wres && wres->status == 0;
+    if (subscribed) listing.cookie = wres->cookie;
+    if (wres) xdr_free((xdrproc_t)xdr_watch_result, (caddr_t)wres);
+
+    if (list_all(clnt, &copy[0]) != 0) {
+        // server fara mynfs_list
+        char *arg = current_dir;
+        char **res = BUSY_RETRY(clnt, ls_1(&arg, clnt));
+        if (!res) return NULL;
+        if (*res) {
+            copy[0] = strdup(*res);       // rpcgen intoarce char* intr-un char**
+        }
+        xdr_free((xdrproc_t)xdr_wrapstring, (char*)res);
+    }
+
+    // server fara watch: fara cache
+    if (subscribed && copy[0]) {
+        listing.text = strdup(copy[0]);
+        snprintf(listing.dir, sizeof(listing.dir), "%s", current_dir);
+    }
     return copy;
 }
 
@@ -86,7 +275,7 @@ int safe_create(CLIENT *clnt, const char *filename) {
         return -1;
     }
     char *arg = path;
-    int *res = create_1(&arg, clnt);
+    int *res = BUSY_RETRY(clnt, create_1(&arg, clnt));
     if (!res) {
         clnt_perror(clnt, "create_1 failed");
         return -1;
@@ -103,7 +292,7 @@ int safe_delete(CLIENT *clnt, const char *filename) {
         return -1;
     }
     char *arg = path;
-    int *res = delete_1(&arg, clnt);
+    int *res = BUSY_RETRY(clnt, delete_1(&arg, clnt));
     if (!res) {
         clnt_perror(clnt, "delete_1 failed");
         return -1;
@@ -111,7 +300,308 @@ int safe_delete(CLIENT *clnt, const char *filename) {
     return *res;
 }
 
-/* wrapper pt retrieve_1 */
+// raspuns la retrieve_file decodat direct in fisierul mapat: payload-ul ajunge
+// la dest fara buffer XDR intermediar. Ordinea campurilor e cea din struct chunk
+typedef struct {
+    chunk c;
+    char *dest;
+    u_int cap;
+} mapped_chunk;
+
+static bool_t xdr_chunk_into(XDR *xdrs, mapped_chunk *m) {
+    char name[MAX_FILENAME_LENGTH + 1];
+    char *np = name;
+    if (!xdr_string(xdrs, &np, MAX_FILENAME_LENGTH)) return FALSE;
+    // mai mult decat s-a cerut ar iesi din zona mapata
+    if (!xdr_u_int(xdrs, &m->c.data.data_len) || m->c.data.data_len > m->cap) return FALSE;
+    if (!xdr_opaque(xdrs, m->dest, m->c.data.data_len)) return FALSE;
+    m->c.data.data_val = m->dest;
+    return xdr_int(xdrs, &m->c.size) && xdr_u_int(xdrs, &m->c.dest_offset) &&
+           xdr_bool(xdrs, &m->c.eof) && xdr_u_int(xdrs, &m->c.file_size) &&
+           xdr_int(xdrs, &m->c.codec) && xdr_bool(xdrs, &m->c.has_crc) &&
+           xdr_u_int(xdrs, &m->c.crc) && xdr_u_quad_t(xdrs, &m->c.client);
+}
+
+static void chunk_done(chunk *res, const char *map) {
+    if (!map) xdr_free((xdrproc_t)xdr_chunk, (char *)res);
+}
+
+/* descarca [start, end) din fisierul remote in out, la acelasi offset; cu map,
+   direct in fisierul mapat (end <= dimensiunea maparii). Progresul merge in j,
+   iar fara name nu se afiseaza nimic. intoarce 1 daca serverul a raportat eof mai devreme */
+static int retrieve_range(CLIENT *clnt, request *req, FILE *out, char *map, nfs_journal *j,
+                          unsigned int start, unsigned int end, unsigned int *file_size,
+                          const char *name) {
+    req->src_offset = start;
+    req->dest_offset = start;
+    if (!map && fseeko(out, start, SEEK_SET) != 0) {
+        perror("retrieve_range fseeko");
+        return -1;
+    }
+
+    unsigned int step = codec != CODEC_NONE ? CHUNK_SIZE_PACKED : CHUNK_SIZE;
+    req->codec = codec;
+    req->level = codec_level;
+    req->want_crc = TRUE;
+    req->client = client_id;
+    int retries = 0, delays = 0;
+    char packed[CHUNK_SIZE_PACKED];
+    while (req->src_offset < end) {
+        unsigned int left = end - req->src_offset;
+        req->size = left < step ? left : step;   // cat citeste per apel
+
+        chunk *res;
+        mapped_chunk m;
+        if (map) {
+            memset(&m, 0, sizeof(m));
+            m.dest = codec == CODEC_NONE ? map + req->src_offset : packed;
+            m.cap = req->size;
+            enum clnt_stat stat;
+            int busy = 0;
+            while ((stat = clnt_call(clnt, retrieve_file, (xdrproc_t)xdr_request_fast,
+                                     (caddr_t)req, (xdrproc_t)xdr_chunk_into, (caddr_t)&m,
+                                     rpc_timeout)) != RPC_SUCCESS &&
+                   nfs_busy_wait(clnt, &busy))
+                ;
+            if (stat != RPC_SUCCESS) {
+                clnt_perror(clnt, "retrieve_file_1 failed");
+                return -1;
+            }
+            res = &m.c;
+        } else {
+            res = BUSY_RETRY(clnt, retrieve_file_1(req, clnt));
+            if (!res) {
+                clnt_perror(clnt, "retrieve_file_1 failed");
+                return -1;
+            }
+        }
+        if (res->size == ERR_DELAY) {
+            chunk_done(res, map);
+            if (retry_delay(ERR_DELAY, &delays)) continue;
+            fprintf(stderr, COLOR_RED "Error: %s is held by another client\n" COLOR_RESET,
+                    name ? name : req->filename);
+            return -1;
+        }
+
+        char *data = res->data.data_val;
+        unsigned int len = res->data.data_len;
+        char raw[CHUNK_SIZE_PACKED];
+        if (res->codec != CODEC_NONE) {
+            // size e dimensiunea necomprimata; cu map se decomprima direct in fisier
+            char *to = map ? map + req->src_offset : raw;
+            unsigned int room = map ? left : (unsigned int)sizeof(raw);
+            if (res->size <= 0 || (unsigned int)res->size > room ||
+                nfs_decompress(res->codec, data, len, to, res->size) != 0) {
+                fprintf(stderr, COLOR_RED "Error: corrupt compressed chunk at %u\n" COLOR_RESET,
+                        req->src_offset);
+                chunk_done(res, map);
+                return -1;
+            }
+            data = to;
+            len = res->size;
+        }
+
+        // chunk stricat pe drum: se cere din nou acelasi interval
+        if (res->has_crc && nfs_crc32c(0, data, len) != res->crc) {
+            chunk_done(res, map);
+            if (++retries > CRC_RETRIES) {
+                fprintf(stderr, COLOR_RED "Error: CRC32C mismatch at offset %u\n" COLOR_RESET,
+                        req->src_offset);
+                return -1;
+            }
+            continue;
+        }
+        retries = 0;
+
+        if (len > 0 && res->size >= 0) {
+            if (!map && fwrite(data, 1, len, out) != len) {
+                perror("retrieve_range fwrite");
+                chunk_done(res, map);
+                return -1;
+            }
+            nfs_journal_mark(j, req->src_offset, (uint64_t)req->src_offset + len);
+
+            // pregatire chunk urmator
+            req->src_offset += len;
+            req->dest_offset += len;
+        }
+        if (res->file_size > *file_size) *file_size = res->file_size;
+
+        int eof = res->eof || len == 0 || res->size < 0;
+        // eliberare cu XDR
+        chunk_done(res, map);
+
+        if (name && *file_size > 0) {
+            printf("\r%s: %u/%u bytes (%u%%)", name, req->src_offset, *file_size,
+                   (unsigned int)((unsigned long long)req->src_offset * 100 / *file_size));
+            fflush(stdout);
+        }
+        if (eof) return 1;
+    }
+    return 0;
+}
+
+// CRC32C pe [start, end) din fisierul remote
+static int remote_crc(CLIENT *clnt, char *path, uint64_t start, uint64_t end, uint32_t *crc) {
+    sum_args args;
+    memset(&args, 0, sizeof(args));
+    args.filename = path;
+    args.client = client_id;
+    args.offset = (u_int)start;
+    args.length = (u_int)(end - start);
+    args.algo = SUM_CRC32C;
+    sum_result *res = BUSY_RETRY(clnt, mynfs_checksum_1(&args, clnt));
+    if (!res || res->status != 0) return -1;
+    const unsigned char *sum = (const unsigned char *)res->sum;
+    *crc = (uint32_t)sum[0] << 24 | (uint32_t)sum[1] << 16 | (uint32_t)sum[2] << 8 | sum[3];
+    return 0;
+}
+
+/* ce spune jurnalul ca s-a transferat trebuie sa fie la fel local si pe server;
+   altfel transferul o ia de la capat */
+static void journal_verify(CLIENT *clnt, nfs_journal *j, char *path, int fd) {
+    uint64_t total = 0;
+    for (unsigned int i = 0; i < j->count; i++) {
+        uint32_t local, remote;
+        uint64_t start = j->done[i].start, end = j->done[i].end;
+        if (nfs_file_crc32c(fd, start, end - start, &local) != 0 ||
+            remote_crc(clnt, path, start, end, &remote) != 0 || local != remote) {
+            printf(COLOR_YELLOW "Previous transfer does not match anymore, starting over\n" COLOR_RESET);
+            nfs_journal_reset(j);
+            return;
+        }
+        total += end - start;
+    }
+    if (total)
+        printf(COLOR_YELLOW "Resuming: %llu bytes already transferred\n" COLOR_RESET,
+               (unsigned long long)total);
+}
+
+/* wrapper pt retrieve_1; gaurile din fisierele sparse nu se transfera */
+static int send_range(CLIENT *clnt, char *path, int fd, nfs_journal *j, off_t start, off_t end);
+
+/* transfer impartit: bucatile [start, end) stau intr-o coada comuna, iar fiecare
+   fir ia urmatoarea bucata pe propria conexiune din pool. Jurnalul si progresul
+   se actualizeaza sub lock, dupa fiecare pas de JOURNAL_FLUSH */
+typedef struct {
+    pthread_mutex_t lock;
+    journal_range *pieces;
+    u_int count, cap, next;
+    int upload;
+    char *path;            // remote
+    const char *name;      // pt progres
+    int fd;                // upload: fisierul local
+    char *map;             // download: fisierul local mapat
+    nfs_journal *j;
+    uint64_t done, total;
+    unsigned int shrunk;   // download: offset-ul eof raportat inainte de sfarsit
+    int failed;
+} stripe_job;
+
+typedef struct {
+    stripe_job *job;
+    CLIENT *clnt;
+} stripe_worker;
+
+static int stripe_add(stripe_job *job, uint64_t start, uint64_t end) {
+    for (uint64_t s = start; s < end; s += STRIPE_PIECE) {
+        if (job->count == job->cap) {
+            u_int cap = job->cap ? job->cap * 2 : 64;
+            journal_range *grown = realloc(job->pieces, cap * sizeof(*grown));
+            if (!grown) {
+                fprintf(stderr, "Memory allocation failed\n");
+                return -1;
+            }
+            job->pieces = grown;
+            job->cap = cap;
+        }
+        job->pieces[job->count].start = s;
+        job->pieces[job->count].end = end - s > STRIPE_PIECE ? s + STRIPE_PIECE : end;
+        job->count++;
+    }
+    job->total += end - start;
+    return 0;
+}
+
+static void *stripe_loop(void *arg) {
+    stripe_worker *w = arg;
+    stripe_job *job = w->job;
+    request req;
+    memset(&req, 0, sizeof(req));
+    req.filename = job->path;
+
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        if (job->failed || job->next == job->count) {
+            pthread_mutex_unlock(&job->lock);
+            break;
+        }
+        journal_range piece = job->pieces[job->next++];
+        pthread_mutex_unlock(&job->lock);
+
+        for (uint64_t s = piece.start; s < piece.end; ) {
+            uint64_t e = piece.end - s > JOURNAL_FLUSH ? s + JOURNAL_FLUSH : piece.end;
+            uint64_t got = e;
+            int r;
+            if (job->upload) {
+                r = send_range(w->clnt, job->path, job->fd, NULL, s, e);
+            } else {
+                unsigned int seen = 0;
+                r = retrieve_range(w->clnt, &req, NULL, job->map, NULL, (unsigned int)s,
+                                   (unsigned int)e, &seen, NULL);
+                if (r == 1) got = req.src_offset;
+            }
+
+            pthread_mutex_lock(&job->lock);
+            if (r < 0) {
+                job->failed = 1;
+            } else {
+                if (r == 1 && got < job->shrunk) job->shrunk = (unsigned int)got;
+                nfs_journal_mark(job->j, s, got);
+                job->done += got - s;
+                printf("\r%s: %llu/%llu bytes (%u%%)", job->name, (unsigned long long)job->done,
+                       (unsigned long long)job->total,
+                       (unsigned int)(job->done * 100 / job->total));
+                fflush(stdout);
+            }
+            int stop = job->failed;
+            pthread_mutex_unlock(&job->lock);
+            if (stop || r != 0) break;
+            s = e;
+        }
+    }
+    return NULL;
+}
+
+/* ruleaza coada pe cel mult stripes conexiuni; 0 / -1 */
+static int stripe_run(stripe_job *job) {
+    pthread_t tids[MAX_POOL];
+    stripe_worker workers[MAX_POOL];
+    int started = 0;
+    for (int i = 0; i < stripes && i < MAX_POOL && (u_int)i < job->count; i++) {
+        CLIENT *c = nfs_pool_get(i);
+        if (!c) break;
+        workers[started].job = job;
+        workers[started].clnt = c;
+        if (pthread_create(&tids[started], NULL, stripe_loop, &workers[started]) != 0) break;
+        started++;
+    }
+    // fara niciun fir, coada merge pe conexiunea din REPL
+    if (started == 0) {
+        workers[0].job = job;
+        workers[0].clnt = nfs_pool_get(0);
+        stripe_loop(&workers[0]);
+    }
+    for (int i = 0; i < started; i++) pthread_join(tids[i], NULL);
+    if (job->total > 0) printf("\n");
+    return job->failed ? -1 : 0;
+}
+
+static void stripe_free(stripe_job *job) {
+    pthread_mutex_destroy(&job->lock);
+    free(job->pieces);
+}
+
 int safe_retrieve(CLIENT *clnt, const char *remote_file, const char *local_file) {
     char path[PATH_MAX];
     int written = snprintf(path, sizeof(path), "%s/%s", current_dir, remote_file);
@@ -121,42 +611,430 @@ int safe_retrieve(CLIENT *clnt, const char *remote_file, const char *local_file)
     }
 
     request req;
+    memset(&req, 0, sizeof(req));
     req.filename = path;
-    req.size = 512;           // cat citeste per apel
+    req.size = 512;
     req.src_offset = 0;
     req.dest_offset = 0;
+    req.client = client_id;
+
+    extent_result *ext;
+    int delays = 0;
+    while ((ext = BUSY_RETRY(clnt, mynfs_extents_1(&req, clnt))) && retry_delay(ext->status, &delays))
+        xdr_free((xdrproc_t)xdr_extent_result, (char *)ext);
+    if (!ext) {
+        // doar un server vechi, fara procedura, trece pe calea fara extents
+        struct rpc_err err;
+        clnt_geterr(clnt, &err);
+        if (err.re_status != RPC_PROCUNAVAIL) {
+            clnt_perror(clnt, "mynfs_extents_1 failed");
+            return -1;
+        }
+    } else if (ext->status != 0) {
+        if (ext->status == ERR_TOO_BIG)
+            fprintf(stderr, COLOR_RED "Error: %s is 4 GiB or larger, too big to transfer\n" COLOR_RESET,
+                    remote_file);
+        else
+            fprintf(stderr, COLOR_RED "Error: cannot open remote file %s\n" COLOR_RESET, remote_file);
+        xdr_free((xdrproc_t)xdr_extent_result, (char *)ext);
+        return -1;
+    }
 
-    FILE *out = fopen(local_file, "wb");
+    // reluare: jurnalul trebuie sa fie al aceluiasi fisier remote, neschimbat
+    nfs_journal *j = NULL;
+    if (ext) {
+        char *arg = path;
+        attr_result *attr = BUSY_RETRY(clnt, mynfs_getattr_1(&arg, clnt));
+        if (attr && attr->status == 0) {
+            char ident[PATH_MAX + 64];
+            snprintf(ident, sizeof(ident), "download %s %u %lld.%09u", path, attr->file_size,
+                     (long long)attr->mtime, attr->mtime_nsec);
+            j = nfs_journal_open(local_file, ident);
+        }
+    }
+    if (j && j->count) {
+        int lfd = open(local_file, O_RDONLY);
+        if (lfd < 0) {
+            nfs_journal_reset(j);
+        } else {
+            journal_verify(clnt, j, path, lfd);
+            close(lfd);
+        }
+    }
+
+    FILE *out = fopen(local_file, j && j->count ? "r+b" : "w+b");
     if (!out) {
         perror("safe_retrieve fopen");
+        if (ext) xdr_free((xdrproc_t)xdr_extent_result, (char *)ext);
+        nfs_journal_close(j, 0);
         return -1;
     }
 
-    while (1) {
-        chunk *res = retrieve_file_1(&req, clnt);
-        if (!res) {
-            break;
+    int status = 0;
+    unsigned int file_size = 0;
+    unsigned int end = 0;
+    char *map = NULL;
+    unsigned int map_size = 0;
+    int striped = 0;
+    stripe_job job;
+    memset(&job, 0, sizeof(job));
+    pthread_mutex_init(&job.lock, NULL);
+    if (!ext) {
+        // server fara mynfs_extents, citim secvential pana la eof
+        status = retrieve_range(clnt, &req, out, NULL, NULL, 0, UINT_MAX, &file_size, remote_file) < 0 ? -1 : 0;
+        end = req.src_offset;
+    } else {
+        // dimensiunea finala dinainte; ftruncate lasa gaurile nealocate
+        file_size = ext->file_size;
+        end = file_size;
+        if (ftruncate(fileno(out), file_size) != 0) {
+            perror("safe_retrieve ftruncate");
+            status = -1;
         }
-        if (res->data.data_len == 0 || res->size < 0) {
-            xdr_free((xdrproc_t)xdr_chunk, (char *)res);
-            break;
+
+        // fisierele mari se scriu direct in memorie, fara fwrite
+        if (status == 0 && file_size >= MMAP_MIN_FILE) {
+            map = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(out), 0);
+            if (map == MAP_FAILED) {
+                map = NULL;
+            } else {
+                map_size = file_size;
+                // cu mai multe conexiuni, accesul nu mai e secvential
+                striped = stripes > 1 && file_size >= STRIPE_MIN_FILE;
+                madvise(map, map_size, striped ? MADV_NORMAL : MADV_SEQUENTIAL);
+            }
+        }
+        job.path = path;
+        job.name = remote_file;
+        job.map = map;
+        job.j = j;
+        job.shrunk = end;
+
+        while (status == 0) {
+            u_int count = ext->extents.extents_len;
+            extent *list = malloc((count ? count : 1) * sizeof(extent));
+            if (!list) {
+                fprintf(stderr, "Memory allocation failed\n");
+                status = -1;
+                break;
+            }
+            memcpy(list, ext->extents.extents_val, count * sizeof(extent));
+            bool_t more = ext->more;
+            xdr_free((xdrproc_t)xdr_extent_result, (char *)ext);
+            ext = NULL;
+
+            int r = 0;
+            for (u_int i = 0; i < count && r == 0; i++) {
+                unsigned int range_end = list[i].offset + list[i].length;
+                // fisierul a crescut pe server de la mapare: restul trece prin stdio
+                char *into = map && range_end <= map_size ? map : NULL;
+                // pe disc plin, o scriere in mapare ar da SIGBUS
+                int err = posix_fallocate(fileno(out), list[i].offset, list[i].length);
+                if (into && err == ENOSPC) {
+                    fprintf(stderr, COLOR_RED "Error: no space left for %s\n" COLOR_RESET, local_file);
+                    r = -1;
+                    break;
+                }
+                // la reluare, doar bucatile care nu sunt in jurnal
+                uint64_t pos = list[i].offset, from, to;
+                while (r == 0 && nfs_journal_missing(j, pos, range_end, &from, &to)) {
+                    if (into && striped)
+                        r = stripe_add(&job, from, to);
+                    else
+                        r = retrieve_range(clnt, &req, out, into, j, (unsigned int)from,
+                                           (unsigned int)to, &file_size, remote_file);
+                    pos = to;
+                }
+            }
+            unsigned int next = count ? list[count - 1].offset + list[count - 1].length : end;
+            free(list);
+
+            if (r < 0) status = -1;
+            if (r == 1) end = req.src_offset;   // fisierul s-a micsorat intre timp
+            if (r != 0 || !more) break;
+
+            req.src_offset = next;
+            ext = BUSY_RETRY(clnt, mynfs_extents_1(&req, clnt));
+            if (!ext || ext->status != 0) {
+                clnt_perror(clnt, "mynfs_extents_1 failed");
+                if (ext) xdr_free((xdrproc_t)xdr_extent_result, (char *)ext);
+                status = -1;
+            }
         }
+        // bucatile adunate din toate paginile de extents pleaca acum in paralel
+        if (status == 0 && job.count > 0) {
+            status = stripe_run(&job);
+            if (job.shrunk < end) end = job.shrunk;
+        }
+    }
+    if (file_size > 0 && job.count == 0) printf("\n");
+    stripe_free(&job);
+
+    if (map) munmap(map, map_size);
+    fflush(out);
+    if (status == 0 && ftruncate(fileno(out), end) != 0) {
+        perror("safe_retrieve ftruncate");
+        status = -1;
+    }
+    fclose(out);
+    if (status != 0 && j)
+        printf(COLOR_YELLOW "Run the same download again to resume\n" COLOR_RESET);
+    nfs_journal_close(j, status == 0);
+    return status;
+}
 
-        fwrite(res->data.data_val, 1, res->data.data_len, out);
+/* urmatoarea zona cu date din fd de la pos incolo; 0 daca nu mai sunt */
+static int next_data_extent(int fd, off_t pos, off_t size, off_t *start, off_t *end) {
+    if (pos >= size) return 0;
+    off_t data = lseek(fd, pos, SEEK_DATA);
+    if (data < 0) {
+        if (errno == ENXIO) return 0;   // doar gaura pana la sfarsit
+        data = pos;                     // fs fara SEEK_DATA
+    }
+    off_t hole = lseek(fd, data, SEEK_HOLE);
+    if (hole < 0 || hole > size) hole = size;
+    *start = data;
+    *end = hole;
+    return 1;
+}
 
-        // pregatire chunk urmator
-        req.src_offset += res->data.data_len;
-        req.dest_offset += res->data.data_len;
+/* wrapper pt mynfs_truncate_1 */
+static int remote_truncate(CLIENT *clnt, char *path, unsigned int size) {
+    request req;
+    memset(&req, 0, sizeof(req));
+    req.filename = path;
+    req.size = size;
+    req.client = client_id;
+    int *res, delays = 0;
+    while ((res = BUSY_RETRY(clnt, mynfs_truncate_1(&req, clnt))) && retry_delay(*res, &delays))
+        ;
+    if (!res) {
+        clnt_perror(clnt, "mynfs_truncate_1 failed");
+        return -1;
+    }
+    if (*res == ERR_LOCKED)
+        fprintf(stderr, COLOR_RED "Error: file locked by another client\n" COLOR_RESET);
+    return *res;
+}
 
-        // eliberare cu XDR
-        xdr_free((xdrproc_t)xdr_chunk, (char *)res);
+static int *send_chunk(CLIENT *clnt, chunk *ch, int *status) {
+    *status = 0;
+    int busy = 0;
+    while (clnt_call(clnt, send_file, (xdrproc_t)xdr_chunk_fast, (caddr_t)ch,
+                     (xdrproc_t)xdr_int, (caddr_t)status, rpc_timeout) != RPC_SUCCESS)
+        if (!nfs_busy_wait(clnt, &busy)) return NULL;
+    return status;
+}
+
+/* trimite [start, end) din fd la acelasi offset in fisierul remote; progresul merge in j */
+static int send_range(CLIENT *clnt, char *path, int fd, nfs_journal *j, off_t start, off_t end) {
+    chunk ch;
+    memset(&ch, 0, sizeof(ch));
+    ch.filename = path;
+
+    size_t step = codec != CODEC_NONE ? CHUNK_SIZE_PACKED : CHUNK_SIZE;
+    for (off_t pos = start; pos < end; ) {
+        char buffer[CHUNK_SIZE_PACKED];
+        char packed[CHUNK_SIZE_PACKED];
+        size_t want = end - pos < (off_t)step ? (size_t)(end - pos) : step;
+        ssize_t bytes_read = pread(fd, buffer, want, pos);
+        if (bytes_read <= 0) break;   // fisierul s-a micsorat
+
+        ch.data.data_val = buffer;
+        ch.data.data_len = bytes_read;
+        ch.size = bytes_read;
+        ch.dest_offset = pos;
+        ch.codec = CODEC_NONE;
+        ch.has_crc = TRUE;
+        ch.crc = nfs_crc32c(0, buffer, bytes_read);
+        ch.client = client_id;
+
+        // daca nu castigam nimic, chunk-ul pleaca necomprimat
+        unsigned int n = codec != CODEC_NONE
+            ? nfs_compress(codec, codec_level, buffer, bytes_read, packed, bytes_read) : 0;
+        if (n > 0) {
+            ch.data.data_val = packed;
+            ch.data.data_len = n;
+            ch.codec = codec;
+        }
+
+        // rezultat local in loc de cel static din send_file_1: send_range
+        // ruleaza si din firele unui transfer impartit
+        int status;
+        int *res = send_chunk(clnt, &ch, &status);
+        int retries = 0, delays = 0;
+        while (res && ((*res == ERR_CHECKSUM && retries++ < CRC_RETRIES) || retry_delay(*res, &delays)))
+            res = send_chunk(clnt, &ch, &status);
+        if (!res || *res != 0) {
+            if (res && *res == ERR_CHECKSUM)
+                fprintf(stderr, COLOR_RED "Error: CRC32C mismatch at offset %lld\n" COLOR_RESET, (long long)pos);
+            else if (res && *res == ERR_LOCKED)
+                fprintf(stderr, COLOR_RED "Error: range locked by another client\n" COLOR_RESET);
+            else if (res && *res == ERR_DELAY)
+                fprintf(stderr, COLOR_RED "Error: file is held by another client\n" COLOR_RESET);
+            else
+                clnt_perror(clnt, "send_file_1 failed");
+            return -1;
+        }
+        nfs_journal_mark(j, pos, pos + bytes_read);
+        pos += bytes_read;
     }
+    return 0;
+}
 
-    fclose(out);
+/* primul chunk al unui upload nou, apoi golirea continutului vechi: daca
+   serverul nu accepta datele, fisierul remote nu se trunchiaza. *done = unde
+   s-a ajuns in [start, end) */
+static int send_first(CLIENT *clnt, char *path, int fd, nfs_journal *j, off_t start, off_t end,
+                      off_t *done) {
+    size_t step = codec != CODEC_NONE ? CHUNK_SIZE_PACKED : CHUNK_SIZE;
+    off_t first = end - start < (off_t)step ? end : start + (off_t)step;
+    if (send_range(clnt, path, fd, NULL, start, first) != 0) return -1;
+    if (start > 0) {
+        // in fata e o gaura: se goleste tot, iar chunk-ul pleaca din nou
+        if (remote_truncate(clnt, path, 0) != 0 || send_range(clnt, path, fd, j, start, first) != 0)
+            return -1;
+    } else {
+        if (remote_truncate(clnt, path, first) != 0) return -1;
+        nfs_journal_mark(j, start, first);
+    }
+    *done = first;
     return 0;
 }
 
-/* wrapper pt send_file_1 */
+/* upload deduplicat: se trimit doar chunk-urile pe care serverul nu le are,
+   apoi manifestul; 1 daca serverul nu ruleaza cu depozitul deduplicat */
+static int cas_send(CLIENT *clnt, char *path, int fd, off_t size) {
+    unsigned int count = (size + CAS_CHUNK_SIZE - 1) / CAS_CHUNK_SIZE;
+    cas_hash *hashes = malloc((count ? count : 1) * sizeof(cas_hash));
+    if (!hashes) {
+        fprintf(stderr, "Out of memory\n");
+        return -1;
+    }
+
+    char buffer[CAS_CHUNK_SIZE];
+    char packed[CAS_CHUNK_SIZE];
+    for (unsigned int i = 0; i < count; i++) {
+        off_t pos = (off_t)i * CAS_CHUNK_SIZE;
+        size_t want = size - pos < CAS_CHUNK_SIZE ? (size_t)(size - pos) : CAS_CHUNK_SIZE;
+        if (pread(fd, buffer, want, pos) != (ssize_t)want) {
+            perror("cas_send pread");
+            free(hashes);
+            return -1;
+        }
+        nfs_sha256_ctx ctx;
+        nfs_sha256_init(&ctx);
+        nfs_sha256_update(&ctx, buffer, want);
+        nfs_sha256_final(&ctx, (unsigned char *)hashes[i]);
+    }
+
+    unsigned int start = 0, sent = 0;
+    unsigned long long sent_bytes = 0;
+    int status = 0;
+    do {
+        unsigned int n = count - start < MAX_CAS_HASHES ? count - start : MAX_CAS_HASHES;
+        cas_query query;
+        query.hashes.hashes_len = n;
+        query.hashes.hashes_val = hashes + start;
+        cas_have *have = BUSY_RETRY(clnt, mynfs_has_chunks_1(&query, clnt));
+        if (!have || have->status == ERR_NO_CAS) {
+            // server vechi sau fara -d: upload obisnuit
+            if (have) xdr_free((xdrproc_t)xdr_cas_have, (char *)have);
+            if (start == 0) {
+                free(hashes);
+                return 1;
+            }
+            clnt_perror(clnt, "mynfs_has_chunks_1 failed");
+            status = -1;
+            break;
+        }
+        char present[MAX_CAS_HASHES];
+        int ok = have->status == 0 && have->have.have_len == n;
+        if (ok) memcpy(present, have->have.have_val, n);
+        xdr_free((xdrproc_t)xdr_cas_have, (char *)have);
+        if (!ok) {
+            fprintf(stderr, COLOR_RED "Error: chunk query failed\n" COLOR_RESET);
+            status = -1;
+            break;
+        }
+
+        for (unsigned int j = 0; status == 0 && j < n; j++) {
+            if (present[j]) continue;
+
+            off_t pos = (off_t)(start + j) * CAS_CHUNK_SIZE;
+            size_t want = size - pos < CAS_CHUNK_SIZE ? (size_t)(size - pos) : CAS_CHUNK_SIZE;
+            if (pread(fd, buffer, want, pos) != (ssize_t)want) {
+                perror("cas_send pread");
+                status = -1;
+                break;
+            }
+
+            cas_chunk c;
+            memset(&c, 0, sizeof(c));
+            memcpy(c.hash, hashes[start + j], sizeof(cas_hash));
+            c.data.data_val = buffer;
+            c.data.data_len = want;
+            c.size = want;
+            c.codec = CODEC_NONE;
+            unsigned int packed_len = codec != CODEC_NONE
+                ? nfs_compress(codec, codec_level, buffer, want, packed, want) : 0;
+            if (packed_len > 0) {
+                c.data.data_val = packed;
+                c.data.data_len = packed_len;
+                c.codec = codec;
+            }
+
+            int *res = BUSY_RETRY(clnt, mynfs_put_chunk_1(&c, clnt));
+            if (!res || *res != 0) {
+                if (res) fprintf(stderr, COLOR_RED "Error: server rejected chunk %u\n" COLOR_RESET, start + j);
+                else clnt_perror(clnt, "mynfs_put_chunk_1 failed");
+                status = -1;
+                break;
+            }
+            sent++;
+            sent_bytes += c.data.data_len;
+
+            // acelasi continut mai apare in lot (de ex. blocuri cu zero)
+            for (unsigned int k = j + 1; k < n; k++)
+                if (memcmp(hashes[start + k], hashes[start + j], sizeof(cas_hash)) == 0)
+                    present[k] = 1;
+        }
+        if (status != 0) break;
+
+        cas_manifest manifest;
+        manifest.filename = path;
+        manifest.file_size = (unsigned int)size;
+        manifest.start = start;
+        manifest.hashes.hashes_len = n;
+        manifest.hashes.hashes_val = hashes + start;
+        manifest.last = start + n >= count;
+        manifest.client = client_id;
+        int *res, delays = 0;
+        while ((res = BUSY_RETRY(clnt, mynfs_put_manifest_1(&manifest, clnt))) &&
+               retry_delay(*res, &delays))
+            ;
+        if (!res || *res != 0) {
+            if (!res) clnt_perror(clnt, "mynfs_put_manifest_1 failed");
+            else if (*res == ERR_LOCKED)
+                fprintf(stderr, COLOR_RED "Error: file locked by another client\n" COLOR_RESET);
+            else if (*res == ERR_MISSING_CHUNK)
+                fprintf(stderr, COLOR_RED "Error: server lost chunks during upload\n" COLOR_RESET);
+            else fprintf(stderr, COLOR_RED "Error: server rejected the manifest\n" COLOR_RESET);
+            status = -1;
+            break;
+        }
+        start += n;
+    } while (start < count);
+    free(hashes);
+
+    if (status == 0)
+        printf("Dedup: %u of %u chunks already on server, sent %llu bytes\n",
+               count - sent, count, sent_bytes);
+    return status;
+}
+
+/* wrapper pt send_file_1; se trimit doar zonele cu date, gaurile le
+   recreeaza truncate-ul final pe server */
 int safe_send(CLIENT *clnt, const char *local_file, const char *remote_file) {
     char path[PATH_MAX];
     int written = snprintf(path, sizeof(path), "%s/%s", current_dir, remote_file);
@@ -165,46 +1043,408 @@ int safe_send(CLIENT *clnt, const char *local_file, const char *remote_file) {
         return -1;
     }
 
-    FILE *in = fopen(local_file, "rb");
-    if (!in) {
-        perror("safe_send fopen");
+    int fd = open(local_file, O_RDONLY);
+    if (fd < 0) {
+        perror("safe_send open");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror("safe_send fstat");
+        close(fd);
+        return -1;
+    }
+    // offset-urile din protocol sunt pe 32 de biti (ERR_TOO_BIG)
+    if ((uint64_t)st.st_size > UINT_MAX) {
+        fprintf(stderr, COLOR_RED "Error: %s is 4 GiB or larger, too big to transfer\n" COLOR_RESET,
+                local_file);
+        close(fd);
         return -1;
     }
 
-    chunk ch;
-    ch.filename = path;
-    ch.dest_offset = 0;
+    // server cu depozit deduplicat: pleaca doar chunk-urile noi
+    int cas = cas_send(clnt, path, fd, st.st_size);
+    if (cas != 1) {
+        close(fd);
+        return cas;
+    }
+
+    // reluare: acelasi fisier local, neschimbat, catre aceeasi cale
+    char ident[PATH_MAX + 64];
+    snprintf(ident, sizeof(ident), "upload %s %lld %lld.%09ld", path, (long long)st.st_size,
+             (long long)st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+    nfs_journal *j = nfs_journal_open(local_file, ident);
+    if (j && j->count) journal_verify(clnt, j, path, fd);
+
+    // continutul vechi nu trebuie sa ramana in locul gaurilor; se goleste
+    // dupa primul chunk acceptat (send_first), nu inainte
+    int fresh = !j || j->count == 0;
+
+    // fisierele mari pleaca pe mai multe conexiuni odata
+    int striped = stripes > 1 && st.st_size >= STRIPE_MIN_FILE;
+    stripe_job job;
+    memset(&job, 0, sizeof(job));
+    pthread_mutex_init(&job.lock, NULL);
+    job.upload = 1;
+    job.path = path;
+    job.name = remote_file;
+    job.fd = fd;
+    job.j = j;
 
     int res_status = 0;
+    off_t pos = 0, start, end;
+    while (res_status == 0 && next_data_extent(fd, pos, st.st_size, &start, &end)) {
+        uint64_t at = start, from, to;
+        while (res_status == 0 && nfs_journal_missing(j, at, end, &from, &to)) {
+            if (fresh) {
+                off_t done;
+                fresh = 0;
+                res_status = send_first(clnt, path, fd, j, from, to, &done);
+                if (res_status != 0 || (uint64_t)done == to) {
+                    at = to;
+                    continue;
+                }
+                from = done;
+            }
+            if (striped)
+                res_status = stripe_add(&job, from, to);
+            else
+                res_status = send_range(clnt, path, fd, j, from, to);
+            at = to;
+        }
+        pos = end;
+    }
+    if (res_status == 0 && job.count > 0) res_status = stripe_run(&job);
+    stripe_free(&job);
+    close(fd);
+
+    // fara niciun chunk (fisier gol sau doar gauri) ramane de golit acum
+    if (res_status == 0 && fresh) res_status = remote_truncate(clnt, path, 0);
+
+    if (res_status == 0)
+        res_status = remote_truncate(clnt, path, st.st_size);
+    if (res_status != 0 && j)
+        printf(COLOR_YELLOW "Run the same upload again to resume\n" COLOR_RESET);
+    nfs_journal_close(j, res_status == 0);
+    return res_status;
+}
 
+/* toate semnaturile fisierului remote; NULL daca fisierul nu exista */
+static block_sig *fetch_signatures(CLIENT *clnt, char *path, unsigned int *block_size,
+                                   unsigned int *count, unsigned int *file_size) {
+    sig_args args;
+    memset(&args, 0, sizeof(args));
+    args.filename = path;
+    args.client = client_id;
+    args.block_size = *block_size;
+    args.start_block = 0;
+
+    block_sig *sigs = NULL;
+    *count = 0;
+    int delays = 0;
     while (1) {
-        char buffer[512];
-        size_t bytes_read = fread(buffer, 1, sizeof(buffer), in);
-        if (bytes_read == 0) break;
-
-        ch.data.data_val = malloc(bytes_read);
-        if (!ch.data.data_val) {
-            fprintf(stderr, "Memory allocation failed\n");
-            res_status = -1;
-            break;
+        sig_result *res = BUSY_RETRY(clnt, mynfs_signatures_1(&args, clnt));
+        if (res && retry_delay(res->status, &delays)) {
+            xdr_free((xdrproc_t)xdr_sig_result, (char *)res);
+            continue;
+        }
+        if (!res) {
+            clnt_perror(clnt, "mynfs_signatures_1 failed");
+            free(sigs);
+            return NULL;
+        }
+        if (res->status != 0) {
+            xdr_free((xdrproc_t)xdr_sig_result, (char *)res);
+            free(sigs);
+            return NULL;
         }
-        memcpy(ch.data.data_val, buffer, bytes_read);
-        ch.data.data_len = bytes_read;
-        ch.size = bytes_read;
 
-        int *res = send_file_1(&ch, clnt);
-        free(ch.data.data_val);
-        if (!res || *res != 0) {
-            clnt_perror(clnt, "send_file_1 failed");
-            res_status = -1;
-            break;
+        u_int n = res->sigs.sigs_len;
+        block_sig *tmp = realloc(sigs, (*count + n + 1) * sizeof(block_sig));
+        if (!tmp) {
+            xdr_free((xdrproc_t)xdr_sig_result, (char *)res);
+            free(sigs);
+            return NULL;
         }
+        sigs = tmp;
+        memcpy(sigs + *count, res->sigs.sigs_val, n * sizeof(block_sig));
+        *count += n;
+        *block_size = res->block_size;
+        *file_size = res->file_size;
+        args.block_size = res->block_size;
+        args.start_block = *count;
+
+        bool_t more = res->more;
+        xdr_free((xdrproc_t)xdr_sig_result, (char *)res);
+        if (!more || n == 0) break;
+    }
+    return sigs;
+}
+
+/* sha256 remote pe tot fisierul */
+static int remote_checksum(CLIENT *clnt, char *path, unsigned char sum[NFS_SHA256_LEN]) {
+    sum_args args;
+    memset(&args, 0, sizeof(args));
+    args.filename = path;
+    args.client = client_id;
+
+    sum_result *res;
+    int delays = 0;
+    while ((res = BUSY_RETRY(clnt, mynfs_checksum_1(&args, clnt))) && retry_delay(res->status, &delays))
+        ;
+    if (!res) {
+        clnt_perror(clnt, "mynfs_checksum_1 failed");
+        return -1;
+    }
+    if (res->status != 0) return -1;
+    memcpy(sum, res->sum, NFS_SHA256_LEN);
+    return 0;
+}
+
+static const block_sig *sort_sigs;
+static int cmp_sig_weak(const void *a, const void *b) {
+    uint32_t wa = sort_sigs[*(const unsigned int *)a].weak;
+    uint32_t wb = sort_sigs[*(const unsigned int *)b].weak;
+    return wa < wb ? -1 : wa > wb;
+}
+
+/* pull: descarca doar blocurile care nu se gasesc deja in copia locala;
+   suma rostogolita gaseste si blocurile mutate la alt offset */
+int safe_pull(CLIENT *clnt, const char *remote_file, const char *local_file) {
+    char path[PATH_MAX];
+    int written = snprintf(path, sizeof(path), "%s/%s", current_dir, remote_file);
+    if (written < 0 || written >= (int)sizeof(path)) {
+        fprintf(stderr, COLOR_RED "Error: path too long (truncated)\n" COLOR_RESET);
+        return -1;
+    }
+
+    int old_fd = open(local_file, O_RDONLY);
+    if (old_fd < 0) {
+        // nimic local, descarcare completa
+        return safe_retrieve(clnt, remote_file, local_file);
+    }
+    struct stat st;
+    if (fstat(old_fd, &st) != 0) {
+        close(old_fd);
+        return safe_retrieve(clnt, remote_file, local_file);
+    }
+    size_t old_size = (size_t)st.st_size;
+    unsigned char *old = NULL;
+    if (old_size > 0) {
+        old = mmap(NULL, old_size, PROT_READ, MAP_PRIVATE, old_fd, 0);
+        if (old == MAP_FAILED) {
+            close(old_fd);
+            return safe_retrieve(clnt, remote_file, local_file);
+        }
+    }
+
+    unsigned int bs = DELTA_BLOCK_SIZE, count, file_size;
+    block_sig *sigs = fetch_signatures(clnt, path, &bs, &count, &file_size);
+    if (!sigs) {
+        fprintf(stderr, COLOR_RED "Error: cannot read signatures of %s\n" COLOR_RESET, remote_file);
+        if (old) munmap(old, old_size);
+        close(old_fd);
+        return -1;
+    }
+
+    // found[k] = offset local unde exista blocul k, -1 daca trebuie descarcat
+    off_t *found = malloc((count + 1) * sizeof(off_t));
+    unsigned int *order = malloc((count + 1) * sizeof(unsigned int));
+    if (!found || !order) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(found); free(order); free(sigs);
+        if (old) munmap(old, old_size);
+        close(old_fd);
+        return -1;
+    }
+    unsigned int nfull = file_size / bs;   // ultimul bloc poate fi partial
+    for (unsigned int k = 0; k < count; k++) {
+        found[k] = -1;
+        order[k] = k;
+    }
+    sort_sigs = sigs;
+    qsort(order, nfull, sizeof(unsigned int), cmp_sig_weak);
+
+    if (nfull > 0 && old_size >= bs) {
+        uint32_t weak = nfs_weak_sum(old, bs);
+        size_t o = 0;
+        while (1) {
+            // cautare binara dupa suma slaba, suma tare doar la potrivire
+            unsigned int lo = 0, hi = nfull;
+            while (lo < hi) {
+                unsigned int mid = (lo + hi) / 2;
+                if (sigs[order[mid]].weak < weak) lo = mid + 1; else hi = mid;
+            }
+            int matched = 0;
+            uint64_t strong = 0;
+            for (unsigned int i = lo; i < nfull && sigs[order[i]].weak == weak; i++) {
+                if (!matched && strong == 0) strong = nfs_strong_sum(old + o, bs);
+                if (sigs[order[i]].strong == strong) {
+                    if (found[order[i]] < 0) found[order[i]] = o;
+                    matched = 1;
+                }
+            }
+
+            if (matched) {
+                o += bs;
+                if (o + bs > old_size) break;
+                weak = nfs_weak_sum(old + o, bs);
+            } else {
+                if (o + bs >= old_size) break;
+                weak = nfs_weak_roll(weak, bs, old[o], old[o + bs]);
+                o++;
+            }
+        }
+    }
+    if (nfull < count) {
+        // ultimul bloc partial: acelasi offset sau coada fisierului local
+        size_t len = file_size - (size_t)nfull * bs;
+        size_t cand[2] = { (size_t)nfull * bs, old_size - len };
+        for (int c = 0; c < 2 && old_size >= len; c++) {
+            if (cand[c] + len > old_size) continue;
+            if (nfs_weak_sum(old + cand[c], len) == sigs[nfull].weak &&
+                nfs_strong_sum(old + cand[c], len) == sigs[nfull].strong) {
+                found[nfull] = cand[c];
+                break;
+            }
+        }
+    }
+
+    char tmp_path[PATH_MAX];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.mynfs-part", local_file);
+    FILE *out = fopen(tmp_path, "w+b");
+    int status = out ? 0 : -1;
+    if (!out) perror("safe_pull fopen");
+
+    request req;
+    memset(&req, 0, sizeof(req));
+    req.filename = path;
+    unsigned int reused = 0, fetched = 0, seen_size = file_size;
+    for (unsigned int k = 0; k < count && status == 0; ) {
+        unsigned int start = k * bs;
+        if (found[k] >= 0) {
+            unsigned int len = k == nfull ? file_size - start : bs;
+            if (fseeko(out, start, SEEK_SET) != 0 ||
+                fwrite(old + found[k], 1, len, out) != len) {
+                perror("safe_pull fwrite");
+                status = -1;
+            }
+            reused++;
+            k++;
+            continue;
+        }
+        // blocurile lipsa consecutive se cer intr-un singur interval
+        unsigned int run = k;
+        while (run < count && found[run] < 0) run++;
+        unsigned int end = run >= count ? file_size : run * bs;
+        if (retrieve_range(clnt, &req, out, NULL, NULL, start, end, &seen_size, remote_file) < 0)
+            status = -1;
+        fetched += run - k;
+        k = run;
+    }
+    if (fetched > 0) printf("\n");
+
+    // verificare finala pe tot fisierul
+    unsigned char want[NFS_SHA256_LEN], got[NFS_SHA256_LEN];
+    if (status == 0) {
+        fflush(out);
+        if (ftruncate(fileno(out), file_size) != 0 ||
+            remote_checksum(clnt, path, want) != 0 ||
+            nfs_file_sha256(fileno(out), 0, 0, got) != 0 ||
+            memcmp(want, got, NFS_SHA256_LEN) != 0)
+            status = 1;
+    }
+
+    if (out) fclose(out);
+    if (old) munmap(old, old_size);
+    close(old_fd);
+    free(found);
+    free(order);
+    free(sigs);
+
+    if (status == 1) {
+        fprintf(stderr, COLOR_YELLOW "! Checksum mismatch after delta, downloading whole file\n" COLOR_RESET);
+        unlink(tmp_path);
+        return safe_retrieve(clnt, remote_file, local_file);
+    }
+    if (status != 0) {
+        unlink(tmp_path);
+        return -1;
+    }
+    if (rename(tmp_path, local_file) != 0) {
+        perror("safe_pull rename");
+        unlink(tmp_path);
+        return -1;
+    }
+    printf("pull: %u/%u blocks reused, %u fetched\n", reused, count, fetched);
+    return 0;
+}
+
+/* push: trimite doar blocurile care difera fata de fisierul remote */
+int safe_push(CLIENT *clnt, const char *local_file, const char *remote_file) {
+    char path[PATH_MAX];
+    int written = snprintf(path, sizeof(path), "%s/%s", current_dir, remote_file);
+    if (written < 0 || written >= (int)sizeof(path)) {
+        fprintf(stderr, COLOR_RED "Error: path too long (truncated)\n" COLOR_RESET);
+        return -1;
+    }
 
-        ch.dest_offset += bytes_read;
+    unsigned int bs = DELTA_BLOCK_SIZE, count, remote_size;
+    block_sig *sigs = fetch_signatures(clnt, path, &bs, &count, &remote_size);
+    if (!sigs) {
+        // nu exista pe server, upload complet
+        return safe_send(clnt, local_file, remote_file);
     }
 
-    fclose(in);
-    return res_status;
+    int fd = open(local_file, O_RDONLY);
+    struct stat st;
+    unsigned char *buf = malloc(bs);
+    if (fd < 0 || fstat(fd, &st) != 0 || !buf) {
+        perror("safe_push open");
+        if (fd >= 0) close(fd);
+        free(buf);
+        free(sigs);
+        return -1;
+    }
+
+    int status = 0;
+    unsigned int sent = 0, total = 0;
+    for (off_t pos = 0; pos < st.st_size && status == 0; pos += bs) {
+        unsigned int k = pos / bs;
+        ssize_t n = pread(fd, buf, bs, pos);
+        if (n <= 0) break;
+        total++;
+
+        // blocul e la fel doar daca are aceeasi lungime si ambele sume
+        off_t remote_len = (off_t)remote_size - pos;
+        if (remote_len > bs) remote_len = bs;
+        if (k < count && remote_len == n &&
+            nfs_weak_sum(buf, n) == sigs[k].weak &&
+            nfs_strong_sum(buf, n) == sigs[k].strong)
+            continue;
+
+        status = send_range(clnt, path, fd, NULL, pos, pos + n);
+        sent++;
+    }
+    free(buf);
+    free(sigs);
+
+    if (status == 0)
+        status = remote_truncate(clnt, path, st.st_size);
+
+    unsigned char want[NFS_SHA256_LEN], got[NFS_SHA256_LEN];
+    if (status == 0 &&
+        (nfs_file_sha256(fd, 0, 0, want) != 0 ||
+         remote_checksum(clnt, path, got) != 0 ||
+         memcmp(want, got, NFS_SHA256_LEN) != 0)) {
+        close(fd);
+        fprintf(stderr, COLOR_YELLOW "! Checksum mismatch after delta, uploading whole file\n" COLOR_RESET);
+        return safe_send(clnt, local_file, remote_file);
+    }
+    close(fd);
+    if (status == 0)
+        printf("push: %u/%u blocks sent\n", sent, total);
+    return status;
 }
 
 /* wrapper pt mkdir */
@@ -221,7 +1461,7 @@ int safe_mkdir(CLIENT *clnt, const char *dirname) {
         return -1;
     }
     char *arg = path;
-    int *res = mynfs_mkdir_1(&arg, clnt);
+    int *res = BUSY_RETRY(clnt, mynfs_mkdir_1(&arg, clnt));
 
     if (!res) {
         clnt_perror(clnt, "mynfs_mkdir_1 failed");
@@ -246,7 +1486,7 @@ int safe_remdir(CLIENT *clnt, const char *dirname) {
         return -1;
     }
     char *arg = path;
-    int *res = mynfs_remdir_1(&arg, clnt);
+    int *res = BUSY_RETRY(clnt, mynfs_remdir_1(&arg, clnt));
     if (!res) {
         clnt_perror(clnt, "mynfs_remdir_1 failed");
         return -1;
@@ -257,6 +1497,253 @@ int safe_remdir(CLIENT *clnt, const char *dirname) {
 }
 
 
+/* fisiere tinute local cat timp clientul are lease pe ele: citirile se
+   servesc din memorie, scrierile sub lease de scriere pleaca la rechemare */
+typedef struct {
+    char path[PATH_MAX];
+    int lease;            // LEASE_READ / LEASE_WRITE, LEASE_NONE = slot liber
+    char *data;
+    size_t size;
+    size_t dirty_start;   // [dirty_start, dirty) inca netrimis la server
+    size_t dirty;
+    int shrunk;           // fisierul remote trebuie scurtat la size
+} cache_entry;
+
+static cache_entry cache[CACHE_ENTRIES];
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static time_t lease_valid_until;   // prelungit de fiecare renew reusit
+static int renew_running = 0;
+static int renew_stop = 0;
+static pthread_t renew_tid;
+static pthread_cond_t renew_cond = PTHREAD_COND_INITIALIZER;
+
+/* scrie inapoi [dirty_start, dirty) si scurtarea; toate functiile cache_* cer cache_lock */
+static int cache_flush(CLIENT *clnt, cache_entry *e) {
+    chunk ch;
+    memset(&ch, 0, sizeof(ch));
+    ch.filename = e->path;
+    ch.client = client_id;
+    for (size_t pos = e->dirty_start; pos < e->dirty; ) {
+        size_t len = e->dirty - pos < CHUNK_SIZE ? e->dirty - pos : CHUNK_SIZE;
+        ch.data.data_val = e->data + pos;
+        ch.data.data_len = len;
+        ch.size = len;
+        ch.dest_offset = pos;
+        ch.has_crc = TRUE;
+        ch.crc = nfs_crc32c(0, ch.data.data_val, len);
+        int *res = BUSY_RETRY(clnt, mynfs_write_1(&ch, clnt));
+        if (!res || *res != 0) {
+            fprintf(stderr, COLOR_RED "Error: cannot write back %s\n" COLOR_RESET, e->path);
+            return -1;
+        }
+        pos += len;
+    }
+    e->dirty_start = e->dirty = 0;
+    if (e->shrunk && remote_truncate(clnt, e->path, e->size) != 0) return -1;
+    e->shrunk = 0;
+    return 0;
+}
+
+static void cache_mark_dirty(cache_entry *e, size_t start, size_t end) {
+    if (e->dirty <= e->dirty_start) {
+        e->dirty_start = start;
+        e->dirty = end;
+        return;
+    }
+    if (start < e->dirty_start) e->dirty_start = start;
+    if (end > e->dirty) e->dirty = end;
+}
+
+/* scrie ce e de scris, preda lease-ul si elibereaza slotul. Daca scrierea
+   inapoi esueaza, slotul si lease-ul raman (serverul recheama din nou la
+   urmatorul renew, deci se reincearca) si intoarce -1 */
+static int cache_release(CLIENT *clnt, cache_entry *e) {
+    if (cache_flush(clnt, e) != 0) return -1;
+
+    lease_args args;
+    memset(&args, 0, sizeof(args));
+    args.client = client_id;
+    args.filename = e->path;
+    args.type = LEASE_NONE;
+    BUSY_RETRY(clnt, mynfs_lease_1(&args, clnt));
+
+    free(e->data);
+    memset(e, 0, sizeof(*e));
+    return 0;
+}
+
+/* 1 daca path are in cache scrieri care nu au ajuns inca pe server */
+static int cache_pending(const char *path) {
+    for (int i = 0; i < CACHE_ENTRIES; i++)
+        if (cache[i].lease != LEASE_NONE && strcmp(cache[i].path, path) == 0 &&
+            (cache[i].dirty > cache[i].dirty_start || cache[i].shrunk))
+            return 1;
+    return 0;
+}
+
+/* tine starea clientului in viata pe server si preda lease-urile rechemate;
+   are propriul CLIENT, cel din REPL nu se foloseste din doua fire */
+static void *renew_loop(void *arg) {
+    CLIENT *clnt = arg;
+    pthread_mutex_lock(&cache_lock);
+    while (!renew_stop) {
+        struct timespec wake;
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_sec += LEASE_SECONDS / 3;
+        while (!renew_stop && pthread_cond_timedwait(&renew_cond, &cache_lock, &wake) != ETIMEDOUT)
+            ;
+        if (renew_stop) break;
+
+        pthread_mutex_unlock(&cache_lock);
+        time_t sent = time(NULL);
+        renew_result *res = BUSY_RETRY(clnt, mynfs_renew_1(&client_id, clnt));
+        pthread_mutex_lock(&cache_lock);
+        if (!res) continue;
+
+        if (res->status == 0) lease_valid_until = sent + LEASE_SECONDS - 1;
+        for (u_int i = 0; i < res->recalled.recalled_len; i++) {
+            char *name = res->recalled.recalled_val[i];
+            int found = 0;
+            for (int k = 0; k < CACHE_ENTRIES; k++) {
+                if (cache[k].lease != LEASE_NONE && strcmp(cache[k].path, name) == 0) {
+                    if (cache_release(clnt, &cache[k]) != 0)
+                        fprintf(stderr, COLOR_RED "Kept %s in cache, retrying\n" COLOR_RESET, name);
+                    found = 1;
+                }
+            }
+            if (!found) {
+                lease_args args;
+                memset(&args, 0, sizeof(args));
+                args.client = client_id;
+                args.filename = name;
+                args.type = LEASE_NONE;
+                BUSY_RETRY(clnt, mynfs_lease_1(&args, clnt));
+            }
+        }
+        xdr_free((xdrproc_t)xdr_renew_result, (char *)res);
+    }
+    pthread_mutex_unlock(&cache_lock);
+    clnt_destroy(clnt);
+    return NULL;
+}
+
+static void start_renew(CLIENT *main_clnt) {
+    if (renew_running) return;
+
+    // aceeasi adresa ca handle-ul din REPL, fara o noua cautare prin rpcbind
+    CLIENT *clnt = nfs_pool_clone(main_clnt);
+    if (!clnt) return;
+    if (pthread_create(&renew_tid, NULL, renew_loop, clnt) == 0)
+        renew_running = 1;
+    else
+        clnt_destroy(clnt);
+}
+
+static void stop_renew(void) {
+    if (!renew_running) return;
+    pthread_mutex_lock(&cache_lock);
+    renew_stop = 1;
+    pthread_cond_signal(&renew_cond);
+    pthread_mutex_unlock(&cache_lock);
+    pthread_join(renew_tid, NULL);
+    renew_running = 0;
+}
+
+/* continutul fisierului in slot, citit necomprimat */
+static int cache_load(CLIENT *clnt, cache_entry *e, unsigned int size) {
+    e->data = malloc(size ? size : 1);
+    if (!e->data) return -1;
+
+    request req;
+    memset(&req, 0, sizeof(req));
+    req.filename = e->path;
+    req.want_crc = TRUE;
+    req.client = client_id;
+    while (req.src_offset < size) {
+        unsigned int left = size - req.src_offset;
+        req.size = left < CHUNK_SIZE ? left : CHUNK_SIZE;
+        chunk *res = BUSY_RETRY(clnt, mynfs_read_1(&req, clnt));
+        if (!res) return -1;
+
+        unsigned int len = res->data.data_len;
+        int ok = res->size >= 0 && res->codec == CODEC_NONE && len > 0 && len <= req.size &&
+                 (!res->has_crc || nfs_crc32c(0, res->data.data_val, len) == res->crc);
+        if (ok) memcpy(e->data + req.src_offset, res->data.data_val, len);
+        xdr_free((xdrproc_t)xdr_chunk, (char *)res);
+        if (!ok) return -1;
+        req.src_offset += len;
+    }
+    e->size = size;
+    return 0;
+}
+
+/* slotul cu fisierul, sub un lease cel putin de tipul cerut; NULL daca
+   serverul nu da lease-uri sau fisierul e prea mare pt cache */
+static cache_entry *cache_get(CLIENT *clnt, char *path, int type) {
+    cache_entry *slot = NULL;
+    for (int i = 0; i < CACHE_ENTRIES; i++) {
+        cache_entry *e = &cache[i];
+        if (e->lease != LEASE_NONE && strcmp(e->path, path) == 0) {
+            if (e->lease >= type && time(NULL) < lease_valid_until) return e;
+            if (cache_release(clnt, e) != 0) return NULL;   // expirat sau doar de citire
+        }
+        if (e->lease == LEASE_NONE && !slot) slot = e;
+    }
+    if (!slot) {
+        slot = &cache[0];
+        if (cache_release(clnt, slot) != 0) return NULL;
+    }
+
+    lease_args args;
+    memset(&args, 0, sizeof(args));
+    args.client = client_id;
+    args.filename = path;
+    args.type = type;
+    lease_result *res;
+    int delays = 0;
+    time_t sent = time(NULL);
+    while ((res = BUSY_RETRY(clnt, mynfs_lease_1(&args, clnt))) && res->status == ERR_DELAY &&
+           delays++ < DELAY_RETRIES) {
+        // intre timp firul de renew trebuie sa poata preda lease-urile noastre
+        pthread_mutex_unlock(&cache_lock);
+        sleep(1);
+        pthread_mutex_lock(&cache_lock);
+        sent = time(NULL);
+    }
+    if (!res || res->status != 0) return NULL;
+
+    lease_valid_until = sent + res->seconds - 1;
+    snprintf(slot->path, sizeof(slot->path), "%s", path);
+    slot->lease = type;
+    if (res->file_size > CACHE_MAX_FILE || cache_load(clnt, slot, res->file_size) != 0) {
+        cache_release(clnt, slot);   // curat, nu are ce scrie
+        return NULL;
+    }
+    start_renew(clnt);
+    return slot;
+}
+
+/* inainte de alte comenzi pe fisier: datele din cache ajung pe server si
+   lease-ul se preda; name NULL = tot cache-ul. -1 daca ceva a ramas nescris */
+static int cache_drop(CLIENT *clnt, const char *name) {
+    char path[PATH_MAX];
+    if (name) {
+        // o cale prea lunga nu poate fi in cache
+        int n = snprintf(path, sizeof(path), "%s/%s", current_dir, name);
+        if (n < 0 || (size_t)n >= sizeof(path)) return 0;
+    }
+
+    int status = 0;
+    pthread_mutex_lock(&cache_lock);
+    for (int i = 0; i < CACHE_ENTRIES; i++) {
+        if (cache[i].lease != LEASE_NONE && (!name || strcmp(cache[i].path, path) == 0) &&
+            cache_release(clnt, &cache[i]) != 0)
+            status = -1;
+    }
+    pthread_mutex_unlock(&cache_lock);
+    return status;
+}
+
 /* wrapper pt read */
 int safe_read(CLIENT *clnt, const char *filename) {
     char path[PATH_MAX];
@@ -266,18 +1753,43 @@ int safe_read(CLIENT *clnt, const char *filename) {
         return -1;
     }
 
+    // sub lease, fara niciun apel catre server
+    pthread_mutex_lock(&cache_lock);
+    cache_entry *e = cache_get(clnt, path, LEASE_READ);
+    if (e) {
+        fwrite(e->data, 1, e->size, stdout);
+        printf("\n");
+        pthread_mutex_unlock(&cache_lock);
+        return 0;
+    }
+    // fara cache, dar cu scrieri ramase: serverul are doar copia veche
+    int pending = cache_pending(path);
+    pthread_mutex_unlock(&cache_lock);
+    if (pending) {
+        fprintf(stderr, COLOR_RED "Error: cached writes to %s are not on the server yet\n" COLOR_RESET,
+                filename);
+        return -1;
+    }
+
     request req;
     memset(&req, 0, sizeof(req));
     req.filename = path;
     req.size = 1024; 
     req.src_offset = 0;
     req.dest_offset = 0;
+    req.client = client_id;
 
+    int delays = 0;
     while (1) {
-        chunk *res = mynfs_read_1(&req, clnt);
+        chunk *res = BUSY_RETRY(clnt, mynfs_read_1(&req, clnt));
         if (!res) {
             break;
         }
+        if (res->size == ERR_DELAY) {
+            xdr_free((xdrproc_t)xdr_chunk, (char *)res);
+            if (retry_delay(ERR_DELAY, &delays)) continue;
+            break;
+        }
         if (res->data.data_len <= 0) {
             xdr_free((xdrproc_t)xdr_chunk, (char *)res);
             break;
@@ -290,10 +1802,11 @@ int safe_read(CLIENT *clnt, const char *filename) {
         req.src_offset += res->data.data_len;
         req.dest_offset += res->data.data_len;
 
+        bool_t eof = res->eof;
         xdr_free((xdrproc_t)xdr_chunk, (char *)res);
 
-        // eof
-        if (res->data.data_len < req.size) {
+        // serverul anunta eof, nu mai e nevoie de inca un apel
+        if (eof) {
             break;
         }
     }
@@ -301,7 +1814,67 @@ int safe_read(CLIENT *clnt, const char *filename) {
     return 0;
 }
 
-/* wrapper pt edit (nano-like) */
+/* aplica un bloc modificat din edit: in cache daca lease-ul de scriere mai e
+   valabil, altfel direct pe server; 0 / -1 */
+static int edit_apply(CLIENT *clnt, char *path, int cached, const char *data, size_t len,
+                      size_t pos) {
+    pthread_mutex_lock(&cache_lock);
+    cache_entry *e = cached ? cache_get(clnt, path, LEASE_WRITE) : NULL;
+    if (e) {
+        if (pos + len > e->size) {
+            char *tmp = realloc(e->data, pos + len);
+            if (!tmp) {
+                pthread_mutex_unlock(&cache_lock);
+                fprintf(stderr, "\nMemory allocation failed\n");
+                return -1;
+            }
+            e->data = tmp;
+            e->size = pos + len;
+        }
+        memcpy(e->data + pos, data, len);
+        cache_mark_dirty(e, pos, pos + len);
+        pthread_mutex_unlock(&cache_lock);
+        return 0;
+    }
+    pthread_mutex_unlock(&cache_lock);
+
+    chunk ch;
+    memset(&ch, 0, sizeof(ch));
+    ch.filename = path;
+    ch.data.data_val = (char *)data;
+    ch.data.data_len = len;
+    ch.size = len;
+    ch.dest_offset = pos;
+    ch.has_crc = TRUE;
+    ch.crc = nfs_crc32c(0, data, len);
+    ch.client = client_id;
+    int *res, delays = 0;
+    while ((res = BUSY_RETRY(clnt, mynfs_write_1(&ch, clnt))) && retry_delay(*res, &delays))
+        ;
+    return res && *res == 0 ? 0 : -1;
+}
+
+/* scurteaza fisierul editat la size, in cache sau pe server */
+static int edit_truncate(CLIENT *clnt, char *path, int cached, size_t size) {
+    pthread_mutex_lock(&cache_lock);
+    cache_entry *e = cached ? cache_get(clnt, path, LEASE_WRITE) : NULL;
+    if (e) {
+        if (size < e->size) {
+            e->size = size;
+            e->shrunk = 1;
+            if (e->dirty > size) e->dirty = size;
+            if (e->dirty_start > e->dirty) e->dirty_start = e->dirty;
+        }
+        pthread_mutex_unlock(&cache_lock);
+        return 0;
+    }
+    pthread_mutex_unlock(&cache_lock);
+    return remote_truncate(clnt, path, size);
+}
+
+/* wrapper pt edit (nano-like): continutul vechi se pastreaza intr-un fisier
+   temporar, textul nou se citeste pe blocuri si pleaca doar blocurile care
+   difera; la sfarsit fisierul se scurteaza daca textul nou e mai scurt */
 int safe_edit(CLIENT *clnt, const char *filename) {
     char path[PATH_MAX];
     int written = snprintf(path, sizeof(path), "%s/%s", current_dir, filename);
@@ -310,70 +1883,443 @@ int safe_edit(CLIENT *clnt, const char *filename) {
         return -1;
     }
 
+    FILE *old = tmpfile();
+    if (!old) {
+        perror("safe_edit tmpfile");
+        return -1;
+    }
+
     // afiseaza continutul curent al fisierului
     printf(COLOR_YELLOW "--- Current content of %s ---\n" COLOR_RESET, filename);
+
+    // cu lease de scriere continutul vine din cache si scrierea ramane locala
+    pthread_mutex_lock(&cache_lock);
+    cache_entry *e = cache_get(clnt, path, LEASE_WRITE);
+    int cached = e != NULL;
+    size_t old_size = 0;
+    if (e) {
+        fwrite(e->data, 1, e->size, stdout);
+        fwrite(e->data, 1, e->size, old);
+        old_size = e->size;
+    }
+    int pending = !e && cache_pending(path);
+    pthread_mutex_unlock(&cache_lock);
+    if (pending) {
+        fprintf(stderr, COLOR_RED "Error: cached writes to %s are not on the server yet\n" COLOR_RESET,
+                filename);
+        fclose(old);
+        return -1;
+    }
+
     request req;
     memset(&req, 0, sizeof(req));
     req.filename = path;
-    req.size = 512;
+    req.size = CHUNK_SIZE;
     req.src_offset = 0;
     req.dest_offset = 0;
+    req.client = client_id;
 
-    while (1) {
-        chunk *res = mynfs_read_1(&req, clnt);
+    // copia veche trebuie sa fie completa: pe ea se bazeaza diff-ul si trunchierea
+    int delays = 0;
+    u_int remote_size = 0;
+    while (!cached) {
+        chunk *res = BUSY_RETRY(clnt, mynfs_read_1(&req, clnt));
         if (!res) {
-            break;
+            clnt_perror(clnt, "mynfs_read_1 failed");
+            fclose(old);
+            return -1;
+        }
+        if (res->size == ERR_DELAY) {
+            xdr_free((xdrproc_t)xdr_chunk, (char *)res);
+            if (retry_delay(ERR_DELAY, &delays)) continue;
+            fprintf(stderr, COLOR_RED "\nError: %s is held by another client, not edited\n" COLOR_RESET,
+                    filename);
+            fclose(old);
+            return -1;
         }
+        remote_size = res->file_size;
         if (res->data.data_len <= 0) {
             xdr_free((xdrproc_t)xdr_chunk, (char *)res);
             break;
         }
         fwrite(res->data.data_val, 1, res->data.data_len, stdout);
+        fwrite(res->data.data_val, 1, res->data.data_len, old);
         req.src_offset += res->data.data_len;
+        bool_t eof = res->eof;
         xdr_free((xdrproc_t)xdr_chunk, (char *)res);
+        if (eof) {
+            break;
+        }
     }
+    // fisierul poate fi mai lung decat ce s-a citit; trunchierea se decide dupa server
+    if (!cached) old_size = req.src_offset > remote_size ? req.src_offset : remote_size;
+    fflush(old);
     printf("\n" COLOR_YELLOW "--- Enter new content (end with CTRL+D) ---\n" COLOR_RESET);
 
-    char buffer[4096];
-    size_t total = 0;
-    int c;
-    while ((c = getchar()) != EOF) {
-        if (total < sizeof(buffer)) {
-            buffer[total++] = (char)c;
-        } else {
-            printf("Buffer full, truncating input.\n");
-
-            while ((c = getchar()) != EOF) { }
-            break;
+    // fiecare bloc nou se compara cu cel vechi de la acelasi offset
+    char block[CHUNK_SIZE], prev[CHUNK_SIZE];
+    size_t total = 0, sent = 0;
+    int status = 0;
+    size_t n;
+    while ((n = fread(block, 1, sizeof(block), stdin)) > 0) {
+        ssize_t had = total < old_size ? pread(fileno(old), prev, n, total) : 0;
+        if (status == 0 && (had != (ssize_t)n || memcmp(block, prev, n) != 0)) {
+            if (edit_apply(clnt, path, cached, block, n, total) == 0) {
+                sent += n;
+            } else {
+                fprintf(stderr, "\nFailed to write file %s at offset %zu\n", filename, total);
+                status = -1;   // restul intrarii se consuma, dar nu se mai trimite
+            }
         }
+        total += n;
     }
     clearerr(stdin);
+    fclose(old);
 
     if (total == 0) {
         printf("\nNo new content provided.\n");
         return -1;
     }
+    if (status != 0) return -1;
 
-    chunk ch;
-    memset(&ch, 0, sizeof(ch));
-    ch.filename = path;
-    ch.data.data_val = malloc(total);
-    if (!ch.data.data_val) {
-        fprintf(stderr, "\nMemory allocation failed\n");
+    // textul nou e mai scurt: coada veche nu trebuie sa ramana
+    if (total < old_size && edit_truncate(clnt, path, cached, total) != 0) {
+        fprintf(stderr, "\nFailed to truncate file %s\n", filename);
+        return -1;
+    }
+    if (cached)
+        printf(COLOR_GREEN "\nFile %s written (cached until the lease is recalled).\n" COLOR_RESET, filename);
+    else
+        printf(COLOR_GREEN "\nFile %s written successfully (%zu of %zu bytes sent).\n" COLOR_RESET,
+               filename, sent, total);
+    return 0;
+}
+
+/* wrapper pt bulk_read: fisierele din current_dir care se potrivesc cu glob */
+int safe_fetch(CLIENT *clnt, const char *pattern, const char *local_dir) {
+    bulk_args args;
+    memset(&args, 0, sizeof(args));
+    args.dirname = current_dir;
+    args.pattern = (char *)pattern;
+    args.cookie = 0;
+    args.max_bytes = MAX_XFER_SIZE;
+
+    int fetched = 0, failed = 0;
+    while (1) {
+        bulk_result *res = BUSY_RETRY(clnt, mynfs_bulk_read_1(&args, clnt));
+        if (!res) {
+            clnt_perror(clnt, "mynfs_bulk_read_1 failed");
+            return -1;
+        }
+
+        for (u_int i = 0; i < res->entries.entries_len; i++) {
+            bulk_entry *e = &res->entries.entries_val[i];
+            char local[PATH_MAX];
+            int written = snprintf(local, sizeof(local), "%s/%s", local_dir, e->filename);
+            if (written < 0 || written >= (int)sizeof(local)) {
+                fprintf(stderr, COLOR_RED "Error: path too long (truncated)\n" COLOR_RESET);
+                failed++;
+                continue;
+            }
+
+            if (e->status == BULK_TOO_BIG || e->status == ERR_DELAY) {
+                // prea mare pt un singur raspuns sau rechemat de la alt client:
+                // se descarca normal, safe_retrieve asteapta lease-ul
+                if (safe_retrieve(clnt, e->filename, local) == 0) fetched++;
+                else failed++;
+                continue;
+            }
+            if (e->status != BULK_OK) {
+                fprintf(stderr, COLOR_RED "✗ %s: read failed on server\n" COLOR_RESET, e->filename);
+                failed++;
+                continue;
+            }
+
+            FILE *out = fopen(local, "wb");
+            if (!out) {
+                perror("safe_fetch fopen");
+                failed++;
+                continue;
+            }
+            fwrite(e->data.data_val, 1, e->data.data_len, out);
+            fclose(out);
+            fetched++;
+        }
+
+        args.cookie = res->cookie;
+        bool_t more = res->more;
+        xdr_free((xdrproc_t)xdr_bulk_result, (char *)res);
+        if (!more) break;
+    }
+
+    printf("Fetched %d file(s)", fetched);
+    if (failed) printf(", %d failed", failed);
+    printf("\n");
+    return failed ? -1 : 0;
+}
+
+/* negociaza compresia: doar codec-urile stiute de ambele parti */
+int safe_compress(CLIENT *clnt, const char *name, const char *level) {
+    int wanted;
+    if (strcmp(name, "none") == 0) wanted = CODEC_NONE;
+    else if (strcmp(name, "lz4") == 0) wanted = CODEC_LZ4;
+    else if (strcmp(name, "zstd") == 0) wanted = CODEC_ZSTD;
+    else {
+        fprintf(stderr, "safe_compress: unknown codec %s (none, lz4, zstd)\n", name);
+        return -1;
+    }
+
+    if (wanted != CODEC_NONE) {
+        int *res = BUSY_RETRY(clnt, mynfs_codecs_1(NULL, clnt));
+        if (!res) {
+            clnt_perror(clnt, "mynfs_codecs_1 failed");
+            return -1;
+        }
+        int common = *res & nfs_codecs_supported();
+        if (!(common & (1 << wanted))) {
+            fprintf(stderr, "safe_compress: %s is not supported by both client and server\n", name);
+            return -1;
+        }
+    }
+    codec = wanted;
+    codec_level = level ? atoi(level) : 0;
+    return 0;
+}
+
+/* cate conexiuni folosesc transferurile mari; fara argument, afiseaza valoarea */
+int safe_stripes(const char *count) {
+    if (count) {
+        int n = atoi(count);
+        if (n < 1 || n > MAX_POOL) {
+            fprintf(stderr, "safe_stripes: count must be between 1 and %d\n", MAX_POOL);
+            return -1;
+        }
+        // conexiunile se deschid acum, ca o adresa moarta sa se vada imediat
+        for (int i = 0; i < n; i++) {
+            if (!nfs_pool_get(i)) {
+                fprintf(stderr, "safe_stripes: only %d connections available\n", i);
+                n = i;
+                break;
+            }
+        }
+        stripes = n;
+    }
+    printf("Large transfers use %d connection%s\n", stripes, stripes == 1 ? "" : "s");
+    return 0;
+}
+
+/* CRC32C pe tot fisierul remote, comparat optional cu unul local */
+int safe_checksum(CLIENT *clnt, const char *remote_file, const char *local_file) {
+    char path[PATH_MAX];
+    int written = snprintf(path, sizeof(path), "%s/%s", current_dir, remote_file);
+    if (written < 0 || written >= (int)sizeof(path)) {
+        fprintf(stderr, COLOR_RED "Error: path too long (truncated)\n" COLOR_RESET);
+        return -1;
+    }
+
+    sum_args args;
+    memset(&args, 0, sizeof(args));
+    args.filename = path;
+    args.client = client_id;
+    args.algo = SUM_CRC32C;
+    sum_result *res;
+    int delays = 0;
+    while ((res = BUSY_RETRY(clnt, mynfs_checksum_1(&args, clnt))) && retry_delay(res->status, &delays))
+        ;
+    if (!res) {
+        clnt_perror(clnt, "mynfs_checksum_1 failed");
+        return -1;
+    }
+    if (res->status != 0) {
+        fprintf(stderr, COLOR_RED "Error: cannot read remote file %s\n" COLOR_RESET, remote_file);
+        return -1;
+    }
+    const unsigned char *sum = (const unsigned char *)res->sum;
+    uint32_t remote_crc = (uint32_t)sum[0] << 24 | (uint32_t)sum[1] << 16 |
+                          (uint32_t)sum[2] << 8 | sum[3];
+    printf("%s: %u bytes, crc32c %08x\n", remote_file, res->file_size, remote_crc);
+    if (!local_file) return 0;
+
+    int fd = open(local_file, O_RDONLY);
+    uint32_t local_crc;
+    if (fd < 0 || nfs_file_crc32c(fd, 0, 0, &local_crc) != 0) {
+        perror("safe_checksum open");
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    close(fd);
+    printf("%s: crc32c %08x\n", local_file, local_crc);
+    return local_crc == remote_crc ? 0 : 1;
+}
+
+/* lock/rlock/unlock pe [o, o+n) din fisierul remote, range "o:n";
+   fara range, tot fisierul. mode: 0 = deblocare, 1 = partajat, 2 = exclusiv */
+int safe_lock(CLIENT *clnt, const char *remote_file, const char *range, int mode) {
+    char path[PATH_MAX];
+    int written = snprintf(path, sizeof(path), "%s/%s", current_dir, remote_file);
+    if (written < 0 || written >= (int)sizeof(path)) {
+        fprintf(stderr, COLOR_RED "Error: path too long (truncated)\n" COLOR_RESET);
+        return -1;
+    }
+
+    lock_args args;
+    memset(&args, 0, sizeof(args));
+    args.client = client_id;
+    args.filename = path;
+    args.exclusive = mode == 2;
+    if (range && sscanf(range, "%u:%u", &args.offset, &args.length) != 2) {
+        fprintf(stderr, COLOR_RED "Error: range must be offset:length\n" COLOR_RESET);
+        return -1;
+    }
+
+    int *res = mode ? BUSY_RETRY(clnt, mynfs_lock_1(&args, clnt))
+                    : BUSY_RETRY(clnt, mynfs_unlock_1(&args, clnt));
+    if (!res) {
+        clnt_perror(clnt, mode ? "mynfs_lock_1 failed" : "mynfs_unlock_1 failed");
+        return -1;
+    }
+    if (*res == ERR_LOCKED) {
+        fprintf(stderr, COLOR_RED "Error: range locked by another client\n" COLOR_RESET);
+        return -1;
+    }
+    // blocarea traieste doar cat clientul isi reinnoieste starea
+    if (*res == 0 && mode) start_renew(clnt);
+    return *res;
+}
+
+// "10k" -> 10240
+static u_quad_t parse_size(const char *s) {
+    char *end;
+    u_quad_t n = strtoull(s, &end, 10);
+    switch (*end) {
+        case 'k': case 'K': return n << 10;
+        case 'm': case 'M': return n << 20;
+        case 'g': case 'G': return n << 30;
+        default: return n;
+    }
+}
+
+/* cautare recursiva din directorul curent; opts separate prin virgula:
+   f / d = doar fisiere / directoare, re = pattern e regex, >N / <N = cel putin /
+   cel mult N bytes,
+   new=S / old=S = modificat in ultimele S secunde / mai demult */
+int safe_find(CLIENT *clnt, const char *pattern, const char *opts) {
+    find_args args;
+    memset(&args, 0, sizeof(args));
+    args.dirname = current_dir;
+    args.pattern = strcmp(pattern, "*") == 0 ? "" : (char *)pattern;
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", opts ? opts : "");
+    time_t now = time(NULL);
+    for (char *opt = strtok(buf, ","); opt; opt = strtok(NULL, ",")) {
+        if (strcmp(opt, "f") == 0) args.type = FIND_FILE;
+        else if (strcmp(opt, "d") == 0) args.type = FIND_DIR;
+        else if (strcmp(opt, "re") == 0) args.regex = TRUE;
+        else if (opt[0] == '>') args.min_size = parse_size(opt + 1);
+        else if (opt[0] == '<') args.max_size = parse_size(opt + 1);
+        else if (strncmp(opt, "new=", 4) == 0) args.newer_than = now - atol(opt + 4);
+        else if (strncmp(opt, "old=", 4) == 0) args.older_than = now - atol(opt + 4);
+        else {
+            fprintf(stderr, COLOR_RED "Error: unknown find option %s\n" COLOR_RESET, opt);
+            return -1;
+        }
+    }
+
+    u_int shown = 0;
+    int more = 1;
+    while (more) {
+        find_result *res = BUSY_RETRY(clnt, mynfs_find_1(&args, clnt));
+        if (!res) {
+            clnt_perror(clnt, "mynfs_find_1 failed");
+            return -1;
+        }
+        if (res->status != 0) {
+            fprintf(stderr, COLOR_RED "Error: cannot search %s\n" COLOR_RESET, current_dir);
+            xdr_free((xdrproc_t)xdr_find_result, (caddr_t)res);
+            return -1;
+        }
+        for (u_int i = 0; i < res->entries.entries_len; i++) {
+            find_entry *e = &res->entries.entries_val[i];
+            if (e->type == FIND_DIR)
+                printf(COLOR_BLUE "  %10s  %s/\n" COLOR_RESET, "-", e->path);
+            else
+                printf("  %10llu  %s\n", (unsigned long long)e->size, e->path);
+        }
+        shown += res->entries.entries_len;
+        args.cookie = res->cookie;
+        more = res->more && res->entries.entries_len > 0;
+        xdr_free((xdrproc_t)xdr_find_result, (caddr_t)res);
+    }
+    printf("%u match%s\n", shown, shown == 1 ? "" : "es");
+    return 0;
+}
+
+/* spatiul ocupat de dirname (sau directorul curent), recursiv */
+int safe_du(CLIENT *clnt, const char *dirname) {
+    char path[PATH_MAX];
+    int written = dirname ? snprintf(path, sizeof(path), "%s/%s", current_dir, dirname)
+                          : snprintf(path, sizeof(path), "%s", current_dir);
+    if (written < 0 || written >= (int)sizeof(path)) {
+        fprintf(stderr, COLOR_RED "Error: path too long (truncated)\n" COLOR_RESET);
         return -1;
     }
-    memcpy(ch.data.data_val, buffer, total);
-    ch.data.data_len = total;
-    ch.size = total;
-    ch.dest_offset = 0;
 
-    int *res = mynfs_write_1(&ch, clnt);
-    free(ch.data.data_val);
-    if (!res || *res != 0) {
-        fprintf(stderr, "\nFailed to write file %s\n", filename);
+    char *arg = path;
+    du_result *res = BUSY_RETRY(clnt, mynfs_du_1(&arg, clnt));
+    if (!res) {
+        clnt_perror(clnt, "mynfs_du_1 failed");
+        return -1;
+    }
+    if (res->status != 0) {
+        fprintf(stderr, COLOR_RED "Error: cannot measure %s\n" COLOR_RESET, path);
         return -1;
     }
-    printf(COLOR_GREEN "\nFile %s written successfully.\n" COLOR_RESET, filename);
+    printf("%s: %llu bytes, %llu KB on disk, %u files, %u directories%s\n", path,
+           (unsigned long long)res->bytes, (unsigned long long)(res->blocks / 2),
+           res->files, res->dirs, res->cached ? " (cached)" : "");
+    return 0;
+}
+
+/* afiseaza schimbarile din directorul curent, timp de seconds secunde */
+int safe_watch(CLIENT *clnt, const char *seconds) {
+    static const char *names[] = {
+        "?", "created", "deleted", "modified", "renamed from", "renamed to"
+    };
+    int total = seconds ? atoi(seconds) : WATCH_SECONDS;
+    if (total <= 0) total = WATCH_SECONDS;
+
+    watch_args args;
+    args.dirname = current_dir;
+    args.cookie = 0;
+    printf("Watching %s for %d s\n", current_dir, total);
+    for (int elapsed = 0; elapsed < total; ) {
+        watch_result *res = BUSY_RETRY(clnt, mynfs_watch_1(&args, clnt));
+        if (!res) {
+            clnt_perror(clnt, "mynfs_watch_1 failed");
+            return -1;
+        }
+        if (res->status != 0) {
+            fprintf(stderr, COLOR_RED "Error: cannot watch %s\n" COLOR_RESET, current_dir);
+            xdr_free((xdrproc_t)xdr_watch_result, (caddr_t)res);
+            return -1;
+        }
+        if (res->overflow)
+            printf(COLOR_YELLOW "  (some changes were lost, list again)\n" COLOR_RESET);
+        for (u_int i = 0; i < res->events.events_len; i++) {
+            watch_event *ev = &res->events.events_val[i];
+            int type = ev->type >= EV_CREATE && ev->type <= EV_RENAME_TO ? ev->type : 0;
+            printf("  %-12s %s\n", names[type], ev->name);
+        }
+        fflush(stdout);
+        args.cookie = res->cookie;
+        int more = res->more;
+        xdr_free((xdrproc_t)xdr_watch_result, (caddr_t)res);
+        if (!more) {
+            sleep(1);
+            elapsed++;
+        }
+    }
     return 0;
 }
 
@@ -417,12 +2363,23 @@ int safe_chdir(CLIENT *clnt, const char *dirname) {
         }
     }
 
-    // validare pe server
-    char *arg = candidate;
-    char **res = ls_1(&arg, clnt);
-    if (!res) return -1;  
+    // validare pe server; prima pagina ajunge, ls intreg nu incape in datagram la directoare mari
+    list_args largs;
+    largs.dirname = candidate;
+    largs.cookie = 0;
+    largs.sorted = FALSE;
+    list_result *lres = BUSY_RETRY(clnt, mynfs_list_1(&largs, clnt));
+    if (lres) {
+        int status = lres->status;
+        xdr_free((xdrproc_t)xdr_list_result, (caddr_t)lres);
+        if (status != 0) return -1;
+    } else {
+        char *arg = candidate;
+        char **res = BUSY_RETRY(clnt, ls_1(&arg, clnt));
+        if (!res) return -1;  
 
-    xdr_free((xdrproc_t)xdr_wrapstring, (char*)res);
+        xdr_free((xdrproc_t)xdr_wrapstring, (char*)res);
+    }
 
     strncpy(current_dir, candidate, sizeof(current_dir)-1);
     current_dir[sizeof(current_dir)-1] = '\0';
@@ -438,12 +2395,24 @@ int safe_chdir(CLIENT *clnt, const char *dirname) {
 
 // interactive client for NFS
 int main(int argc, char *argv[]) {
-    const char *server = (argc > 1) ? argv[1] : SERVER_IP;
-    CLIENT *clnt = clnt_create((char *)server, NFS_PROGRAM, NFS_VERSION_1, "udp");
+    // mai multe adrese ale aceluiasi server, separate prin virgula; REPL-ul
+    // foloseste prima, transferurile mari se impart intre toate
+    const char *servers = (argc > 1) ? argv[1] : SERVER_IP;
+    char server[256];
+    snprintf(server, sizeof(server), "%.*s", (int)strcspn(servers, ","), servers);
+    CLIENT *clnt = clnt_create(server, NFS_PROGRAM, NFS_VERSION_1, "udp");
     if (clnt == NULL) {
         clnt_pcreateerror(server);
         return 1;
     }
+    nfs_pool_init(servers, clnt);
+
+    // id nou la fiecare pornire; blocarile vechi expira odata cu el
+    int rfd = open("/dev/urandom", O_RDONLY);
+    if (rfd < 0 || read(rfd, &client_id, sizeof(client_id)) != sizeof(client_id))
+        client_id = ((u_quad_t)getpid() << 32) ^ (u_quad_t)time(NULL);
+    if (rfd >= 0) close(rfd);
+    if (client_id == 0) client_id = 1;
 
     printf("Connected to server %s\n", server);
     printf("\n" COLOR_VIOLET "+======================================+\n");
@@ -466,6 +2435,28 @@ int main(int argc, char *argv[]) {
         int n = sscanf(input, "%31s %127s %127s", cmd, arg1, arg2);
         if (n < 1) continue;
 
+        // comenzile care ating fisierul pe server nu trebuie sa ocoleasca cache-ul;
+        // daca scrierile din cache nu ajung pe server, comanda nu se executa
+        int unflushed = 0;
+        if (strcmp(cmd, "upload") == 0 || strcmp(cmd, "push") == 0)
+            unflushed = cache_drop(clnt, n >= 3 ? arg2 : NULL);
+        else if (strcmp(cmd, "download") == 0 || strcmp(cmd, "pull") == 0 ||
+                 strcmp(cmd, "checksum") == 0 || strcmp(cmd, "make") == 0 ||
+                 strcmp(cmd, "remove") == 0)
+            unflushed = cache_drop(clnt, n >= 2 ? arg1 : NULL);
+        else if (strcmp(cmd, "fetch") == 0 || strcmp(cmd, "remdr") == 0 ||
+                 strcmp(cmd, "bye") == 0)
+            unflushed = cache_drop(clnt, NULL);
+        if (unflushed) {
+            if (strcmp(cmd, "bye") == 0)
+                fprintf(stderr, COLOR_RED "Error: some cached writes were lost\n" COLOR_RESET);
+            else {
+                fprintf(stderr, COLOR_RED "Error: %s skipped, cached writes are not on the server yet\n"
+                        COLOR_RESET, cmd);
+                continue;
+            }
+        }
+
         if (strcmp(cmd, "list") == 0) {
             char **ls_res = safe_ls(clnt);
             if (ls_res == NULL) {
@@ -522,6 +2513,18 @@ int main(int argc, char *argv[]) {
             } else {
                 fprintf(stderr, COLOR_RED "✗ Error uploading file\n" COLOR_RESET);
             }
+        } else if (strcmp(cmd, "pull") == 0 && n >= 3) {
+            if (safe_pull(clnt, arg1, arg2) == 0) {
+                printf(COLOR_GREEN "✓ File synced to %s\n" COLOR_RESET, arg2);
+            } else {
+                fprintf(stderr, COLOR_RED "✗ Error syncing file\n" COLOR_RESET);
+            }
+        } else if (strcmp(cmd, "push") == 0 && n >= 3) {
+            if (safe_push(clnt, arg1, arg2) == 0) {
+                printf(COLOR_GREEN "✓ File synced to %s\n" COLOR_RESET, arg2);
+            } else {
+                fprintf(stderr, COLOR_RED "✗ Error syncing file\n" COLOR_RESET);
+            }
         } else if (strcmp(cmd, "makedr") == 0 && n >= 2) {
             int status = safe_mkdir(clnt, arg1);
             if (status == 0) {
@@ -561,6 +2564,50 @@ int main(int argc, char *argv[]) {
                 fprintf(stderr, COLOR_RED "✗ Failed to change directory to %s\n" COLOR_RESET, arg1);
             }
         }
+        else if (strcmp(cmd, "fetch") == 0 && n >= 3) {
+            if (safe_fetch(clnt, arg1, arg2) == 0) {
+                printf(COLOR_GREEN "✓ Files fetched into %s\n" COLOR_RESET, arg2);
+            } else {
+                fprintf(stderr, COLOR_RED "✗ Error fetching files\n" COLOR_RESET);
+            }
+        }
+        else if (strcmp(cmd, "compress") == 0 && n >= 2) {
+            if (safe_compress(clnt, arg1, n >= 3 ? arg2 : NULL) == 0) {
+                printf(COLOR_GREEN "✓ Transfer compression set to %s\n" COLOR_RESET, arg1);
+            } else {
+                fprintf(stderr, COLOR_RED "✗ Cannot use compression %s\n" COLOR_RESET, arg1);
+            }
+        }
+        else if (strcmp(cmd, "checksum") == 0 && n >= 2) {
+            int status = safe_checksum(clnt, arg1, n >= 3 ? arg2 : NULL);
+            if (status == 0 && n >= 3) {
+                printf(COLOR_GREEN "✓ Files match\n" COLOR_RESET);
+            } else if (status == 1) {
+                fprintf(stderr, COLOR_RED "✗ Files differ\n" COLOR_RESET);
+            }
+        }
+        else if ((strcmp(cmd, "lock") == 0 || strcmp(cmd, "rlock") == 0) && n >= 2) {
+            if (safe_lock(clnt, arg1, n >= 3 ? arg2 : NULL, cmd[0] == 'r' ? 1 : 2) == 0) {
+                printf(COLOR_GREEN "✓ Locked %s\n" COLOR_RESET, arg1);
+            }
+        }
+        else if (strcmp(cmd, "unlock") == 0 && n >= 2) {
+            if (safe_lock(clnt, arg1, n >= 3 ? arg2 : NULL, 0) == 0) {
+                printf(COLOR_GREEN "✓ Unlocked %s\n" COLOR_RESET, arg1);
+            }
+        }
+        else if (strcmp(cmd, "find") == 0 && n >= 2) {
+            safe_find(clnt, arg1, n >= 3 ? arg2 : NULL);
+        }
+        else if (strcmp(cmd, "du") == 0) {
+            safe_du(clnt, n >= 2 ? arg1 : NULL);
+        }
+        else if (strcmp(cmd, "watch") == 0) {
+            safe_watch(clnt, n >= 2 ? arg1 : NULL);
+        }
+        else if (strcmp(cmd, "stripes") == 0) {
+            safe_stripes(n >= 2 ? arg1 : NULL);
+        }
         else if (strcmp(cmd, "wherepd") == 0) {
             printf("Current directory: %s\n", current_dir);
         }
@@ -571,6 +2618,7 @@ int main(int argc, char *argv[]) {
             print_help();
         }
         else if (strcmp(cmd, "bye") == 0) {
+            stop_renew();
             printf("Gotta go, bye!\n");
             break;
         } else {
@@ -579,6 +2627,7 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    nfs_pool_destroy();
     clnt_destroy(clnt);
     return 0;
 }
\ No newline at end of file
@@ -12,16 +12,16 @@ static struct timeval TIMEOUT = { 25, 0 };
 char **
 ls_1(char **argp, CLIENT *clnt)
 {
-    static char *clnt_res[MAX_FILES + 1]; // +1 for NULL terminator
+	static char *clnt_res;
 
-    memset(clnt_res, 0, sizeof(clnt_res));
-    if (clnt_call(clnt, ls,
-        (xdrproc_t) xdr_wrapstring, (caddr_t) argp,
-        (xdrproc_t) xdr_wrapstring, (caddr_t) clnt_res,
-        TIMEOUT) != RPC_SUCCESS) {
-        return NULL;
-    }
-    return clnt_res;
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, ls,
+		(xdrproc_t) xdr_wrapstring, (caddr_t) argp,
+		(xdrproc_t) xdr_wrapstring, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
 }
 
 int *
@@ -100,12 +100,12 @@ mynfs_mkdir_1(char **argp, CLIENT *clnt)
 }
 
 int *
-mynfs_open_1(char **argp, CLIENT *clnt)
+mynfs_remdir_1(char **argp, CLIENT *clnt)
 {
 	static int clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
-	if (clnt_call (clnt, mynfs_open,
+	if (clnt_call (clnt, mynfs_remdir,
 		(xdrproc_t) xdr_wrapstring, (caddr_t) argp,
 		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
 		TIMEOUT) != RPC_SUCCESS) {
@@ -114,14 +114,29 @@ mynfs_open_1(char **argp, CLIENT *clnt)
 	return (&clnt_res);
 }
 
+chunk *
+mynfs_read_1(request *argp, CLIENT *clnt)
+{
+	static chunk clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_read,
+		(xdrproc_t) xdr_request, (caddr_t) argp,
+		(xdrproc_t) xdr_chunk, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
 int *
-mynfs_close_1(char **argp, CLIENT *clnt)
+mynfs_write_1(chunk *argp, CLIENT *clnt)
 {
 	static int clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
-	if (clnt_call (clnt, mynfs_close,
-		(xdrproc_t) xdr_wrapstring, (caddr_t) argp,
+	if (clnt_call (clnt, mynfs_write,
+		(xdrproc_t) xdr_chunk, (caddr_t) argp,
 		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
 		TIMEOUT) != RPC_SUCCESS) {
 		return (NULL);
@@ -129,15 +144,45 @@ mynfs_close_1(char **argp, CLIENT *clnt)
 	return (&clnt_res);
 }
 
-chunk *
-mynfs_read_1(request *argp, CLIENT *clnt)
+readdir_result *
+mynfs_readdir_1(readdir_args *argp, CLIENT *clnt)
 {
-	static chunk clnt_res;
+	static readdir_result clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
-	if (clnt_call (clnt, mynfs_read,
+	if (clnt_call (clnt, mynfs_readdir,
+		(xdrproc_t) xdr_readdir_args, (caddr_t) argp,
+		(xdrproc_t) xdr_readdir_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+bulk_result *
+mynfs_bulk_read_1(bulk_args *argp, CLIENT *clnt)
+{
+	static bulk_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_bulk_read,
+		(xdrproc_t) xdr_bulk_args, (caddr_t) argp,
+		(xdrproc_t) xdr_bulk_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+extent_result *
+mynfs_extents_1(request *argp, CLIENT *clnt)
+{
+	static extent_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_extents,
 		(xdrproc_t) xdr_request, (caddr_t) argp,
-		(xdrproc_t) xdr_chunk, (caddr_t) &clnt_res,
+		(xdrproc_t) xdr_extent_result, (caddr_t) &clnt_res,
 		TIMEOUT) != RPC_SUCCESS) {
 		return (NULL);
 	}
@@ -145,13 +190,13 @@ mynfs_read_1(request *argp, CLIENT *clnt)
 }
 
 int *
-mynfs_write_1(chunk *argp, CLIENT *clnt)
+mynfs_truncate_1(request *argp, CLIENT *clnt)
 {
 	static int clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
-	if (clnt_call (clnt, mynfs_write,
-		(xdrproc_t) xdr_chunk, (caddr_t) argp,
+	if (clnt_call (clnt, mynfs_truncate,
+		(xdrproc_t) xdr_request, (caddr_t) argp,
 		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
 		TIMEOUT) != RPC_SUCCESS) {
 		return (NULL);
@@ -159,14 +204,44 @@ mynfs_write_1(chunk *argp, CLIENT *clnt)
 	return (&clnt_res);
 }
 
+sig_result *
+mynfs_signatures_1(sig_args *argp, CLIENT *clnt)
+{
+	static sig_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_signatures,
+		(xdrproc_t) xdr_sig_args, (caddr_t) argp,
+		(xdrproc_t) xdr_sig_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+sum_result *
+mynfs_checksum_1(sum_args *argp, CLIENT *clnt)
+{
+	static sum_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_checksum,
+		(xdrproc_t) xdr_sum_args, (caddr_t) argp,
+		(xdrproc_t) xdr_sum_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
 int *
-mynfs_opendir_1(opendir_args *argp, CLIENT *clnt)
+mynfs_codecs_1(void *argp, CLIENT *clnt)
 {
 	static int clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
-	if (clnt_call (clnt, mynfs_opendir,
-		(xdrproc_t) xdr_opendir_args, (caddr_t) argp,
+	if (clnt_call (clnt, mynfs_codecs,
+		(xdrproc_t) xdr_void, (caddr_t) argp,
 		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
 		TIMEOUT) != RPC_SUCCESS) {
 		return (NULL);
@@ -174,15 +249,180 @@ mynfs_opendir_1(opendir_args *argp, CLIENT *clnt)
 	return (&clnt_res);
 }
 
-readdir_result *
-mynfs_readdir_1(readdir_args *argp, CLIENT *clnt)
+cas_have *
+mynfs_has_chunks_1(cas_query *argp, CLIENT *clnt)
 {
-	static readdir_result clnt_res;
+	static cas_have clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
-	if (clnt_call (clnt, mynfs_readdir,
-		(xdrproc_t) xdr_readdir_args, (caddr_t) argp,
-		(xdrproc_t) xdr_readdir_result, (caddr_t) &clnt_res,
+	if (clnt_call (clnt, mynfs_has_chunks,
+		(xdrproc_t) xdr_cas_query, (caddr_t) argp,
+		(xdrproc_t) xdr_cas_have, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+mynfs_put_chunk_1(cas_chunk *argp, CLIENT *clnt)
+{
+	static int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_put_chunk,
+		(xdrproc_t) xdr_cas_chunk, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+mynfs_put_manifest_1(cas_manifest *argp, CLIENT *clnt)
+{
+	static int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_put_manifest,
+		(xdrproc_t) xdr_cas_manifest, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+mynfs_lock_1(lock_args *argp, CLIENT *clnt)
+{
+	static int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_lock,
+		(xdrproc_t) xdr_lock_args, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+mynfs_unlock_1(lock_args *argp, CLIENT *clnt)
+{
+	static int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_unlock,
+		(xdrproc_t) xdr_lock_args, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+lease_result *
+mynfs_lease_1(lease_args *argp, CLIENT *clnt)
+{
+	static lease_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_lease,
+		(xdrproc_t) xdr_lease_args, (caddr_t) argp,
+		(xdrproc_t) xdr_lease_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+renew_result *
+mynfs_renew_1(u_quad_t *argp, CLIENT *clnt)
+{
+	static renew_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_renew,
+		(xdrproc_t) xdr_u_quad_t, (caddr_t) argp,
+		(xdrproc_t) xdr_renew_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+watch_result *
+mynfs_watch_1(watch_args *argp, CLIENT *clnt)
+{
+	static watch_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_watch,
+		(xdrproc_t) xdr_watch_args, (caddr_t) argp,
+		(xdrproc_t) xdr_watch_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+list_result *
+mynfs_list_1(list_args *argp, CLIENT *clnt)
+{
+	static list_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_list,
+		(xdrproc_t) xdr_list_args, (caddr_t) argp,
+		(xdrproc_t) xdr_list_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+find_result *
+mynfs_find_1(find_args *argp, CLIENT *clnt)
+{
+	static find_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_find,
+		(xdrproc_t) xdr_find_args, (caddr_t) argp,
+		(xdrproc_t) xdr_find_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+du_result *
+mynfs_du_1(char **argp, CLIENT *clnt)
+{
+	static du_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_du,
+		(xdrproc_t) xdr_wrapstring, (caddr_t) argp,
+		(xdrproc_t) xdr_du_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+attr_result *
+mynfs_getattr_1(char **argp, CLIENT *clnt)
+{
+	static attr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, mynfs_getattr,
+		(xdrproc_t) xdr_wrapstring, (caddr_t) argp,
+		(xdrproc_t) xdr_attr_result, (caddr_t) &clnt_res,
 		TIMEOUT) != RPC_SUCCESS) {
 		return (NULL);
 	}
@@ -0,0 +1,74 @@
+#include <stddef.h>
+#include "nfs.h"
+#include "nfs_compress.h"
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+int nfs_codecs_supported(void) {
+    int mask = 1 << CODEC_NONE;
+#ifdef HAVE_LZ4
+    mask |= 1 << CODEC_LZ4;
+#endif
+#ifdef HAVE_ZSTD
+    mask |= 1 << CODEC_ZSTD;
+#endif
+    return mask;
+}
+
+unsigned int nfs_compress(int codec, int level, const char *src, unsigned int len,
+                          char *dst, unsigned int cap) {
+    unsigned int out = 0;
+
+    if (len == 0) return 0;
+    switch (codec) {
+#ifdef HAVE_LZ4
+    case CODEC_LZ4: {
+        // nivel > 1 = LZ4HC, altfel varianta rapida
+        int n = level > 1 ? LZ4_compress_HC(src, dst, (int)len, (int)cap, level)
+                          : LZ4_compress_default(src, dst, (int)len, (int)cap);
+        out = n > 0 ? (unsigned int)n : 0;
+        break;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    case CODEC_ZSTD: {
+        size_t n = ZSTD_compress(dst, cap, src, len, level > 0 ? level : 1);
+        out = ZSTD_isError(n) ? 0 : (unsigned int)n;
+        break;
+    }
+#endif
+    default:
+        return 0;
+    }
+
+    // date incompresibile: se trimit asa cum sunt
+    return out < len ? out : 0;
+}
+
+int nfs_decompress(int codec, const char *src, unsigned int len,
+                   char *dst, unsigned int raw_len) {
+    switch (codec) {
+    case CODEC_NONE:
+        return len == raw_len ? 0 : -1;
+#ifdef HAVE_LZ4
+    case CODEC_LZ4: {
+        int n = LZ4_decompress_safe(src, dst, (int)len, (int)raw_len);
+        return n == (int)raw_len ? 0 : -1;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    case CODEC_ZSTD: {
+        size_t n = ZSTD_decompress(dst, raw_len, src, len);
+        return !ZSTD_isError(n) && n == raw_len ? 0 : -1;
+    }
+#endif
+    default:
+        return -1;
+    }
+}
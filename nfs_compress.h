@@ -0,0 +1,19 @@
+#ifndef NFS_COMPRESS_H
+#define NFS_COMPRESS_H
+
+// compresie optionala pe chunk; codec-urile sunt constantele CODEC_* din nfs.x
+
+// bitmask cu codec-urile compilate in acest binar (1 << CODEC_*)
+int nfs_codecs_supported(void);
+
+// intoarce lungimea comprimata sau 0 daca nu merita / codec necunoscut;
+// in cazul 0 datele se trimit necomprimate. Un cap < len opreste devreme
+// compresia care nu castiga nimic
+unsigned int nfs_compress(int codec, int level, const char *src, unsigned int len,
+                          char *dst, unsigned int cap);
+
+// decomprima exact raw_len bytes in dst; -1 la eroare
+int nfs_decompress(int codec, const char *src, unsigned int len,
+                   char *dst, unsigned int raw_len);
+
+#endif
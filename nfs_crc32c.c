@@ -0,0 +1,223 @@
+#include <string.h>
+#include <unistd.h>
+#include "nfs_crc32c.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define HAVE_HW_CRC 1
+#endif
+
+#define POLY 0x82f63b78   // polinomul Castagnoli, reflectat
+
+static uint32_t crc32c_table[8][256];
+static uint32_t (*crc32c_impl)(uint32_t, const void *, size_t);
+
+// varianta software: slice-by-8
+static uint32_t crc32c_sw(uint32_t crc, const void *buf, size_t len) {
+    const unsigned char *next = buf;
+    uint64_t crc0 = crc ^ 0xffffffff;
+
+    while (len && ((uintptr_t)next & 7) != 0) {
+        crc0 = crc32c_table[0][(crc0 ^ *next++) & 0xff] ^ (crc0 >> 8);
+        len--;
+    }
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, next, 8);
+        crc0 ^= word;
+        crc0 = crc32c_table[7][crc0 & 0xff] ^
+               crc32c_table[6][(crc0 >> 8) & 0xff] ^
+               crc32c_table[5][(crc0 >> 16) & 0xff] ^
+               crc32c_table[4][(crc0 >> 24) & 0xff] ^
+               crc32c_table[3][(crc0 >> 32) & 0xff] ^
+               crc32c_table[2][(crc0 >> 40) & 0xff] ^
+               crc32c_table[1][(crc0 >> 48) & 0xff] ^
+               crc32c_table[0][crc0 >> 56];
+        next += 8;
+        len -= 8;
+    }
+    while (len) {
+        crc0 = crc32c_table[0][(crc0 ^ *next++) & 0xff] ^ (crc0 >> 8);
+        len--;
+    }
+    return (uint32_t)crc0 ^ 0xffffffff;
+}
+
+#ifdef HAVE_HW_CRC
+
+// trei fluxuri crc32 in paralel ascund latenta instructiunii; rezultatele
+// se combina aplicand operatorul "len bytes de zero" peste crc-ul anterior
+#define LONG_BLOCK 8192
+#define SHORT_BLOCK 256
+
+static uint32_t crc32c_long[4][256];
+static uint32_t crc32c_short[4][256];
+
+static uint32_t gf2_matrix_times(const uint32_t *mat, uint32_t vec) {
+    uint32_t sum = 0;
+    while (vec) {
+        if (vec & 1) sum ^= *mat;
+        vec >>= 1;
+        mat++;
+    }
+    return sum;
+}
+
+static void gf2_matrix_square(uint32_t *square, const uint32_t *mat) {
+    for (int n = 0; n < 32; n++)
+        square[n] = gf2_matrix_times(mat, mat[n]);
+}
+
+// operatorul pt len bytes de zero (len putere a lui 2)
+static void crc32c_zeros_op(uint32_t *even, size_t len) {
+    uint32_t odd[32];
+    uint32_t row = 1;
+
+    odd[0] = POLY;   // un bit de zero
+    for (int n = 1; n < 32; n++) {
+        odd[n] = row;
+        row <<= 1;
+    }
+    gf2_matrix_square(even, odd);   // 2 biti
+    gf2_matrix_square(odd, even);   // 4 biti
+
+    do {
+        gf2_matrix_square(even, odd);
+        len >>= 1;
+        if (len == 0) return;
+        gf2_matrix_square(odd, even);
+        len >>= 1;
+    } while (len);
+    memcpy(even, odd, sizeof(odd));
+}
+
+static void crc32c_zeros(uint32_t zeros[][256], size_t len) {
+    uint32_t op[32];
+    crc32c_zeros_op(op, len);
+    for (uint32_t n = 0; n < 256; n++) {
+        zeros[0][n] = gf2_matrix_times(op, n);
+        zeros[1][n] = gf2_matrix_times(op, n << 8);
+        zeros[2][n] = gf2_matrix_times(op, n << 16);
+        zeros[3][n] = gf2_matrix_times(op, n << 24);
+    }
+}
+
+static uint32_t crc32c_shift(uint32_t zeros[][256], uint32_t crc) {
+    return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^
+           zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+}
+
+static inline uint64_t load64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hw(uint32_t crc, const void *buf, size_t len) {
+    const unsigned char *next = buf;
+    const unsigned char *end;
+    uint64_t crc0 = crc ^ 0xffffffff, crc1, crc2;
+
+    while (len && ((uintptr_t)next & 7) != 0) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0, *next++);
+        len--;
+    }
+
+    while (len >= LONG_BLOCK * 3) {
+        crc1 = 0;
+        crc2 = 0;
+        end = next + LONG_BLOCK;
+        do {
+            crc0 = _mm_crc32_u64(crc0, load64(next));
+            crc1 = _mm_crc32_u64(crc1, load64(next + LONG_BLOCK));
+            crc2 = _mm_crc32_u64(crc2, load64(next + 2 * LONG_BLOCK));
+            next += 8;
+        } while (next < end);
+        crc0 = crc32c_shift(crc32c_long, (uint32_t)crc0) ^ crc1;
+        crc0 = crc32c_shift(crc32c_long, (uint32_t)crc0) ^ crc2;
+        next += 2 * LONG_BLOCK;
+        len -= 3 * LONG_BLOCK;
+    }
+
+    while (len >= SHORT_BLOCK * 3) {
+        crc1 = 0;
+        crc2 = 0;
+        end = next + SHORT_BLOCK;
+        do {
+            crc0 = _mm_crc32_u64(crc0, load64(next));
+            crc1 = _mm_crc32_u64(crc1, load64(next + SHORT_BLOCK));
+            crc2 = _mm_crc32_u64(crc2, load64(next + 2 * SHORT_BLOCK));
+            next += 8;
+        } while (next < end);
+        crc0 = crc32c_shift(crc32c_short, (uint32_t)crc0) ^ crc1;
+        crc0 = crc32c_shift(crc32c_short, (uint32_t)crc0) ^ crc2;
+        next += 2 * SHORT_BLOCK;
+        len -= 3 * SHORT_BLOCK;
+    }
+
+    end = next + (len - (len & 7));
+    while (next < end) {
+        crc0 = _mm_crc32_u64(crc0, load64(next));
+        next += 8;
+    }
+    len &= 7;
+    while (len) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0, *next++);
+        len--;
+    }
+    return (uint32_t)crc0 ^ 0xffffffff;
+}
+
+#endif
+
+// tabelele si alegerea implementarii, o singura data la pornire
+__attribute__((constructor))
+static void crc32c_init(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t crc = n;
+        for (int k = 0; k < 8; k++)
+            crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
+        crc32c_table[0][n] = crc;
+    }
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t crc = crc32c_table[0][n];
+        for (int k = 1; k < 8; k++) {
+            crc = crc32c_table[0][crc & 0xff] ^ (crc >> 8);
+            crc32c_table[k][n] = crc;
+        }
+    }
+    crc32c_impl = crc32c_sw;
+
+#ifdef HAVE_HW_CRC
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc32c_zeros(crc32c_long, LONG_BLOCK);
+        crc32c_zeros(crc32c_short, SHORT_BLOCK);
+        crc32c_impl = crc32c_hw;
+    }
+#endif
+}
+
+uint32_t nfs_crc32c(uint32_t crc, const void *buf, size_t len) {
+    return crc32c_impl(crc, buf, len);
+}
+
+int nfs_file_crc32c(int fd, off_t offset, off_t length, uint32_t *crc) {
+    unsigned char buf[64 * 1024];
+    uint32_t sum = 0;
+
+    off_t pos = offset;
+    while (length == 0 || pos < offset + length) {
+        size_t want = sizeof(buf);
+        if (length != 0 && offset + length - pos < (off_t)want)
+            want = (size_t)(offset + length - pos);
+        ssize_t n = pread(fd, buf, want, pos);
+        if (n < 0) return -1;
+        if (n == 0) break;
+        sum = nfs_crc32c(sum, buf, (size_t)n);
+        pos += n;
+    }
+    *crc = sum;
+    return 0;
+}
@@ -0,0 +1,15 @@
+#ifndef NFS_CRC32C_H
+#define NFS_CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// CRC32C (Castagnoli); pe x86-64 cu SSE4.2 se foloseste instructiunea crc32,
+// altfel tabele slice-by-8. crc porneste de la 0 si se poate continua
+uint32_t nfs_crc32c(uint32_t crc, const void *buf, size_t len);
+
+// crc pe [offset, offset + length) dintr-un fd; length 0 = pana la sfarsit
+int nfs_file_crc32c(int fd, off_t offset, off_t length, uint32_t *crc);
+
+#endif
@@ -0,0 +1,241 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "nfs_du.h"
+#include "nfs_export.h"
+#include "nfs_shm.h"
+#include "nfs_store.h"
+#include "nfs_walk.h"
+
+typedef struct {
+    u_quad_t bytes, blocks;
+    u_int files, dirs;
+} du_totals;
+
+typedef struct du_entry {
+    char key[PATH_MAX];
+    du_totals totals;
+    struct du_entry *next;      // cel mai recent primul
+} du_entry;
+
+static du_entry *cache = NULL;
+
+// directoare de recalculat, dintr-un instantaneu
+typedef struct du_pending {
+    char key[PATH_MAX];
+    struct du_pending *next;
+} du_pending;
+
+static du_pending *pending = NULL;
+
+// cu mai multi worker-i fiecare are cache-ul lui; o scriere intr-unul creste
+// generatia comuna, iar ceilalti isi golesc tot cache-ul la urmatorul du
+static unsigned long *generation = NULL;
+static unsigned long seen = 0;
+
+typedef struct {
+    const char *root;           // cheia directorului parcurs
+    du_totals sum;
+} du_ctx;
+
+// cheia unui director: calea normalizata, absoluta daca dir e absolut, ca
+// sa se poata recalcula din ea
+static void du_key(const char *dir, char *key, size_t len) {
+    int abs = dir[0] == '/' && len > 1;
+    if (abs) key[0] = '/';
+    nfs_path_normalize(dir, key + abs, len - abs);
+}
+
+static void drop_all(void) {
+    while (cache) {
+        du_entry *dead = cache;
+        cache = dead->next;
+        free(dead);
+    }
+}
+
+// cache-ul ramane valabil doar daca niciun alt worker nu a scris intre timp
+static void sync_generation(void) {
+    if (!generation) return;
+    nfs_shm_lock();
+    unsigned long now = *generation;
+    nfs_shm_unlock();
+    if (now != seen) {
+        drop_all();
+        seen = now;
+    }
+}
+
+static du_entry *lookup(const char *key) {
+    for (du_entry *e = cache; e; e = e->next)
+        if (strcmp(e->key, key) == 0) return e;
+    return NULL;
+}
+
+static void remember(const char *key, const du_totals *t) {
+    du_entry *e = calloc(1, sizeof(*e));
+    if (!e) return;
+    snprintf(e->key, sizeof(e->key), "%s", key);
+    e->totals = *t;
+    e->next = cache;
+    cache = e;
+
+    // fiecare export pastreaza doar cele mai recente intrari, cat ii permite bugetul
+    const nfs_export *exp = nfs_export_find(key);
+    int budget = exp ? exp->cache : DU_CACHE_ENTRIES;
+    int n = 0;
+    for (du_entry **p = &cache; *p; ) {
+        if (nfs_export_find((*p)->key) == exp && ++n > budget) {
+            du_entry *dead = *p;
+            *p = dead->next;
+            free(dead);
+        } else {
+            p = &(*p)->next;
+        }
+    }
+}
+
+static int du_visit(const char *rel, const struct stat *st, void *arg) {
+    du_ctx *c = arg;
+    if (!S_ISDIR(st->st_mode)) {
+        c->sum.files++;
+        c->sum.bytes += (u_quad_t)st->st_size;
+        c->sum.blocks += (u_quad_t)st->st_blocks;
+        return 0;
+    }
+
+    // subdirector calculat deja: i se adauga totalurile fara sa se coboare
+    char key[PATH_MAX];
+    snprintf(key, sizeof(key), "%s/%s", c->root, rel);
+    du_entry *e = lookup(key);
+    c->sum.dirs++;
+    if (!e) {
+        c->sum.blocks += (u_quad_t)st->st_blocks;
+        return 0;
+    }
+    c->sum.bytes += e->totals.bytes;
+    c->sum.blocks += e->totals.blocks;
+    c->sum.files += e->totals.files;
+    c->sum.dirs += e->totals.dirs;
+    return 1;
+}
+
+int nfs_du(const char *dir, du_result *res) {
+    char key[PATH_MAX];
+    du_key(dir, key, sizeof(key));
+
+    sync_generation();
+    du_entry *e = lookup(key);
+    if (e) {
+        res->bytes = e->totals.bytes;
+        res->blocks = e->totals.blocks;
+        res->files = e->totals.files;
+        res->dirs = e->totals.dirs;
+        res->cached = TRUE;
+        return 0;
+    }
+
+    struct stat st;
+    if (nfs_store_stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) return -1;
+    du_ctx c;
+    memset(&c, 0, sizeof(c));
+    c.root = key;
+    c.sum.blocks = (u_quad_t)st.st_blocks;
+    if (nfs_walk(dir, du_visit, &c) != 0) return -1;
+
+    remember(key, &c.sum);
+    res->bytes = c.sum.bytes;
+    res->blocks = c.sum.blocks;
+    res->files = c.sum.files;
+    res->dirs = c.sum.dirs;
+    res->cached = FALSE;
+    return 0;
+}
+
+// 1 daca a e b sau un director de deasupra lui b
+static int covers(const char *a, const char *b) {
+    size_t n = strlen(a);
+    return strncmp(a, b, n) == 0 && (b[n] == '\0' || b[n] == '/');
+}
+
+void nfs_du_invalidate(const char *path) {
+    if (generation) {
+        sync_generation();
+        nfs_shm_lock();
+        seen = ++*generation;
+        nfs_shm_unlock();
+    }
+    if (!cache) return;
+    char key[PATH_MAX];
+    du_key(path, key, sizeof(key));
+    for (du_entry **p = &cache; *p; ) {
+        if (covers((*p)->key, key) || covers(key, (*p)->key)) {
+            du_entry *dead = *p;
+            *p = dead->next;
+            free(dead);
+        } else {
+            p = &(*p)->next;
+        }
+    }
+}
+
+void nfs_du_save(FILE *f) {
+    // remember pune fiecare intrare in fata, deci se scriu de la coada
+    size_t n = 0;
+    for (du_entry *e = cache; e; e = e->next) n++;
+    du_entry **order = malloc((n ? n : 1) * sizeof(*order));
+    if (!order) return;
+    n = 0;
+    for (du_entry *e = cache; e; e = e->next) order[n++] = e;
+    while (n--) {
+        du_entry *e = order[n];
+        if (strpbrk(e->key, "\t\n")) continue;
+        fprintf(f, "du %llu %llu %u %u\t%s\n", (unsigned long long)e->totals.bytes,
+                (unsigned long long)e->totals.blocks, e->totals.files, e->totals.dirs, e->key);
+    }
+    free(order);
+}
+
+int nfs_du_restore(const char *line, int trust) {
+    unsigned long long bytes, blocks;
+    du_totals t;
+    int key_at = 0;
+    if (sscanf(line, "du %llu %llu %u %u\t%n", &bytes, &blocks, &t.files, &t.dirs, &key_at) != 4 ||
+        !key_at)
+        return -1;
+    char key[PATH_MAX];
+    snprintf(key, sizeof(key), "%.*s", (int)strcspn(line + key_at, "\n"), line + key_at);
+
+    if (trust) {
+        t.bytes = bytes;
+        t.blocks = blocks;
+        remember(key, &t);
+        return 0;
+    }
+    du_pending *p = calloc(1, sizeof(*p));
+    if (!p) return 0;
+    snprintf(p->key, sizeof(p->key), "%s", key);
+    // in ordinea din instantaneu, ca cele mai recente sa ramana ultimele in cache
+    du_pending **tail = &pending;
+    while (*tail) tail = &(*tail)->next;
+    *tail = p;
+    return 0;
+}
+
+int nfs_du_warm(void) {
+    if (!pending) return 0;
+    du_pending *p = pending;
+    pending = p->next;
+    du_result res;
+    nfs_du(p->key, &res);   // un director disparut intre timp nu conteaza
+    free(p);
+    return pending != NULL;
+}
+
+int nfs_du_share(void) {
+    if (!nfs_shm_enabled()) return 0;
+    generation = nfs_shm_alloc(sizeof(*generation));
+    return generation ? 0 : -1;
+}
@@ -0,0 +1,34 @@
+#ifndef NFS_DU_H
+#define NFS_DU_H
+
+#include <stdio.h>
+#include "nfs.h"
+
+// spatiul ocupat de un subarbore, calculat cu nfs_walk; totalurile fiecarui
+// director cerut raman in cache pana cand o scriere atinge ceva sub el, iar
+// parcurgerile urmatoare nu mai coboara in subdirectoarele din cache
+
+#define DU_CACHE_ENTRIES 64     // bugetul implicit al unui export
+
+int nfs_du(const char *dir, du_result *res);
+
+// path (fisier sau director) s-a schimbat: pica directoarele de deasupra lui
+// si, daca e un director sters, tot ce era sub el
+void nfs_du_invalidate(const char *path);
+
+// cu memorie comuna (nfs_shm_init): o scriere intr-un worker goleste cache-ul
+// celorlalti la urmatorul lor du; inainte de fork
+int nfs_du_share(void);
+
+// cache-ul ca text, un director pe rand, cele mai vechi primele
+void nfs_du_save(FILE *f);
+
+// un rand scris de nfs_du_save; -1 daca nu e al lui. Cu trust totalurile se
+// iau ca atare (predare intre procese), altfel directorul doar se noteaza
+// si se recalculeaza mai tarziu cu nfs_du_warm
+int nfs_du_restore(const char *line, int trust);
+
+// recalculeaza unul din directoarele notate; 0 cand nu mai e niciunul
+int nfs_du_warm(void);
+
+#endif
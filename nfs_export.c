@@ -0,0 +1,194 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "nfs_du.h"
+#include "nfs_export.h"
+#include "nfs_mem.h"
+#include "nfs_walk.h"
+#include "nfs_watch.h"
+
+static nfs_export exports[MAX_EXPORTS];
+static int export_count = 0;
+static int disk_only = 0;      // nfs_export_disk_only
+
+static const nfs_export *by_name(const nfs_export *table, int count, const char *name, size_t len) {
+    for (int i = 0; i < count; i++)
+        if (strlen(table[i].name) == len && strncmp(table[i].name, name, len) == 0)
+            return &table[i];
+    return NULL;
+}
+
+static int is_mem(const nfs_export *table, int count, const char *key) {
+    for (int i = 0; i < count; i++)
+        if (table[i].engine == &nfs_store_mem && strcmp(table[i].key, key) == 0) return 1;
+    return 0;
+}
+
+// tabela noua intra in vigoare: exporturile din memorie care dispar se sterg
+static int install(const nfs_export *table, int count) {
+    for (int i = 0; i < count; i++) {
+        if (table[i].engine == &nfs_store_mem && nfs_mem_init(table[i].root, nfs_watch_note) != 0) {
+            fprintf(stderr, "Error: cannot keep export %s in memory: %s\n", table[i].name, strerror(errno));
+            return -1;
+        }
+    }
+    for (int i = 0; i < export_count; i++) {
+        if (exports[i].engine == &nfs_store_mem && !is_mem(table, count, exports[i].key))
+            nfs_mem_drop(exports[i].root);
+        // bugetele de cache pot fi altele
+        nfs_du_invalidate(exports[i].root);
+    }
+    memcpy(exports, table, count * sizeof(*table));
+    export_count = count;
+
+    for (int i = 0; i < export_count; i++)
+        printf("Export %s: %s (%s, %s, du cache %d)\n", exports[i].name, exports[i].root,
+               exports[i].read_only ? "read-only" : "read-write", exports[i].engine->name,
+               exports[i].cache);
+    return 0;
+}
+
+static void set_root(nfs_export *e, const char *root) {
+    snprintf(e->root, sizeof(e->root), "%s", root);
+    nfs_path_normalize(root, e->key, sizeof(e->key));
+}
+
+int nfs_export_single(const char *root, const nfs_store_ops *engine) {
+    nfs_export e;
+    memset(&e, 0, sizeof(e));
+    snprintf(e.name, sizeof(e.name), "%s", EXPORT_DEFAULT);
+    set_root(&e, root);
+    e.cache = DU_CACHE_ENTRIES;
+    e.engine = engine;
+    return install(&e, 1);
+}
+
+static int parse_option(nfs_export *e, const char *opt) {
+    if (strcmp(opt, "ro") == 0) {
+        e->read_only = 1;
+    } else if (strcmp(opt, "rw") == 0) {
+        e->read_only = 0;
+    } else if (strncmp(opt, "cache=", 6) == 0) {
+        char *end;
+        long n = strtol(opt + 6, &end, 10);
+        if (*end || end == opt + 6 || n < 0 || n > 1 << 20) return -1;
+        e->cache = (int)n;
+    } else if (strncmp(opt, "engine=", 7) == 0) {
+        if (!(e->engine = nfs_store_by_name(opt + 7))) return -1;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int nfs_export_load(const char *file, const nfs_store_ops *engine) {
+    FILE *f = fopen(file, "r");
+    if (!f) {
+        fprintf(stderr, "Error: cannot open %s: %s\n", file, strerror(errno));
+        return -1;
+    }
+
+    nfs_export table[MAX_EXPORTS];
+    int count = 0, lineno = 0, ret = 0;
+    char line[PATH_MAX + 256];
+    while (ret == 0 && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *save;
+        char *name = strtok_r(line, " \t\r\n", &save);
+        if (!name) continue;
+        char *root = strtok_r(NULL, " \t\r\n", &save);
+
+        if (!root || strlen(name) >= MAX_EXPORT_NAME || strchr(name, '/') ||
+            strcmp(name, "..") == 0) {
+            fprintf(stderr, "%s:%d: expected a name and a root directory\n", file, lineno);
+            ret = -1;
+            break;
+        }
+        if (count == MAX_EXPORTS || by_name(table, count, name, strlen(name))) {
+            fprintf(stderr, "%s:%d: too many exports or duplicate name %s\n", file, lineno, name);
+            ret = -1;
+            break;
+        }
+
+        nfs_export *e = &table[count];
+        memset(e, 0, sizeof(*e));
+        snprintf(e->name, sizeof(e->name), "%s", name);
+        set_root(e, root);
+        e->cache = DU_CACHE_ENTRIES;
+        e->engine = engine;
+        for (char *opt; ret == 0 && (opt = strtok_r(NULL, " \t\r\n", &save)); ) {
+            if (parse_option(e, opt) != 0) {
+                fprintf(stderr, "%s:%d: bad option %s\n", file, lineno, opt);
+                ret = -1;
+            }
+        }
+
+        if (ret == 0 && disk_only && e->engine == &nfs_store_mem) {
+            fprintf(stderr, "%s:%d: engine=mem is not shared between worker processes\n", file, lineno);
+            ret = -1;
+        }
+        // pe disc radacina trebuie sa existe; in memorie porneste goala
+        struct stat st;
+        if (ret == 0 && e->engine == &nfs_store_posix &&
+            (stat(e->root, &st) != 0 || !S_ISDIR(st.st_mode))) {
+            fprintf(stderr, "%s:%d: %s is not a directory\n", file, lineno, e->root);
+            ret = -1;
+        }
+        count++;
+    }
+    fclose(f);
+
+    if (ret == 0 && count == 0) {
+        fprintf(stderr, "%s: no exports\n", file);
+        ret = -1;
+    }
+    return ret == 0 ? install(table, count) : -1;
+}
+
+void nfs_export_disk_only(void) {
+    disk_only = 1;
+}
+
+int nfs_export_resolve(const char *rel, char *path, size_t pathlen) {
+    // "./a/../b" devine "b"; ".." nu poate iesi din export
+    char norm[PATH_MAX];
+    nfs_path_normalize(rel ? rel : "", norm, sizeof(norm));
+    rel = norm;
+
+    // primul component e numele unui export; altfel calea e in "."
+    size_t len = strcspn(rel, "/");
+    const nfs_export *e = len ? by_name(exports, export_count, rel, len) : NULL;
+    if (e && strcmp(e->name, EXPORT_DEFAULT) != 0) {
+        rel += len;
+        if (*rel == '/') rel++;
+    } else {
+        e = by_name(exports, export_count, EXPORT_DEFAULT, strlen(EXPORT_DEFAULT));
+        if (!e) {
+            errno = ENOENT;
+            return -1;
+        }
+    }
+
+    int n = *rel ? snprintf(path, pathlen, "%s/%s", e->root, rel) : snprintf(path, pathlen, "%s", e->root);
+    if (n < 0 || (size_t)n >= pathlen) return -1;
+    return 0;
+}
+
+const nfs_export *nfs_export_find(const char *path) {
+    char key[PATH_MAX];
+    nfs_path_normalize(path, key, sizeof(key));
+
+    // cea mai lunga radacina care contine calea (un export poate fi in altul)
+    const nfs_export *best = NULL;
+    for (int i = 0; i < export_count; i++) {
+        size_t n = strlen(exports[i].key);
+        if ((n == 0 || (strncmp(exports[i].key, key, n) == 0 && (key[n] == '\0' || key[n] == '/'))) &&
+            (!best || n > strlen(best->key)))
+            best = &exports[i];
+    }
+    return best;
+}
@@ -0,0 +1,49 @@
+#ifndef NFS_EXPORT_H
+#define NFS_EXPORT_H
+
+#include <limits.h>
+#include <stddef.h>
+#include "nfs_store.h"
+
+// tabela de exporturi, citita dintr-un fisier de configurare (-c) si
+// recitita la SIGHUP. Un rand pe export:
+//
+//     # nume   radacina    optiuni
+//     .        ./shared
+//     hot      ./hot       engine=mem cache=256
+//     archive  ./archive   ro cache=0
+//
+// Primul component din calea clientului alege exportul dupa nume ("hot/a.txt"
+// e ./hot/a.txt); restul cailor merg in exportul ".". Optiuni: ro / rw,
+// cache=N (cate totaluri du se tin in cache) si engine=posix|mem
+
+#define MAX_EXPORTS 16
+#define MAX_EXPORT_NAME 64
+#define EXPORT_DEFAULT "."
+
+typedef struct {
+    char name[MAX_EXPORT_NAME];
+    char root[PATH_MAX];
+    char key[PATH_MAX];             // radacina normalizata, pt nfs_export_find
+    int read_only;
+    int cache;
+    const nfs_store_ops *engine;
+} nfs_export;
+
+// fara fisier de configurare: doar exportul "." cu radacina data
+int nfs_export_single(const char *root, const nfs_store_ops *engine);
+
+// citeste tabela; engine e cel implicit. La eroare tabela veche ramane
+int nfs_export_load(const char *file, const nfs_store_ops *engine);
+
+// de acum incolo engine=mem e refuzat la incarcare (worker-ii -w nu impart
+// exporturile din memorie)
+void nfs_export_disk_only(void);
+
+// calea de pe server pt calea rel a clientului
+int nfs_export_resolve(const char *rel, char *path, size_t pathlen);
+
+// exportul in care se afla o cale de pe server; NULL in afara lor
+const nfs_export *nfs_export_find(const char *path);
+
+#endif
@@ -0,0 +1,167 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "nfs_du.h"
+#include "nfs_handoff.h"
+#include "nfs_lock.h"
+
+#define HANDOFF_ENV "NFS_HANDOFF"   // "<socket udp>,<fd catre procesul vechi>"
+#define HANDOFF_READY "ready\n"
+
+static int peer_fd = -1;            // in procesul nou
+static pid_t child = -1;            // in procesul vechi
+
+static int inherit(int fd) {
+    int flags = fcntl(fd, F_GETFD);
+    return flags < 0 ? -1 : fcntl(fd, F_SETFD, flags & ~FD_CLOEXEC);
+}
+
+int nfs_handoff_socket(void) {
+    const char *env = getenv(HANDOFF_ENV);
+    int sock, peer;
+    if (!env || sscanf(env, "%d,%d", &sock, &peer) != 2) return -1;
+    // un restart urmator porneste din nou de la zero
+    unsetenv(HANDOFF_ENV);
+    if (fcntl(sock, F_GETFD) < 0 || fcntl(peer, F_GETFD) < 0) {
+        fprintf(stderr, "nfs_handoff_socket: inherited descriptors are not open\n");
+        return -1;
+    }
+    fcntl(sock, F_SETFD, FD_CLOEXEC);
+    fcntl(peer, F_SETFD, FD_CLOEXEC);
+    peer_fd = peer;
+    return sock;
+}
+
+int nfs_handoff_accept(void) {
+    if (peer_fd < 0) return -1;
+    if (write(peer_fd, HANDOFF_READY, strlen(HANDOFF_READY)) != (ssize_t)strlen(HANDOFF_READY)) {
+        perror("nfs_handoff_accept write");
+        close(peer_fd);
+        peer_fd = -1;
+        return -1;
+    }
+
+    FILE *f = fdopen(peer_fd, "r");
+    if (!f) {
+        close(peer_fd);
+        peer_fd = -1;
+        return -1;
+    }
+    char *line = NULL;
+    size_t cap = 0;
+    int done = 0;
+    unsigned int du = 0, locks = 0;
+    while (getline(&line, &cap, f) > 0) {
+        if (strcmp(line, "end\n") == 0) {
+            done = 1;
+            break;
+        }
+        if (nfs_du_restore(line, 1) == 0) du++;
+        else if (nfs_lock_restore(line) == 0) locks++;
+    }
+    free(line);
+    fclose(f);
+    peer_fd = -1;
+
+    if (!done) {
+        fprintf(stderr, "nfs_handoff_accept: previous process went away before handing over its state\n");
+        return -1;
+    }
+    printf("Took over from the previous process: %u du entries, %u lock/lease entries.\n", du, locks);
+    return 0;
+}
+
+int nfs_handoff_start(int sock, char *argv[]) {
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) {
+        perror("nfs_handoff_start socketpair");
+        return -1;
+    }
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("nfs_handoff_start fork");
+        close(sv[0]);
+        close(sv[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        char env[32];
+        snprintf(env, sizeof(env), "%d,%d", sock, sv[1]);
+        if (inherit(sock) == 0 && inherit(sv[1]) == 0 && setenv(HANDOFF_ENV, env, 1) == 0)
+            execvp(argv[0], argv);
+        perror("nfs_handoff_start exec");
+        _exit(127);
+    }
+    close(sv[1]);
+    child = pid;
+    printf("Restarting: started pid %d, serving until it is ready.\n", (int)pid);
+    return sv[0];
+}
+
+int nfs_handoff_finish(int peer) {
+    char buf[sizeof(HANDOFF_READY)];
+    ssize_t n = read(peer, buf, strlen(HANDOFF_READY));
+    if (n != (ssize_t)strlen(HANDOFF_READY) || memcmp(buf, HANDOFF_READY, n) != 0) {
+        // succesorul a murit inainte sa fie gata (configurare gresita etc.)
+        fprintf(stderr, "Restart failed, pid %d did not start; still serving.\n", (int)child);
+        close(peer);
+        if (child > 0) waitpid(child, NULL, WNOHANG);
+        child = -1;
+        return 0;
+    }
+
+    FILE *f = fdopen(peer, "w");
+    if (!f) {
+        close(peer);
+        return 0;
+    }
+    nfs_du_save(f);
+    nfs_lock_save(f);
+    fputs("end\n", f);
+    if (fclose(f) != 0) {
+        perror("nfs_handoff_finish");
+        return 0;
+    }
+    printf("Handed over to pid %d, exiting.\n", (int)child);
+    return 1;
+}
+
+int nfs_snapshot_save(const char *file) {
+    char tmp[PATH_MAX];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", file);
+    FILE *f = fopen(tmp, "w");
+    if (!f) {
+        perror("nfs_snapshot_save");
+        return -1;
+    }
+    nfs_du_save(f);
+    if (fclose(f) != 0 || rename(tmp, file) != 0) {
+        perror("nfs_snapshot_save");
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+int nfs_snapshot_load(const char *file) {
+    FILE *f = fopen(file, "r");
+    if (!f) return errno == ENOENT ? 0 : -1;   // prima pornire
+    char *line = NULL;
+    size_t cap = 0;
+    unsigned int n = 0;
+    while (getline(&line, &cap, f) > 0)
+        if (nfs_du_restore(line, 0) == 0) n++;
+    free(line);
+    fclose(f);
+    printf("Snapshot %s: %u directories to warm up.\n", file, n);
+    return 0;
+}
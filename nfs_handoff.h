@@ -0,0 +1,29 @@
+#ifndef NFS_HANDOFF_H
+#define NFS_HANDOFF_H
+
+// repornire fara pierderi (SIGUSR2): serverul porneste o copie noua a
+// programului, cu acelasi argv (deci si binarul nou, dupa o actualizare),
+// care mosteneste socket-ul UDP. Procesul vechi serveste in continuare pana
+// cand cel nou e gata, ii preda cache-ul du, blocarile si lease-urile si iese;
+// cererile sosite intre timp asteapta in socket, nu se pierd
+
+// in procesul nou: socket-ul mostenit, sau -1 la o pornire obisnuita
+int nfs_handoff_socket(void);
+
+// in procesul nou, dupa inregistrare: anunta procesul vechi si ii preia starea
+int nfs_handoff_accept(void);
+
+// in procesul vechi: porneste succesorul; intoarce fd-ul pe care acesta
+// anunta ca e gata (citibil), sau -1
+int nfs_handoff_start(int sock, char *argv[]);
+
+// in procesul vechi, cand peer e citibil: 1 daca succesorul e gata si a
+// primit starea, 0 daca a esuat (peer se inchide, serverul merge mai departe)
+int nfs_handoff_finish(int peer);
+
+// instantaneu pt pornirile la rece (-s): directoarele din cache-ul du, care
+// la pornire se recalculeaza cand serverul nu are cereri
+int nfs_snapshot_save(const char *file);
+int nfs_snapshot_load(const char *file);
+
+#endif
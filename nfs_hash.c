@@ -0,0 +1,142 @@
+#include <string.h>
+#include <unistd.h>
+#include "nfs_hash.h"
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_block(nfs_sha256_ctx *ctx, const unsigned char *p) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+        w[i] = (uint32_t)p[4 * i] << 24 | (uint32_t)p[4 * i + 1] << 16 |
+               (uint32_t)p[4 * i + 2] << 8 | p[4 * i + 3];
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROR(w[i - 15], 7) ^ ROR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROR(w[i - 2], 17) ^ ROR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+    uint32_t e = ctx->state[4], f = ctx->state[5], g = ctx->state[6], h = ctx->state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ROR(e, 6) ^ ROR(e, 11) ^ ROR(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (ROR(a, 2) ^ ROR(a, 13) ^ ROR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    ctx->state[0] += a; ctx->state[1] += b; ctx->state[2] += c; ctx->state[3] += d;
+    ctx->state[4] += e; ctx->state[5] += f; ctx->state[6] += g; ctx->state[7] += h;
+}
+
+void nfs_sha256_init(nfs_sha256_ctx *ctx) {
+    static const uint32_t init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(ctx->state, init, sizeof(init));
+    ctx->count = 0;
+}
+
+void nfs_sha256_update(nfs_sha256_ctx *ctx, const void *data, size_t len) {
+    const unsigned char *p = data;
+    size_t used = ctx->count % 64;
+    ctx->count += len;
+
+    if (used) {
+        size_t fill = 64 - used;
+        if (len < fill) {
+            memcpy(ctx->buf + used, p, len);
+            return;
+        }
+        memcpy(ctx->buf + used, p, fill);
+        sha256_block(ctx, ctx->buf);
+        p += fill;
+        len -= fill;
+    }
+    for (; len >= 64; p += 64, len -= 64)
+        sha256_block(ctx, p);
+    memcpy(ctx->buf, p, len);
+}
+
+void nfs_sha256_final(nfs_sha256_ctx *ctx, unsigned char out[NFS_SHA256_LEN]) {
+    uint64_t bits = ctx->count * 8;
+    size_t used = ctx->count % 64;
+
+    ctx->buf[used++] = 0x80;
+    if (used > 56) {
+        memset(ctx->buf + used, 0, 64 - used);
+        sha256_block(ctx, ctx->buf);
+        used = 0;
+    }
+    memset(ctx->buf + used, 0, 56 - used);
+    for (int i = 0; i < 8; i++)
+        ctx->buf[56 + i] = (unsigned char)(bits >> (56 - 8 * i));
+    sha256_block(ctx, ctx->buf);
+
+    for (int i = 0; i < 8; i++) {
+        out[4 * i] = (unsigned char)(ctx->state[i] >> 24);
+        out[4 * i + 1] = (unsigned char)(ctx->state[i] >> 16);
+        out[4 * i + 2] = (unsigned char)(ctx->state[i] >> 8);
+        out[4 * i + 3] = (unsigned char)ctx->state[i];
+    }
+}
+
+int nfs_file_sha256(int fd, off_t offset, off_t length, unsigned char out[NFS_SHA256_LEN]) {
+    unsigned char buf[64 * 1024];
+    nfs_sha256_ctx ctx;
+    nfs_sha256_init(&ctx);
+
+    off_t pos = offset;
+    while (length == 0 || pos < offset + length) {
+        size_t want = sizeof(buf);
+        if (length != 0 && offset + length - pos < (off_t)want)
+            want = (size_t)(offset + length - pos);
+        ssize_t n = pread(fd, buf, want, pos);
+        if (n < 0) return -1;
+        if (n == 0) break;
+        nfs_sha256_update(&ctx, buf, (size_t)n);
+        pos += n;
+    }
+    nfs_sha256_final(&ctx, out);
+    return 0;
+}
+
+// a = suma bytes, b = suma ponderata cu pozitia, ambele mod 2^16
+uint32_t nfs_weak_sum(const unsigned char *buf, size_t len) {
+    uint32_t a = 0, b = 0;
+    for (size_t i = 0; i < len; i++) {
+        a += buf[i];
+        b += (uint32_t)(len - i) * buf[i];
+    }
+    return (a & 0xffff) | (b << 16);
+}
+
+uint32_t nfs_weak_roll(uint32_t sum, size_t len, unsigned char out, unsigned char in) {
+    uint32_t a = sum & 0xffff, b = sum >> 16;
+    a = (a - out + in) & 0xffff;
+    b = (b - (uint32_t)len * out + a) & 0xffff;
+    return a | (b << 16);
+}
+
+uint64_t nfs_strong_sum(const unsigned char *buf, size_t len) {
+    unsigned char digest[NFS_SHA256_LEN];
+    nfs_sha256_ctx ctx;
+    nfs_sha256_init(&ctx);
+    nfs_sha256_update(&ctx, buf, len);
+    nfs_sha256_final(&ctx, digest);
+
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+        v = v << 8 | digest[i];
+    return v;
+}
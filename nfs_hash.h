@@ -0,0 +1,32 @@
+#ifndef NFS_HASH_H
+#define NFS_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// sume de control comune clientului si serverului
+
+#define NFS_SHA256_LEN 32
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t count;          // bytes procesati
+    unsigned char buf[64];
+} nfs_sha256_ctx;
+
+void nfs_sha256_init(nfs_sha256_ctx *ctx);
+void nfs_sha256_update(nfs_sha256_ctx *ctx, const void *data, size_t len);
+void nfs_sha256_final(nfs_sha256_ctx *ctx, unsigned char out[NFS_SHA256_LEN]);
+
+// sha256 pe [offset, offset + length) dintr-un fd; length 0 = pana la sfarsit
+int nfs_file_sha256(int fd, off_t offset, off_t length, unsigned char out[NFS_SHA256_LEN]);
+
+// suma slaba tip rsync, se poate rostogoli cu cate un byte
+uint32_t nfs_weak_sum(const unsigned char *buf, size_t len);
+uint32_t nfs_weak_roll(uint32_t sum, size_t len, unsigned char out, unsigned char in);
+
+// suma tare pe bloc: primii 8 bytes din sha256
+uint64_t nfs_strong_sum(const unsigned char *buf, size_t len);
+
+#endif
@@ -0,0 +1,151 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "nfs_journal.h"
+
+// dupa antet, cate o linie de lungime fixa per interval, ca intervalul in curs
+// sa se poata rescrie pe loc cand creste
+#define JOURNAL_MAGIC "MYNFSJ1 "
+#define LINE_FMT "%020llu %020llu\n"
+#define LINE_LEN 42
+
+static int cmp_ranges(const void *a, const void *b) {
+    const journal_range *x = a, *y = b;
+    return x->start < y->start ? -1 : x->start > y->start;
+}
+
+// intervalele din jurnal, sortate si unite
+static void load(nfs_journal *j, FILE *f) {
+    unsigned long long s, e;
+    unsigned int cap = 0;
+    while (fscanf(f, "%llu %llu", &s, &e) == 2) {
+        if (e <= s) continue;
+        if (j->count == cap) {
+            cap = cap ? cap * 2 : 16;
+            journal_range *grown = realloc(j->done, cap * sizeof(*grown));
+            if (!grown) break;
+            j->done = grown;
+        }
+        j->done[j->count].start = s;
+        j->done[j->count].end = e;
+        j->count++;
+    }
+    if (j->count == 0) return;
+
+    qsort(j->done, j->count, sizeof(*j->done), cmp_ranges);
+    unsigned int n = 0;
+    for (unsigned int i = 1; i < j->count; i++) {
+        if (j->done[i].start <= j->done[n].end) {
+            if (j->done[i].end > j->done[n].end) j->done[n].end = j->done[i].end;
+        } else {
+            j->done[++n] = j->done[i];
+        }
+    }
+    j->count = n + 1;
+}
+
+static int write_header(nfs_journal *j, const char *ident) {
+    if (ftruncate(j->fd, 0) != 0) return -1;
+    char header[PATH_MAX + 128];
+    int n = snprintf(header, sizeof(header), "%s%s\n", JOURNAL_MAGIC, ident);
+    if (n < 0 || (size_t)n >= sizeof(header)) return -1;
+    return pwrite(j->fd, header, n, 0) == n ? 0 : -1;
+}
+
+nfs_journal *nfs_journal_open(const char *file, const char *ident) {
+    nfs_journal *j = calloc(1, sizeof(*j));
+    if (!j) return NULL;
+    j->run_at = -1;
+    int n = snprintf(j->path, sizeof(j->path), "%s%s", file, JOURNAL_SUFFIX);
+    if (n < 0 || (size_t)n >= sizeof(j->path)) {
+        free(j);
+        return NULL;
+    }
+
+    // jurnalul ramas de la o incercare anterioara a aceluiasi transfer
+    FILE *old = fopen(j->path, "r");
+    if (old) {
+        char line[PATH_MAX + 128];
+        char want[PATH_MAX + 128];
+        snprintf(want, sizeof(want), "%s%s\n", JOURNAL_MAGIC, ident);
+        if (fgets(line, sizeof(line), old) && strcmp(line, want) == 0)
+            load(j, old);
+        fclose(old);
+    }
+
+    j->fd = open(j->path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (j->fd < 0 || (j->count == 0 && write_header(j, ident) != 0)) {
+        perror("nfs_journal_open");
+        if (j->fd >= 0) close(j->fd);
+        free(j->done);
+        free(j);
+        return NULL;
+    }
+    return j;
+}
+
+// scrie intervalul in curs peste linia lui, sau la sfarsit daca e nou
+static void flush_run(nfs_journal *j) {
+    if (j->run.end <= j->run.start) return;
+    if (j->run_at < 0) j->run_at = lseek(j->fd, 0, SEEK_END);
+    char line[LINE_LEN + 1];
+    snprintf(line, sizeof(line), LINE_FMT, (unsigned long long)j->run.start,
+             (unsigned long long)j->run.end);
+    if (j->run_at < 0 || pwrite(j->fd, line, LINE_LEN, j->run_at) != LINE_LEN)
+        perror("nfs_journal write");
+    j->unsynced = 0;
+}
+
+void nfs_journal_mark(nfs_journal *j, uint64_t start, uint64_t end) {
+    if (!j || end <= start) return;
+    if (j->run.end > j->run.start && start == j->run.end) {
+        j->run.end = end;
+    } else {
+        flush_run(j);
+        j->run.start = start;
+        j->run.end = end;
+        j->run_at = -1;
+    }
+    j->unsynced += end - start;
+    if (j->unsynced >= JOURNAL_FLUSH) flush_run(j);
+}
+
+int nfs_journal_missing(const nfs_journal *j, uint64_t pos, uint64_t end,
+                        uint64_t *start, uint64_t *stop) {
+    for (unsigned int i = 0; j && i < j->count && pos < end; i++) {
+        if (j->done[i].end <= pos) continue;
+        if (j->done[i].start > pos) {
+            *start = pos;
+            *stop = j->done[i].start < end ? j->done[i].start : end;
+            return 1;
+        }
+        pos = j->done[i].end;
+    }
+    if (pos >= end) return 0;
+    *start = pos;
+    *stop = end;
+    return 1;
+}
+
+void nfs_journal_reset(nfs_journal *j) {
+    if (!j) return;
+    free(j->done);
+    j->done = NULL;
+    j->count = 0;
+    // doar antetul ramane
+    char line[PATH_MAX + 128];
+    ssize_t n = pread(j->fd, line, sizeof(line) - 1, 0);
+    char *nl = n > 0 ? memchr(line, '\n', n) : NULL;
+    if (nl && ftruncate(j->fd, nl - line + 1) != 0) perror("nfs_journal_reset");
+}
+
+void nfs_journal_close(nfs_journal *j, int finished) {
+    if (!j) return;
+    if (!finished) flush_run(j);
+    close(j->fd);
+    if (finished) unlink(j->path);
+    free(j->done);
+    free(j);
+}
@@ -0,0 +1,44 @@
+#ifndef NFS_JOURNAL_H
+#define NFS_JOURNAL_H
+
+#include <limits.h>
+#include <stdint.h>
+
+// jurnalul unui transfer, langa fisierul local: ce intervale au ajuns deja,
+// ca un download/upload intrerupt sa continue doar cu ce lipseste.
+// Prima linie identifica transferul; un jurnal cu alta identitate se ignora
+
+#define JOURNAL_SUFFIX ".mynfs-journal"
+#define JOURNAL_FLUSH (64 * 1024)   // progresul se scrie in jurnal din atatia bytes
+
+typedef struct {
+    uint64_t start, end;
+} journal_range;
+
+typedef struct {
+    int fd;
+    char path[PATH_MAX];
+    journal_range *done;        // gasite la deschidere, sortate si unite
+    unsigned int count;
+    journal_range run;          // intervalul in curs, continuu
+    long long run_at;           // linia lui in jurnal, -1 = inca nescrisa
+    uint64_t unsynced;
+} nfs_journal;
+
+// ident: tipul transferului, calea remote, dimensiunea si mtime-ul sursei
+nfs_journal *nfs_journal_open(const char *file, const char *ident);
+
+// [start, end) a ajuns la destinatie
+void nfs_journal_mark(nfs_journal *j, uint64_t start, uint64_t end);
+
+// primul interval din [pos, end) care nu e in done; 0 daca nu mai e nimic
+int nfs_journal_missing(const nfs_journal *j, uint64_t pos, uint64_t end,
+                        uint64_t *start, uint64_t *stop);
+
+// ce era in jurnal nu se mai potriveste cu fisierele: transferul o ia de la 0
+void nfs_journal_reset(nfs_journal *j);
+
+// finished: jurnalul se sterge; altfel ramane pt reluare
+void nfs_journal_close(nfs_journal *j, int finished);
+
+#endif
@@ -0,0 +1,431 @@
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "nfs.h"
+#include "nfs_lock.h"
+#include "nfs_shm.h"
+#include "nfs_walk.h"
+
+// [start, end); UINT64_MAX = pana la sfarsitul fisierului
+typedef struct range_lock {
+    uint64_t client;
+    char path[PATH_MAX];
+    uint64_t start, end;
+    int exclusive;
+    struct range_lock *next;
+} range_lock;
+
+typedef struct lease {
+    uint64_t client;
+    char path[PATH_MAX];
+    char name[MAX_FILENAME_LENGTH + 1];
+    int type;
+    time_t recall_deadline;     // 0 = nerechemat
+    struct lease *next;
+} lease;
+
+typedef struct client_state {
+    uint64_t id;
+    time_t expires;
+    struct client_state *next;
+} client_state;
+
+typedef struct {
+    range_lock *locks;
+    lease *leases;
+    client_state *clients;
+} lock_tables;
+
+// in memoria procesului; cu nfs_lock_share, in cea comuna a worker-ilor
+static lock_tables local_tables;
+static lock_tables *tables = &local_tables;
+
+static void range_of(u_int off, u_int len, uint64_t *start, uint64_t *end) {
+    *start = off;
+    *end = len ? (uint64_t)off + len : UINT64_MAX;
+}
+
+static void drop_client(uint64_t id) {
+    for (range_lock **p = &tables->locks; *p; ) {
+        if ((*p)->client == id) {
+            range_lock *dead = *p;
+            *p = dead->next;
+            nfs_shm_free(dead);
+        } else {
+            p = &(*p)->next;
+        }
+    }
+    for (lease **p = &tables->leases; *p; ) {
+        if ((*p)->client == id) {
+            lease *dead = *p;
+            *p = dead->next;
+            nfs_shm_free(dead);
+        } else {
+            p = &(*p)->next;
+        }
+    }
+}
+
+// clientii care nu au mai reinnoit isi pierd blocarile si lease-urile
+static void expire(void) {
+    time_t now = time(NULL);
+    for (client_state **p = &tables->clients; *p; ) {
+        if ((*p)->expires <= now) {
+            client_state *dead = *p;
+            drop_client(dead->id);
+            *p = dead->next;
+            nfs_shm_free(dead);
+        } else {
+            p = &(*p)->next;
+        }
+    }
+}
+
+static void touch(uint64_t id) {
+    client_state *c;
+    for (c = tables->clients; c; c = c->next)
+        if (c->id == id) break;
+    if (!c) {
+        c = nfs_shm_alloc(sizeof(*c));
+        if (!c) return;
+        c->id = id;
+        c->next = tables->clients;
+        tables->clients = c;
+    }
+    c->expires = time(NULL) + LEASE_SECONDS;
+}
+
+static int lock_release(uint64_t client, const char *path, u_int off, u_int len);
+
+static int lock_acquire(uint64_t client, const char *path, u_int off, u_int len, int exclusive) {
+    if (!client) return -1;
+    expire();
+    touch(client);
+
+    char key[PATH_MAX];
+    uint64_t start, end;
+    nfs_path_normalize(path, key, sizeof(key));
+    range_of(off, len, &start, &end);
+
+    for (range_lock *l = tables->locks; l; l = l->next) {
+        if (l->client != client && strcmp(l->path, key) == 0 &&
+            l->start < end && start < l->end && (exclusive || l->exclusive))
+            return ERR_LOCKED;
+    }
+
+    // o blocare noua peste una proprie ii schimba modul pe interval
+    lock_release(client, path, off, len);
+    range_lock *l = nfs_shm_alloc(sizeof(*l));
+    if (!l) return -1;
+    l->client = client;
+    snprintf(l->path, sizeof(l->path), "%s", key);
+    l->start = start;
+    l->end = end;
+    l->exclusive = exclusive;
+    l->next = tables->locks;
+    tables->locks = l;
+    return 0;
+}
+
+static int lock_release(uint64_t client, const char *path, u_int off, u_int len) {
+    char key[PATH_MAX];
+    uint64_t start, end;
+    nfs_path_normalize(path, key, sizeof(key));
+    range_of(off, len, &start, &end);
+
+    for (range_lock **p = &tables->locks; *p; ) {
+        range_lock *l = *p;
+        if (l->client != client || strcmp(l->path, key) != 0 ||
+            l->end <= start || end <= l->start) {
+            p = &l->next;
+            continue;
+        }
+        if (l->start < start && l->end > end) {
+            // deblocare la mijloc: raman doua bucati
+            range_lock *tail = nfs_shm_alloc(sizeof(*tail));
+            if (!tail) return -1;
+            *tail = *l;
+            tail->start = end;
+            l->end = start;
+            l->next = tail;
+            p = &tail->next;
+        } else if (l->start < start) {
+            l->end = start;
+            p = &l->next;
+        } else if (l->end > end) {
+            l->start = end;
+            p = &l->next;
+        } else {
+            *p = l->next;
+            nfs_shm_free(l);
+        }
+    }
+    return 0;
+}
+
+static int lock_conflict(uint64_t client, const char *path, u_int off, u_int len) {
+    if (!tables->locks) return 0;
+    expire();
+
+    char key[PATH_MAX];
+    uint64_t start, end;
+    nfs_path_normalize(path, key, sizeof(key));
+    range_of(off, len, &start, &end);
+    for (range_lock *l = tables->locks; l; l = l->next) {
+        if (l->client != client && strcmp(l->path, key) == 0 &&
+            l->start < end && start < l->end)
+            return ERR_LOCKED;
+    }
+    return 0;
+}
+
+static void lock_forget(const char *path) {
+    char key[PATH_MAX];
+    nfs_path_normalize(path, key, sizeof(key));
+    for (range_lock **p = &tables->locks; *p; ) {
+        if (strcmp((*p)->path, key) == 0) {
+            range_lock *dead = *p;
+            *p = dead->next;
+            nfs_shm_free(dead);
+        } else {
+            p = &(*p)->next;
+        }
+    }
+    for (lease **p = &tables->leases; *p; ) {
+        if (strcmp((*p)->path, key) == 0) {
+            lease *dead = *p;
+            *p = dead->next;
+            nfs_shm_free(dead);
+        } else {
+            p = &(*p)->next;
+        }
+    }
+}
+
+// recheama lease-urile altor clienti incompatibile cu accesul cerut;
+// 1 daca mai exista vreunul nepredat si neexpirat
+static int recall_others(uint64_t client, const char *key, int writing) {
+    time_t now = time(NULL);
+    int busy = 0;
+    for (lease **p = &tables->leases; *p; ) {
+        lease *l = *p;
+        if (l->client == client || strcmp(l->path, key) != 0 ||
+            (!writing && l->type != LEASE_WRITE)) {
+            p = &l->next;
+            continue;
+        }
+        if (!l->recall_deadline)
+            l->recall_deadline = now + LEASE_SECONDS;
+        if (now >= l->recall_deadline) {
+            // clientul nu a raspuns la rechemare, lease-ul se revoca
+            *p = l->next;
+            nfs_shm_free(l);
+            continue;
+        }
+        busy = 1;
+        p = &l->next;
+    }
+    return busy;
+}
+
+static int lease_acquire(uint64_t client, const char *path, const char *name, int type) {
+    if (!client) return -1;
+    expire();
+    touch(client);
+
+    char key[PATH_MAX];
+    nfs_path_normalize(path, key, sizeof(key));
+
+    lease **own = &tables->leases;
+    while (*own && ((*own)->client != client || strcmp((*own)->path, key) != 0))
+        own = &(*own)->next;
+
+    if (type == LEASE_NONE) {
+        if (*own) {
+            lease *dead = *own;
+            *own = dead->next;
+            nfs_shm_free(dead);
+        }
+        return 0;
+    }
+    if (type != LEASE_READ && type != LEASE_WRITE) return -1;
+    if (recall_others(client, key, type == LEASE_WRITE)) return ERR_DELAY;
+
+    lease *l = *own;
+    if (!l) {
+        l = nfs_shm_alloc(sizeof(*l));
+        if (!l) return -1;
+        l->client = client;
+        snprintf(l->path, sizeof(l->path), "%s", key);
+        l->next = tables->leases;
+        tables->leases = l;
+    }
+    snprintf(l->name, sizeof(l->name), "%s", name ? name : "");
+    l->type = type;
+    l->recall_deadline = 0;
+    return 0;
+}
+
+static int lease_conflict(uint64_t client, const char *path, int writing) {
+    if (!tables->leases) return 0;
+    expire();
+
+    char key[PATH_MAX];
+    nfs_path_normalize(path, key, sizeof(key));
+    return recall_others(client, key, writing) ? ERR_DELAY : 0;
+}
+
+static u_int lease_renew(uint64_t client, char **recalled, u_int max) {
+    if (!client) return 0;
+    expire();
+    touch(client);
+
+    u_int n = 0;
+    for (lease *l = tables->leases; l && n < max; l = l->next) {
+        if (l->client == client && l->recall_deadline) {
+            recalled[n] = strdup(l->name);
+            if (recalled[n]) n++;
+        }
+    }
+    return n;
+}
+
+static void lock_save(FILE *f) {
+    expire();
+    for (client_state *c = tables->clients; c; c = c->next)
+        fprintf(f, "client %" PRIu64 " %lld\n", c->id, (long long)c->expires);
+    for (range_lock *l = tables->locks; l; l = l->next) {
+        if (strpbrk(l->path, "\t\n")) continue;
+        fprintf(f, "lock %" PRIu64 " %" PRIu64 " %" PRIu64 " %d\t%s\n",
+                l->client, l->start, l->end, l->exclusive, l->path);
+    }
+    for (lease *l = tables->leases; l; l = l->next) {
+        if (strpbrk(l->path, "\t\n") || strpbrk(l->name, "\t\n")) continue;
+        fprintf(f, "lease %" PRIu64 " %d %lld\t%s\t%s\n",
+                l->client, l->type, (long long)l->recall_deadline, l->path, l->name);
+    }
+}
+
+// campul text de la s pana la tab sau sfarsitul randului
+static const char *field(const char *s, char *out, size_t len) {
+    size_t n = strcspn(s, "\t\n");
+    snprintf(out, len, "%.*s", (int)n, s);
+    return s[n] == '\t' ? s + n + 1 : s + n;
+}
+
+static int lock_restore(const char *line) {
+    uint64_t client, start, end;
+    long long when;
+    int n = 0, num;
+
+    if (sscanf(line, "client %" SCNu64 " %lld%n", &client, &when, &n) == 2 && n) {
+        client_state *c = nfs_shm_alloc(sizeof(*c));
+        if (!c) return 0;
+        c->id = client;
+        c->expires = (time_t)when;
+        c->next = tables->clients;
+        tables->clients = c;
+        return 0;
+    }
+    if (sscanf(line, "lock %" SCNu64 " %" SCNu64 " %" SCNu64 " %d\t%n",
+               &client, &start, &end, &num, &n) == 4 && n) {
+        range_lock *l = nfs_shm_alloc(sizeof(*l));
+        if (!l) return 0;
+        l->client = client;
+        l->start = start;
+        l->end = end;
+        l->exclusive = num;
+        field(line + n, l->path, sizeof(l->path));
+        l->next = tables->locks;
+        tables->locks = l;
+        return 0;
+    }
+    if (sscanf(line, "lease %" SCNu64 " %d %lld\t%n", &client, &num, &when, &n) == 3 && n) {
+        lease *l = nfs_shm_alloc(sizeof(*l));
+        if (!l) return 0;
+        l->client = client;
+        l->type = num;
+        l->recall_deadline = (time_t)when;
+        field(field(line + n, l->path, sizeof(l->path)), l->name, sizeof(l->name));
+        l->next = tables->leases;
+        tables->leases = l;
+        return 0;
+    }
+    return -1;
+}
+
+int nfs_lock_share(void) {
+    if (!nfs_shm_enabled()) return 0;
+    lock_tables *shared = nfs_shm_alloc(sizeof(*shared));
+    if (!shared) return -1;
+    // se apeleaza la pornire, cand listele locale sunt inca goale
+    tables = shared;
+    return 0;
+}
+
+// toti worker-ii vad aceleasi liste, deci fiecare apel le tine blocate cat
+// le parcurge; fara memorie comuna nfs_shm_lock nu face nimic
+
+int nfs_lock_acquire(uint64_t client, const char *path, u_int off, u_int len, int exclusive) {
+    nfs_shm_lock();
+    int ret = lock_acquire(client, path, off, len, exclusive);
+    nfs_shm_unlock();
+    return ret;
+}
+
+int nfs_lock_release(uint64_t client, const char *path, u_int off, u_int len) {
+    nfs_shm_lock();
+    int ret = lock_release(client, path, off, len);
+    nfs_shm_unlock();
+    return ret;
+}
+
+int nfs_lock_conflict(uint64_t client, const char *path, u_int off, u_int len) {
+    nfs_shm_lock();
+    int ret = lock_conflict(client, path, off, len);
+    nfs_shm_unlock();
+    return ret;
+}
+
+void nfs_lock_forget(const char *path) {
+    nfs_shm_lock();
+    lock_forget(path);
+    nfs_shm_unlock();
+}
+
+int nfs_lease_acquire(uint64_t client, const char *path, const char *name, int type) {
+    nfs_shm_lock();
+    int ret = lease_acquire(client, path, name, type);
+    nfs_shm_unlock();
+    return ret;
+}
+
+int nfs_lease_conflict(uint64_t client, const char *path, int writing) {
+    nfs_shm_lock();
+    int ret = lease_conflict(client, path, writing);
+    nfs_shm_unlock();
+    return ret;
+}
+
+u_int nfs_lease_renew(uint64_t client, char **recalled, u_int max) {
+    nfs_shm_lock();
+    u_int n = lease_renew(client, recalled, max);
+    nfs_shm_unlock();
+    return n;
+}
+
+void nfs_lock_save(FILE *f) {
+    nfs_shm_lock();
+    lock_save(f);
+    nfs_shm_unlock();
+}
+
+int nfs_lock_restore(const char *line) {
+    nfs_shm_lock();
+    int ret = lock_restore(line);
+    nfs_shm_unlock();
+    return ret;
+}
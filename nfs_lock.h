@@ -0,0 +1,44 @@
+#ifndef NFS_LOCK_H
+#define NFS_LOCK_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+// blocari pe intervale si lease-uri, tinute in memorie pe server; starea unui
+// client dispare daca nu o reinnoieste timp de LEASE_SECONDS.
+// Caile sunt cele de pe server (make_path); len 0 = pana la sfarsit
+
+// blocari consultative pt client, obligatorii pt scrierile altor clienti
+int nfs_lock_acquire(uint64_t client, const char *path, u_int off, u_int len, int exclusive);
+int nfs_lock_release(uint64_t client, const char *path, u_int off, u_int len);
+
+// ERR_LOCKED daca alt client are o blocare peste interval
+int nfs_lock_conflict(uint64_t client, const char *path, u_int off, u_int len);
+
+// fisierul a fost sters: blocarile si lease-urile lui nu mai au sens
+void nfs_lock_forget(const char *path);
+
+// LEASE_NONE preda lease-ul; ERR_DELAY daca alt client trebuie intai sa-l predea
+// pe al lui. name e numele folosit de client, intors la rechemare
+int nfs_lease_acquire(uint64_t client, const char *path, const char *name, int type);
+
+// inainte de o operatie pe fisier: lease-urile incompatibile ale altor clienti
+// sunt rechemate si operatia primeste ERR_DELAY pana sunt predate sau expira
+int nfs_lease_conflict(uint64_t client, const char *path, int writing);
+
+// reinnoieste starea clientului; in recalled numele lease-urilor rechemate
+u_int nfs_lease_renew(uint64_t client, char **recalled, u_int max);
+
+// cu memorie comuna (nfs_shm_init), listele se muta acolo ca sa le vada toti
+// worker-ii; inainte de fork si de orice blocare
+int nfs_lock_share(void);
+
+// starea ca text, pt repornirea fara pierderi (nfs_handoff): clientii,
+// blocarile si lease-urile, cate una pe rand
+void nfs_lock_save(FILE *f);
+
+// un rand scris de nfs_lock_save; -1 daca nu e al lui
+int nfs_lock_restore(const char *line);
+
+#endif
@@ -0,0 +1,412 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "nfs.h"
+#include "nfs_mem.h"
+
+struct mem_node {
+    char *key;                  // calea normalizata
+    const char *name;           // ultima componenta, in key
+    int dir;
+    ino_t ino;
+    struct timespec mtime;
+    struct mem_node *parent;
+    struct mem_node *children;  // director: lista copiilor
+    struct mem_node *prev, *next;
+    struct mem_node *hash_next;
+    off_t size;
+    char **ext;                 // fisier: ext[i] acopera [i * MEM_EXTENT, (i + 1) * MEM_EXTENT)
+    size_t ext_count;
+    size_t ext_used;            // extenturi alocate, pt st_blocks
+};
+
+static nfs_mem_node **table = NULL;
+static size_t buckets = 0, node_count = 0;
+static int root_count = 0;       // radacini = exporturi tinute in memorie
+static ino_t next_ino = 1;
+static nfs_mem_notify_fn notify_fn = NULL;
+
+static size_t hash_key(const char *key) {
+    size_t h = 1469598103934665603ULL;   // FNV-1a
+    for (; *key; key++) h = (h ^ (unsigned char)*key) * 1099511628211ULL;
+    return h;
+}
+
+static void table_insert(nfs_mem_node *n) {
+    size_t b = hash_key(n->key) & (buckets - 1);
+    n->hash_next = table[b];
+    table[b] = n;
+    node_count++;
+}
+
+static void table_remove(nfs_mem_node *n) {
+    for (nfs_mem_node **p = &table[hash_key(n->key) & (buckets - 1)]; *p; p = &(*p)->hash_next) {
+        if (*p == n) {
+            *p = n->hash_next;
+            node_count--;
+            return;
+        }
+    }
+}
+
+// peste un nod pe bucket in medie, tabela se dubleaza
+static void table_grow(void) {
+    if (node_count < buckets) return;
+    nfs_mem_node **grown = calloc(buckets * 2, sizeof(*grown));
+    if (!grown) return;
+    for (size_t i = 0; i < buckets; i++) {
+        for (nfs_mem_node *n = table[i], *next; n; n = next) {
+            next = n->hash_next;
+            size_t b = hash_key(n->key) & (buckets * 2 - 1);
+            n->hash_next = grown[b];
+            grown[b] = n;
+        }
+    }
+    free(table);
+    table = grown;
+    buckets *= 2;
+}
+
+static nfs_mem_node *find(const char *key) {
+    for (nfs_mem_node *n = table[hash_key(key) & (buckets - 1)]; n; n = n->hash_next)
+        if (strcmp(n->key, key) == 0) return n;
+    return NULL;
+}
+
+static void touch(nfs_mem_node *n) {
+    clock_gettime(CLOCK_REALTIME, &n->mtime);
+}
+
+static void emit(nfs_mem_node *n, int type) {
+    if (notify_fn && n->parent) notify_fn(n->parent->ino, type, n->name);
+}
+
+// nod nou sub directorul parinte al lui key
+static nfs_mem_node *add_node(const char *key, int dir) {
+    char parent_key[PATH_MAX];
+    snprintf(parent_key, sizeof(parent_key), "%s", key);
+    char *slash = strrchr(parent_key, '/');
+    if (!slash) {
+        errno = ENOENT;   // in afara directorului partajat
+        return NULL;
+    }
+    *slash = '\0';
+    nfs_mem_node *parent = find(parent_key);
+    if (!parent) {
+        errno = ENOENT;
+        return NULL;
+    }
+    if (!parent->dir) {
+        errno = ENOTDIR;
+        return NULL;
+    }
+
+    nfs_mem_node *n = calloc(1, sizeof(*n));
+    if (!n || !(n->key = strdup(key))) {
+        free(n);
+        errno = ENOMEM;
+        return NULL;
+    }
+    n->name = n->key + (slash - parent_key) + 1;
+    n->dir = dir;
+    n->ino = next_ino++;
+    touch(n);
+    n->parent = parent;
+    n->next = parent->children;
+    if (parent->children) parent->children->prev = n;
+    parent->children = n;
+    touch(parent);
+
+    table_grow();
+    table_insert(n);
+    emit(n, EV_CREATE);
+    return n;
+}
+
+static void drop_extents(nfs_mem_node *n, size_t from) {
+    for (size_t i = from; i < n->ext_count; i++) {
+        if (n->ext[i]) n->ext_used--;
+        free(n->ext[i]);
+        n->ext[i] = NULL;
+    }
+}
+
+static void free_node(nfs_mem_node *n) {
+    while (n->children) {
+        nfs_mem_node *c = n->children;
+        n->children = c->next;
+        table_remove(c);
+        free_node(c);
+    }
+    drop_extents(n, 0);
+    free(n->ext);
+    free(n->key);
+    free(n);
+}
+
+int nfs_mem_init(const char *root, nfs_mem_notify_fn notify) {
+    char key[PATH_MAX];
+    nfs_path_normalize(root, key, sizeof(key));
+    notify_fn = notify;
+    if (!table) {
+        table = calloc(MEM_BUCKETS, sizeof(*table));
+        if (!table) return -1;
+        buckets = MEM_BUCKETS;
+    }
+    nfs_mem_node *n = find(key);
+    if (n) {
+        // la reincarcarea configuratiei exportul isi pastreaza continutul
+        if (n->parent) {
+            errno = EEXIST;
+            return -1;
+        }
+        return 0;
+    }
+
+    n = calloc(1, sizeof(*n));
+    if (!n || !(n->key = strdup(key))) {
+        free(n);
+        return -1;
+    }
+    n->name = n->key;
+    n->dir = 1;
+    n->ino = next_ino++;
+    touch(n);
+    table_grow();
+    table_insert(n);
+    root_count++;
+    return 0;
+}
+
+void nfs_mem_drop(const char *root) {
+    nfs_mem_node *n = nfs_mem_lookup(root);
+    if (!n || n->parent) return;
+    table_remove(n);
+    free_node(n);
+    root_count--;
+}
+
+int nfs_mem_enabled(void) {
+    return root_count > 0;
+}
+
+nfs_mem_node *nfs_mem_lookup(const char *path) {
+    char key[PATH_MAX];
+    nfs_path_normalize(path, key, sizeof(key));
+    nfs_mem_node *n = find(key);
+    if (!n) errno = ENOENT;
+    return n;
+}
+
+nfs_mem_node *nfs_mem_create(const char *path, int trunc) {
+    char key[PATH_MAX];
+    nfs_path_normalize(path, key, sizeof(key));
+    nfs_mem_node *n = find(key);
+    if (!n) return add_node(key, 0);
+    if (n->dir) {
+        errno = EISDIR;
+        return NULL;
+    }
+    if (trunc && n->size > 0) nfs_mem_truncate(n, 0);
+    return n;
+}
+
+ssize_t nfs_mem_pread(nfs_mem_node *n, void *buf, size_t len, off_t off) {
+    if (n->dir) {
+        errno = EISDIR;
+        return -1;
+    }
+    if (off < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (off >= n->size) return 0;
+    if ((off_t)len > n->size - off) len = (size_t)(n->size - off);
+
+    char *out = buf;
+    for (size_t done = 0; done < len; ) {
+        size_t i = (size_t)((off + done) / MEM_EXTENT);
+        size_t at = (size_t)((off + done) % MEM_EXTENT);
+        size_t step = MEM_EXTENT - at < len - done ? MEM_EXTENT - at : len - done;
+        if (i < n->ext_count && n->ext[i])
+            memcpy(out + done, n->ext[i] + at, step);
+        else
+            memset(out + done, 0, step);   // gaura
+        done += step;
+    }
+    return (ssize_t)len;
+}
+
+ssize_t nfs_mem_pwrite(nfs_mem_node *n, const void *buf, size_t len, off_t off) {
+    if (n->dir) {
+        errno = EISDIR;
+        return -1;
+    }
+    if (off < 0 || (uint64_t)off + len > (uint64_t)INT64_MAX / 2) {
+        errno = EFBIG;
+        return -1;
+    }
+    if (len == 0) return 0;
+
+    size_t need = (size_t)((off + len + MEM_EXTENT - 1) / MEM_EXTENT);
+    if (need > n->ext_count) {
+        size_t cap = n->ext_count ? n->ext_count : 4;
+        while (cap < need) cap *= 2;
+        char **grown = realloc(n->ext, cap * sizeof(*grown));
+        if (!grown) {
+            errno = ENOMEM;
+            return -1;
+        }
+        memset(grown + n->ext_count, 0, (cap - n->ext_count) * sizeof(*grown));
+        n->ext = grown;
+        n->ext_count = cap;
+    }
+
+    const char *in = buf;
+    for (size_t done = 0; done < len; ) {
+        size_t i = (size_t)((off + done) / MEM_EXTENT);
+        size_t at = (size_t)((off + done) % MEM_EXTENT);
+        size_t step = MEM_EXTENT - at < len - done ? MEM_EXTENT - at : len - done;
+        if (!n->ext[i]) {
+            if (!(n->ext[i] = calloc(1, MEM_EXTENT))) {
+                errno = ENOMEM;
+                return done ? (ssize_t)done : -1;
+            }
+            n->ext_used++;
+        }
+        memcpy(n->ext[i] + at, in + done, step);
+        done += step;
+    }
+    if (off + (off_t)len > n->size) n->size = off + (off_t)len;
+    touch(n);
+    emit(n, EV_MODIFY);
+    return (ssize_t)len;
+}
+
+int nfs_mem_truncate(nfs_mem_node *n, off_t size) {
+    if (n->dir) {
+        errno = EISDIR;
+        return -1;
+    }
+    if (size < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (size < n->size) {
+        // extenturile de dupa dispar, coada ultimului se zeroizeaza pt o extindere ulterioara
+        size_t keep = (size_t)((size + MEM_EXTENT - 1) / MEM_EXTENT);
+        drop_extents(n, keep);
+        if (size % MEM_EXTENT && keep <= n->ext_count && n->ext[keep - 1])
+            memset(n->ext[keep - 1] + size % MEM_EXTENT, 0, MEM_EXTENT - size % MEM_EXTENT);
+    }
+    n->size = size;
+    touch(n);
+    emit(n, EV_MODIFY);
+    return 0;
+}
+
+void nfs_mem_stat(const nfs_mem_node *n, struct stat *st) {
+    memset(st, 0, sizeof(*st));
+    st->st_ino = n->ino;
+    st->st_mode = n->dir ? (S_IFDIR | 0777) : (S_IFREG | 0666);
+    st->st_nlink = 1;
+    st->st_size = n->dir ? 0 : n->size;
+    st->st_blksize = MEM_EXTENT;
+    st->st_blocks = (blkcnt_t)(n->ext_used * (MEM_EXTENT / 512));
+    st->st_mtim = n->mtime;
+    st->st_ctim = n->mtime;
+    st->st_atim = n->mtime;
+}
+
+int nfs_mem_next_data(const nfs_mem_node *n, off_t pos, off_t *start, off_t *end) {
+    size_t i = (size_t)(pos / MEM_EXTENT);
+    while (i < n->ext_count && !n->ext[i]) i++;
+    off_t data = (off_t)i * MEM_EXTENT;
+    if (data < pos) data = pos;
+    if (i >= n->ext_count || data >= n->size) return 0;
+
+    size_t j = i;
+    while (j < n->ext_count && n->ext[j]) j++;
+    off_t hole = (off_t)j * MEM_EXTENT;
+    *start = data;
+    *end = hole < n->size ? hole : n->size;
+    return 1;
+}
+
+int nfs_mem_mkdir(const char *path) {
+    char key[PATH_MAX];
+    nfs_path_normalize(path, key, sizeof(key));
+    if (find(key)) {
+        errno = EEXIST;
+        return -1;
+    }
+    return add_node(key, 1) ? 0 : -1;
+}
+
+int nfs_mem_remove(const char *path, int recursive) {
+    nfs_mem_node *n = nfs_mem_lookup(path);
+    if (!n) return -1;
+    if (!n->parent) {
+        errno = EBUSY;
+        return -1;
+    }
+    if (n->children && !recursive) {
+        errno = ENOTEMPTY;
+        return -1;
+    }
+
+    emit(n, EV_DELETE);
+    nfs_mem_node *parent = n->parent;
+    if (n->prev) n->prev->next = n->next;
+    else parent->children = n->next;
+    if (n->next) n->next->prev = n->prev;
+    touch(parent);
+    table_remove(n);
+    free_node(n);
+    return 0;
+}
+
+int nfs_mem_readdir(const char *path, int (*fn)(const char *name, const struct stat *st, void *ctx),
+                    void *ctx) {
+    nfs_mem_node *dir = nfs_mem_lookup(path);
+    if (!dir) return -1;
+    if (!dir->dir) {
+        errno = ENOTDIR;
+        return -1;
+    }
+    for (nfs_mem_node *c = dir->children; c; c = c->next) {
+        struct stat st;
+        nfs_mem_stat(c, &st);
+        if (fn(c->name, &st, ctx) != 0) break;
+    }
+    return 0;
+}
+
+static void walk_node(const nfs_mem_node *dir, const char *rel, nfs_walk_fn visit, void *ctx) {
+    for (const nfs_mem_node *c = dir->children; c; c = c->next) {
+        char child[PATH_MAX];
+        int n = *rel ? snprintf(child, sizeof(child), "%s/%s", rel, c->name)
+                     : snprintf(child, sizeof(child), "%s", c->name);
+        if (n < 0 || (size_t)n >= sizeof(child)) continue;
+
+        struct stat st;
+        nfs_mem_stat(c, &st);
+        if (visit(child, &st, ctx) == 0 && c->dir)
+            walk_node(c, child, visit, ctx);
+    }
+}
+
+int nfs_mem_walk(const char *root, nfs_walk_fn visit, void *ctx) {
+    nfs_mem_node *dir = nfs_mem_lookup(root);
+    if (!dir) return -1;
+    if (!dir->dir) {
+        errno = ENOTDIR;
+        return -1;
+    }
+    walk_node(dir, "", visit, ctx);
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef NFS_MEM_H
+#define NFS_MEM_H
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "nfs_walk.h"
+
+// exporturile tinute doar in memorie (engine=mem sau serverul pornit cu -m): caile
+// normalizate sunt cheile unei tabele hash, iar un fisier e un vector de
+// extenturi de MEM_EXTENT bytes alocate la prima scriere, NULL = gaura.
+// Erorile se intorc ca la apelurile POSIX, cu -1 / NULL si errno
+
+#define MEM_EXTENT (64 * 1024)
+#define MEM_BUCKETS 1024        // dimensiunea initiala a tabelei, se dubleaza
+
+typedef struct mem_node nfs_mem_node;
+
+// pt watch: un director (dupa inode) s-a schimbat; type e EV_*
+typedef void (*nfs_mem_notify_fn)(ino_t dir, int type, const char *name);
+
+// adauga o radacina (un export in memorie, calea ca in make_path); se poate
+// apela pt mai multe radacini, iar pt una existenta nu schimba nimic
+int nfs_mem_init(const char *root, nfs_mem_notify_fn notify);
+
+// sterge o radacina cu tot continutul ei
+void nfs_mem_drop(const char *root);
+
+// exista macar o radacina
+int nfs_mem_enabled(void);
+
+nfs_mem_node *nfs_mem_lookup(const char *path);
+
+// fisier nou sau existent; trunc il goleste. EISDIR pt un director
+nfs_mem_node *nfs_mem_create(const char *path, int trunc);
+
+ssize_t nfs_mem_pread(nfs_mem_node *n, void *buf, size_t len, off_t off);
+ssize_t nfs_mem_pwrite(nfs_mem_node *n, const void *buf, size_t len, off_t off);
+int nfs_mem_truncate(nfs_mem_node *n, off_t size);
+void nfs_mem_stat(const nfs_mem_node *n, struct stat *st);
+
+// prima zona cu date de la pos incolo, ca SEEK_DATA / SEEK_HOLE; 0 daca nu mai sunt
+int nfs_mem_next_data(const nfs_mem_node *n, off_t pos, off_t *start, off_t *end);
+
+int nfs_mem_mkdir(const char *path);
+
+// fisier sau director gol; cu recursive, tot subarborele
+int nfs_mem_remove(const char *path, int recursive);
+
+// fn pt fiecare intrare din director; nonzero din fn opreste listarea
+int nfs_mem_readdir(const char *path, int (*fn)(const char *name, const struct stat *st, void *ctx),
+                    void *ctx);
+
+// ca nfs_walk, in ordinea din director
+int nfs_mem_walk(const char *root, nfs_walk_fn visit, void *ctx);
+
+#endif
@@ -0,0 +1,92 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <rpc/rpc.h>
+#include "nfs.h"
+#include "nfs_pool.h"
+
+static CLIENT *pool[MAX_POOL];
+static char addrs[MAX_POOL_ADDRS][256];
+static CLIENT *seeds[MAX_POOL_ADDRS];   // primul handle catre fiecare adresa
+static int addr_count = 0;
+
+// serverul ocupat raspunde cu BUSY_MARK fara sa execute cererea (vezi
+// nfs_sched.h); se reincearca dupa o pauza aleatoare intre jumatate si toata
+// valoarea curenta, dublata la fiecare incercare
+#define BUSY_RETRIES 8
+#define BUSY_BASE_MS 50
+#define BUSY_MAX_MS 2000
+
+int nfs_busy_wait(CLIENT *clnt, int *attempt) {
+    struct rpc_err err;
+    clnt_geterr(clnt, &err);
+    if (err.re_status != RPC_VERSMISMATCH || err.re_vers.low != BUSY_MARK ||
+        err.re_vers.high != BUSY_MARK || *attempt >= BUSY_RETRIES)
+        return 0;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    // fire diferite pe handle-uri diferite nu se sincronizeaza
+    unsigned seed = (unsigned)now.tv_nsec ^ (unsigned)(uintptr_t)clnt;
+    u_int delay = BUSY_BASE_MS << *attempt;
+    if (delay > BUSY_MAX_MS) delay = BUSY_MAX_MS;
+    u_int ms = delay / 2 + (u_int)rand_r(&seed) % (delay / 2 + 1);
+    struct timespec pause = { ms / 1000, (long)(ms % 1000) * 1000000 };
+    while (nanosleep(&pause, &pause) != 0)
+        ;
+    (*attempt)++;
+    return 1;
+}
+
+int nfs_pool_init(const char *servers, CLIENT *main_clnt) {
+    char buf[MAX_POOL_ADDRS * 256];
+    snprintf(buf, sizeof(buf), "%s", servers);
+    addr_count = 0;
+    for (char *host = strtok(buf, ","); host && addr_count < MAX_POOL_ADDRS; host = strtok(NULL, ","))
+        snprintf(addrs[addr_count++], sizeof(addrs[0]), "%s", host);
+    if (addr_count == 0) return -1;
+    pool[0] = main_clnt;
+    seeds[0] = main_clnt;
+    return 0;
+}
+
+CLIENT *nfs_pool_clone(CLIENT *clnt) {
+    struct netbuf addr;
+    struct netconfig *nconf = getnetconfigent("udp");
+    CLIENT *copy = NULL;
+    if (nconf && clnt_control(clnt, CLGET_SVC_ADDR, (char *)&addr))
+        copy = clnt_tli_create(RPC_ANYFD, nconf, &addr, NFS_PROGRAM, NFS_VERSION_1, 0, 0);
+    if (nconf) freenetconfigent(nconf);
+    return copy;
+}
+
+CLIENT *nfs_pool_get(int i) {
+    if (i < 0 || i >= MAX_POOL || addr_count == 0) return NULL;
+    if (pool[i]) return pool[i];
+
+    int a = i % addr_count;
+    if (!seeds[a]) {
+        // adresa noua: o singura cautare prin rpcbind, restul sunt copii
+        seeds[a] = clnt_create(addrs[a], NFS_PROGRAM, NFS_VERSION_1, "udp");
+        if (!seeds[a]) {
+            clnt_pcreateerror(addrs[a]);
+            return NULL;
+        }
+        pool[i] = seeds[a];
+    } else {
+        pool[i] = nfs_pool_clone(seeds[a]);
+    }
+    return pool[i];
+}
+
+void nfs_pool_destroy(void) {
+    // pool[0] e al apelantului
+    for (int i = 1; i < MAX_POOL; i++) {
+        if (pool[i]) clnt_destroy(pool[i]);
+        pool[i] = NULL;
+    }
+    memset(seeds, 0, sizeof(seeds));
+    addr_count = 0;
+}
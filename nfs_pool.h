@@ -0,0 +1,37 @@
+#ifndef NFS_POOL_H
+#define NFS_POOL_H
+
+#include <rpc/rpc.h>
+
+// conexiuni suplimentare catre server, pt transferurile impartite pe mai multe
+// fire; fiecare handle e folosit de un singur fir odata. Cu mai multe adrese
+// (server multi-homed), handle-urile se impart pe rand intre ele
+
+#define MAX_POOL 8
+#define MAX_POOL_ADDRS 4
+
+// servers: adresele separate prin virgula; main_clnt e conectat la prima
+int nfs_pool_init(const char *servers, CLIENT *main_clnt);
+
+// handle nou catre aceeasi adresa ca clnt, fara o noua cautare prin rpcbind
+CLIENT *nfs_pool_clone(CLIENT *clnt);
+
+// handle-ul i (0 = cel principal), creat la prima cerere; NULL daca nu se poate
+CLIENT *nfs_pool_get(int i);
+
+void nfs_pool_destroy(void);
+
+// dupa un apel esuat pe clnt: 1 daca serverul ocupat l-a respins fara sa-l
+// execute si s-a asteptat pauza dinaintea reincercarii attempt (de la 0)
+int nfs_busy_wait(CLIENT *clnt, int *attempt);
+
+// apelul generat call (*_1), reluat cat timp serverul il respinge ca ocupat;
+// alte erori, inclusiv SYSTEM_ERR, ajung la apelant ca inainte
+#define BUSY_RETRY(clnt, call) __extension__ ({                             \
+    int busy_attempt_ = 0;                                                  \
+    __typeof__(call) busy_res_;                                             \
+    while (!(busy_res_ = (call)) && nfs_busy_wait((clnt), &busy_attempt_))  \
+        ;                                                                   \
+    busy_res_; })
+
+#endif
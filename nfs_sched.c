@@ -0,0 +1,632 @@
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include "nfs.h"
+#include "nfs_sched.h"
+#include "nfs_trace.h"
+#include "nfs_xdr_fast.h"
+
+#define SCHED_MIN_COST 512          // costul unei cereri mici, in bytes
+#define SCHED_SCAN_COST (64 << 10)  // sume, semnaturi, find, du: citesc fisiere / parcurg arbori
+#define SCHED_RECV_BATCH 256        // datagrame citite pe apel, ca sa nu se blocheze executia
+#define SCHED_IDLE 60               // secunde dupa care un client fara cereri se uita
+#define SCHED_TARGET 0.05           // CoDel: cat poate sta o cerere in coada, in secunde
+#define SCHED_INTERVAL 0.5          // ... si cat timp poate fi depasit inainte de respingeri
+
+typedef struct sched_req {
+    struct sched_req *next;
+    double tag;                 // timpul virtual de terminare (WFQ)
+    u_int cost;
+    u_int len;
+    int lane;
+    double arrived;             // CLOCK_MONOTONIC, pt timpul petrecut in coada
+    uint64_t recv, recv_dur;    // pt nfs_trace
+    char buf[];
+} sched_req;
+
+typedef struct {
+    sched_req *head, *tail;
+} sched_queue;
+
+enum { LANE_META, LANE_BULK, LANE_COUNT };
+
+typedef struct sched_client {
+    char host[INET6_ADDRSTRLEN];    // cheia: adresa, fara port
+    sched_queue lanes[LANE_COUNT];
+    u_int queued;
+    double last_tag;
+    int weight;
+    double rate, iops;              // 0 = fara limita
+    double bytes, ops;              // token bucket-urile
+    struct timespec refilled;
+    time_t last_seen;
+    struct sched_client *next;
+} sched_client;
+
+typedef struct {
+    char host[INET6_ADDRSTRLEN];    // "*" = oricare
+    int weight;
+    double rate, iops;
+} qos_rule;
+
+static qos_rule rules[MAX_QOS_RULES];
+static int rule_count = 0;
+
+static int sched_sock = -1;
+static void (*sched_dispatch)(struct svc_req *, SVCXPRT *);
+static sched_client *clients = NULL;
+static double vtime = 0;            // tag-ul ultimei cereri executate
+static u_int lane_queued[LANE_COUNT];
+static u_int total_queued = 0;
+
+// CoDel pe fiecare coada: cat timp cererile asteapta peste SCHED_TARGET un
+// interval intreg, se respinge cate una, tot mai des (interval / sqrt(count)),
+// pana cand asteptarea scade sub tinta
+typedef struct {
+    double above_until;         // 0 = sub tinta
+    int dropping;
+    double drop_next;
+    u_int count;
+    u_long rejected;
+} codel_state;
+
+static codel_state codel[LANE_COUNT];
+static const char *lane_names[LANE_COUNT] = { "metadata", "transfer" };
+static u_long full_rejected = 0;    // respinse la sosire, cu cozile pline
+static time_t full_reported = 0;
+
+// adresele cererilor: fiecare datagrama retine si de unde a venit
+typedef struct {
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+} sched_from;
+
+static sched_from *from_of(sched_req *r) {
+    return (sched_from *)(r->buf + ((r->len + 7) & ~7u));
+}
+
+// transportul prin care procedurile raspund unei cereri din coada: ca svc_dg,
+// dar argumentele se decodeaza din datagrama salvata, iar raspunsul pleaca
+// pe socket-ul serverului la adresa ei
+static sched_req *current;
+static u_int current_args;          // pozitia argumentelor in datagrama
+static char reply_buf[UDPMSGSIZE];
+
+static bool_t deferred_recv(SVCXPRT *xprt, struct rpc_msg *msg) {
+    (void)xprt;
+    (void)msg;
+    return FALSE;
+}
+
+static enum xprt_stat deferred_stat(SVCXPRT *xprt) {
+    (void)xprt;
+    return XPRT_IDLE;
+}
+
+static bool_t deferred_getargs(SVCXPRT *xprt, xdrproc_t proc, void *args) {
+    (void)xprt;
+    XDR x;
+    uint64_t start = nfs_trace_enabled() ? nfs_trace_now() : 0;
+    xdrmem_create(&x, current->buf + current_args, current->len - current_args, XDR_DECODE);
+    bool_t ok = proc(&x, args);
+    if (start) nfs_trace_stage(TRACE_DECODE, start, nfs_trace_now());
+    return ok;
+}
+
+static bool_t deferred_freeargs(SVCXPRT *xprt, xdrproc_t proc, void *args) {
+    (void)xprt;
+    XDR x;
+    x.x_op = XDR_FREE;
+    return proc(&x, args);
+}
+
+static bool_t deferred_reply(SVCXPRT *xprt, struct rpc_msg *msg) {
+    (void)xprt;
+    XDR x;
+    memcpy(&msg->rm_xid, current->buf, sizeof(msg->rm_xid));
+    msg->rm_xid = ntohl(msg->rm_xid);
+    uint64_t start = nfs_trace_enabled() ? nfs_trace_now() : 0;
+    xdrmem_create(&x, reply_buf, sizeof(reply_buf), XDR_ENCODE);
+    if (!xdr_replymsg(&x, msg)) return FALSE;
+    uint64_t encoded = start ? nfs_trace_now() : 0;
+    sched_from *f = from_of(current);
+    ssize_t sent = sendto(sched_sock, reply_buf, xdr_getpos(&x), 0, (struct sockaddr *)&f->addr,
+                          f->addrlen);
+    if (start) {
+        nfs_trace_stage(TRACE_ENCODE, start, encoded);
+        nfs_trace_stage(TRACE_SEND, encoded, nfs_trace_now());
+        if (sent > 0) nfs_trace_bytes_out((uint32_t)sent);
+    }
+    return sent == (ssize_t)xdr_getpos(&x);
+}
+
+static void deferred_destroy(SVCXPRT *xprt) {
+    (void)xprt;
+}
+
+static const struct xp_ops deferred_ops = {
+    deferred_recv, deferred_stat, deferred_getargs, deferred_reply,
+    deferred_freeargs, deferred_destroy
+};
+
+static SVCXPRT deferred;
+
+static double now_sec(const struct timespec *ts) {
+    return (double)ts->tv_sec + (double)ts->tv_nsec / 1e9;
+}
+
+static void apply_rules(sched_client *c) {
+    const qos_rule *match = NULL;
+    for (int i = 0; i < rule_count; i++) {
+        if (strcmp(rules[i].host, c->host) == 0) {
+            match = &rules[i];
+            break;
+        }
+        if (!match && strcmp(rules[i].host, "*") == 0) match = &rules[i];
+    }
+    c->weight = match ? match->weight : 1;
+    c->rate = match ? match->rate : 0;
+    c->iops = match ? match->iops : 0;
+    // o limita noua porneste cu bucket-ul plin
+    c->bytes = c->rate;
+    c->ops = c->iops;
+}
+
+static void refill(sched_client *c, const struct timespec *now) {
+    double dt = now_sec(now) - now_sec(&c->refilled);
+    c->refilled = *now;
+    if (dt <= 0) return;
+    if (c->rate) {
+        c->bytes += c->rate * dt;
+        if (c->bytes > c->rate) c->bytes = c->rate;
+    }
+    if (c->iops) {
+        c->ops += c->iops * dt;
+        if (c->ops > c->iops) c->ops = c->iops;
+    }
+}
+
+// secundele pana cand clientul are voie la urmatoarea cerere din lane; 0 = acum.
+// Limita de bytes e doar pt transferuri, cea de cereri pt toate
+static double blocked_for(const sched_client *c, int lane) {
+    double wait = 0;
+    if (lane == LANE_BULK && c->rate && c->bytes <= 0) wait = (1 - c->bytes) / c->rate;
+    if (c->iops && c->ops < 1) {
+        double w = (1 - c->ops) / c->iops;
+        if (w > wait) wait = w;
+    }
+    return wait;
+}
+
+static sched_client *client_for(const struct sockaddr_storage *addr, time_t now) {
+    char host[INET6_ADDRSTRLEN] = "?";
+    if (addr->ss_family == AF_INET)
+        inet_ntop(AF_INET, &((const struct sockaddr_in *)addr)->sin_addr, host, sizeof(host));
+    else if (addr->ss_family == AF_INET6)
+        inet_ntop(AF_INET6, &((const struct sockaddr_in6 *)addr)->sin6_addr, host, sizeof(host));
+
+    sched_client *c;
+    for (c = clients; c; c = c->next)
+        if (strcmp(c->host, host) == 0) break;
+    if (!c) {
+        c = calloc(1, sizeof(*c));
+        if (!c) return NULL;
+        snprintf(c->host, sizeof(c->host), "%s", host);
+        clock_gettime(CLOCK_MONOTONIC, &c->refilled);
+        apply_rules(c);
+        c->next = clients;
+        clients = c;
+    }
+    c->last_seen = now;
+    return c;
+}
+
+// clientii plecati nu mai raman in lista
+static void sweep(time_t now) {
+    for (sched_client **p = &clients; *p; ) {
+        sched_client *c = *p;
+        if (!c->queued && now - c->last_seen > SCHED_IDLE) {
+            *p = c->next;
+            free(c);
+        } else {
+            p = &c->next;
+        }
+    }
+}
+
+// procedura si pozitia argumentelor, din antetul apelului; -1 daca nu e un apel valid
+static int call_header(const char *buf, u_int len, u_int *proc, u_int *args) {
+    uint32_t w[8];
+    if (len < sizeof(w)) return -1;
+    memcpy(w, buf, sizeof(w));
+    // xid, CALL, versiunea RPC, program, versiune, procedura, credentiale
+    if (ntohl(w[1]) != CALL) return -1;
+    *proc = ntohl(w[5]);
+    u_int pos = 8 * 4 + ((ntohl(w[7]) + 3) & ~3u);
+    uint32_t verf_len;
+    if (ntohl(w[7]) > MAX_AUTH_BYTES || pos + 8 > len) return -1;
+    memcpy(&verf_len, buf + pos + 4, 4);
+    verf_len = ntohl(verf_len);
+    if (verf_len > MAX_AUTH_BYTES) return -1;
+    *args = pos + 8 + ((verf_len + 3) & ~3u);
+    return *args <= len ? 0 : -1;
+}
+
+// ce muta date merge in coada a doua; costul aproximeaza bytes cititi sau scrisi
+static int classify(const char *buf, u_int len, u_int *cost) {
+    u_int proc, args;
+    *cost = len < SCHED_MIN_COST ? SCHED_MIN_COST : len;
+    if (call_header(buf, len, &proc, &args) != 0) return LANE_META;
+
+    switch (proc) {
+    case retrieve_file:
+    case mynfs_read: {
+        request req;
+        XDR x;
+        memset(&req, 0, sizeof(req));
+        xdrmem_create(&x, (char *)buf + args, len - args, XDR_DECODE);
+        if (xdr_request_fast(&x, &req) && req.size > *cost) *cost = req.size;
+        xdr_free((xdrproc_t)xdr_request_fast, (char *)&req);
+        return LANE_BULK;
+    }
+    case mynfs_bulk_read:
+        *cost = MAX_XFER_SIZE;
+        return LANE_BULK;
+    case mynfs_signatures:
+    case mynfs_checksum:
+    case mynfs_find:
+    case mynfs_du:
+        *cost = SCHED_SCAN_COST;
+        return LANE_BULK;
+    case send_file:
+    case mynfs_write:
+    case mynfs_has_chunks:
+    case mynfs_put_chunk:
+    case mynfs_put_manifest:
+        return LANE_BULK;
+    default:
+        return LANE_META;
+    }
+}
+
+int nfs_sched_init(SVCXPRT *transp, void (*dispatch)(struct svc_req *, SVCXPRT *)) {
+    int flags = fcntl(transp->xp_fd, F_GETFL);
+    if (flags < 0 || fcntl(transp->xp_fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+        perror("nfs_sched_init");
+        return -1;
+    }
+    sched_sock = transp->xp_fd;
+    sched_dispatch = dispatch;
+    // aceleasi date ca transportul UDP; xp_p3 tine starea de autentificare
+    // a bibliotecii, iar transportul real nu mai primeste cereri
+    deferred = *transp;
+    deferred.xp_ops = &deferred_ops;
+    deferred.xp_p1 = deferred.xp_p2 = NULL;
+    return 0;
+}
+
+static int parse_rate(const char *s, double *out) {
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || v < 0) return -1;
+    if (*end == 'k' || *end == 'K') v *= 1024, end++;
+    else if (*end == 'm' || *end == 'M') v *= 1024 * 1024, end++;
+    else if (*end == 'g' || *end == 'G') v *= 1024.0 * 1024 * 1024, end++;
+    if (*end) return -1;
+    *out = v;
+    return 0;
+}
+
+int nfs_sched_load(const char *file) {
+    FILE *f = fopen(file, "r");
+    if (!f) {
+        fprintf(stderr, "Error: cannot open %s: %s\n", file, strerror(errno));
+        return -1;
+    }
+
+    qos_rule table[MAX_QOS_RULES];
+    int count = 0, lineno = 0, ret = 0;
+    char line[512];
+    while (ret == 0 && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *save;
+        char *host = strtok_r(line, " \t\r\n", &save);
+        if (!host) continue;
+        struct in6_addr ignored;
+        if (count == MAX_QOS_RULES ||
+            (strcmp(host, "*") != 0 && inet_pton(AF_INET, host, &ignored) != 1 &&
+             inet_pton(AF_INET6, host, &ignored) != 1)) {
+            fprintf(stderr, "%s:%d: too many rules or bad client %s\n", file, lineno, host);
+            ret = -1;
+            break;
+        }
+
+        qos_rule *r = &table[count++];
+        memset(r, 0, sizeof(*r));
+        snprintf(r->host, sizeof(r->host), "%s", host);
+        r->weight = 1;
+        for (char *opt; ret == 0 && (opt = strtok_r(NULL, " \t\r\n", &save)); ) {
+            char *end;
+            if (strncmp(opt, "weight=", 7) == 0) {
+                long w = strtol(opt + 7, &end, 10);
+                if (*end || end == opt + 7 || w < 1 || w > 100) ret = -1;
+                else r->weight = (int)w;
+            } else if (strncmp(opt, "rate=", 5) == 0) {
+                ret = parse_rate(opt + 5, &r->rate);
+            } else if (strncmp(opt, "iops=", 5) == 0) {
+                ret = parse_rate(opt + 5, &r->iops);
+            } else {
+                ret = -1;
+            }
+            if (ret != 0) fprintf(stderr, "%s:%d: bad option %s\n", file, lineno, opt);
+        }
+    }
+    fclose(f);
+    if (ret != 0) return -1;
+
+    memcpy(rules, table, count * sizeof(*table));
+    rule_count = count;
+    for (sched_client *c = clients; c; c = c->next) apply_rules(c);
+    for (int i = 0; i < rule_count; i++) {
+        printf("QoS %s: weight %d", rules[i].host, rules[i].weight);
+        if (rules[i].rate) printf(", %.0f B/s", rules[i].rate);
+        if (rules[i].iops) printf(", %.0f requests/s", rules[i].iops);
+        printf("\n");
+    }
+    return 0;
+}
+
+// inregistrarea lui r in nfs_trace; dequeued = cand a iesit din coada, 0 daca n-a intrat
+static void trace_begin(sched_req *r, uint64_t dequeued) {
+    if (!r->recv) return;
+    uint32_t xid;
+    u_int proc = 0, args;
+    memcpy(&xid, r->buf, sizeof(xid));
+    if (call_header(r->buf, r->len, &proc, &args) != 0) proc = 0;
+    nfs_trace_begin(ntohl(xid), proc, r->lane, &from_of(r)->addr, r->recv, r->recv_dur, r->len);
+    if (dequeued) nfs_trace_stage(TRACE_QUEUE, r->recv + r->recv_dur, dequeued);
+}
+
+// raspunsurile pt r pleaca la adresa de unde a venit
+static void reply_to(sched_req *r) {
+    current = r;
+    sched_from *f = from_of(r);
+    memcpy(&deferred.xp_raddr, &f->addr,
+           f->addrlen < sizeof(deferred.xp_raddr) ? f->addrlen : sizeof(deferred.xp_raddr));
+    deferred.xp_addrlen = (int)f->addrlen;
+    deferred.xp_rtaddr.buf = &f->addr;
+    deferred.xp_rtaddr.len = deferred.xp_rtaddr.maxlen = f->addrlen;
+    deferred.xp_verf = _null_auth;
+}
+
+// "ocupat, incearca mai tarziu", fara sa execute nimic. Rezultatele difera de
+// la o procedura la alta, deci semnalul e la nivel RPC. SYSTEM_ERR nu merge:
+// il da si o procedura deja executata; RPC_MISMATCH cu BUSY_MARK (nfs.x) nu
+// poate veni decat de aici, iar clientul il reincearca dupa o pauza
+static void reject(sched_req *r) {
+    u_int proc, args;
+    if (call_header(r->buf, r->len, &proc, &args) != 0) return;
+    reply_to(r);
+    struct rpc_msg rply;
+    rply.rm_direction = REPLY;
+    rply.rm_reply.rp_stat = MSG_DENIED;
+    rply.rjcted_rply.rj_stat = RPC_MISMATCH;
+    rply.rjcted_rply.rj_vers.low = BUSY_MARK;
+    rply.rjcted_rply.rj_vers.high = BUSY_MARK;
+    SVC_REPLY(&deferred, &rply);
+    current = NULL;
+}
+
+void nfs_sched_receive(void) {
+    static char buf[UDPMSGSIZE];
+    time_t now = time(NULL);
+    for (int i = 0; i < SCHED_RECV_BATCH; i++) {
+        sched_from from;
+        from.addrlen = sizeof(from.addr);
+        uint64_t recv = nfs_trace_enabled() ? nfs_trace_now() : 0;
+        ssize_t len = recvfrom(sched_sock, buf, sizeof(buf), 0, (struct sockaddr *)&from.addr,
+                               &from.addrlen);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("nfs_sched_receive");
+            break;
+        }
+        if (len < 4 * (ssize_t)sizeof(uint32_t)) continue;   // ca svc_dg: nu e un apel
+
+        sched_client *c = client_for(&from.addr, now);
+        if (!c) continue;
+
+        u_int size = ((u_int)len + 7) & ~7u;
+        sched_req *r = malloc(sizeof(*r) + size + sizeof(sched_from));
+        if (!r) continue;
+        r->next = NULL;
+        r->len = (u_int)len;
+        memcpy(r->buf, buf, (size_t)len);
+        *from_of(r) = from;
+        r->recv = recv;
+        r->recv_dur = recv ? nfs_trace_now() - recv : 0;
+        r->lane = classify(r->buf, r->len, &r->cost);
+        if (c->queued >= SCHED_QUEUE_MAX || total_queued >= SCHED_TOTAL_MAX) {
+            trace_begin(r, 0);
+            reject(r);
+            nfs_trace_end(TRACE_REJECTED);
+            free(r);
+            full_rejected++;
+            continue;
+        }
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        r->arrived = now_sec(&ts);
+        int lane = r->lane;
+        // SCFQ: clientul continua de unde a ramas, dar nu din urma serverului
+        double start = c->last_tag > vtime ? c->last_tag : vtime;
+        r->tag = c->last_tag = start + (double)r->cost / c->weight;
+
+        sched_queue *q = &c->lanes[lane];
+        if (q->tail) q->tail->next = r;
+        else q->head = r;
+        q->tail = r;
+        c->queued++;
+        lane_queued[lane]++;
+        total_queued++;
+    }
+    sweep(now);
+    if (full_rejected && now != full_reported) {
+        fprintf(stderr, "Queues full: %lu requests rejected\n", full_rejected);
+        full_rejected = 0;
+        full_reported = now;
+    }
+}
+
+static void run(sched_req *r) {
+    char cred_area[3 * MAX_AUTH_BYTES];
+    struct rpc_msg msg;
+    struct svc_req req;
+    XDR x;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&req, 0, sizeof(req));
+    msg.rm_call.cb_cred.oa_base = cred_area;
+    msg.rm_call.cb_verf.oa_base = cred_area + MAX_AUTH_BYTES;
+    req.rq_clntcred = cred_area + 2 * MAX_AUTH_BYTES;
+    xdrmem_create(&x, r->buf, r->len, XDR_DECODE);
+    if (!xdr_callmsg(&x, &msg)) return;     // ca svc_dg: fara raspuns
+
+    reply_to(r);
+    current_args = xdr_getpos(&x);
+
+    req.rq_xprt = &deferred;
+    req.rq_prog = msg.rm_call.cb_prog;
+    req.rq_vers = msg.rm_call.cb_vers;
+    req.rq_proc = msg.rm_call.cb_proc;
+    req.rq_cred = msg.rm_call.cb_cred;
+
+    enum auth_stat why = _authenticate(&req, &msg);
+    if (why != AUTH_OK)
+        svcerr_auth(&deferred, why);
+    else if (req.rq_prog != NFS_PROGRAM)
+        svcerr_noprog(&deferred);
+    else if (req.rq_vers != NFS_VERSION_1)
+        svcerr_progvers(&deferred, NFS_VERSION_1, NFS_VERSION_1);
+    else {
+        uint64_t start = nfs_trace_enabled() ? nfs_trace_now() : 0;
+        sched_dispatch(&req, &deferred);
+        if (start) nfs_trace_stage(TRACE_HANDLER, start, nfs_trace_now());
+    }
+    current = NULL;
+}
+
+// daca cererea scoasa acum din lane trebuie respinsa (RFC 8289, fara
+// pragul de bytes: coada goala inseamna sub tinta)
+static int overloaded(int lane, double sojourn, double now) {
+    codel_state *q = &codel[lane];
+    int above = 0;
+    if (sojourn < SCHED_TARGET || lane_queued[lane] == 0) {
+        q->above_until = 0;
+    } else if (q->above_until == 0) {
+        q->above_until = now + SCHED_INTERVAL;
+    } else if (now >= q->above_until) {
+        above = 1;
+    }
+
+    if (q->dropping) {
+        if (!above) {
+            q->dropping = 0;
+            fprintf(stderr, "Load back to normal on %s queue: %lu requests rejected\n",
+                    lane_names[lane], q->rejected);
+            return 0;
+        }
+        if (now < q->drop_next) return 0;
+        q->count++;
+        q->drop_next += SCHED_INTERVAL / sqrt(q->count);
+        q->rejected++;
+        return 1;
+    }
+    if (!above) return 0;
+    // o suprasarcina care revine repede continua de unde a ramas
+    q->count = q->count > 2 && now - q->drop_next < 16 * SCHED_INTERVAL ? q->count - 2 : 1;
+    q->drop_next = now + SCHED_INTERVAL / sqrt(q->count);
+    q->dropping = 1;
+    q->rejected = 1;
+    fprintf(stderr, "Overloaded: %s requests wait %.0f ms, rejecting some\n",
+            lane_names[lane], sojourn * 1000);
+    return 1;
+}
+
+// cererea cu cel mai mic tag dintre clientii care au voie acum, intai din
+// coada de metadate; cu force limitele nu conteaza
+static int pick(int force) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    for (int lane = 0; lane < LANE_COUNT; lane++) {
+        sched_client *best = NULL;
+        for (sched_client *c = clients; c; c = c->next) {
+            sched_req *r = c->lanes[lane].head;
+            if (!r) continue;
+            refill(c, &now);
+            if (!force && blocked_for(c, lane) > 0) continue;
+            if (!best || r->tag < best->lanes[lane].head->tag) best = c;
+        }
+        if (!best) continue;
+
+        sched_queue *q = &best->lanes[lane];
+        sched_req *r = q->head;
+        q->head = r->next;
+        if (!q->head) q->tail = NULL;
+        best->queued--;
+        lane_queued[lane]--;
+        total_queued--;
+        if (r->tag > vtime) vtime = r->tag;
+        trace_begin(r, (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec);
+        // un client cu limite asteapta din cauza lor, nu a serverului
+        if (!force && !best->rate && !best->iops &&
+            overloaded(lane, now_sec(&now) - r->arrived, now_sec(&now))) {
+            reject(r);
+            nfs_trace_end(TRACE_REJECTED);
+            free(r);
+            return 1;
+        }
+        if (best->rate && lane == LANE_BULK) best->bytes -= r->cost;
+        if (best->iops) best->ops -= 1;
+        run(r);
+        nfs_trace_end(TRACE_DONE);
+        free(r);
+        return 1;
+    }
+    return 0;
+}
+
+int nfs_sched_dispatch(void) {
+    return pick(0);
+}
+
+long long nfs_sched_next_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double wait = -1;
+    for (sched_client *c = clients; c; c = c->next) {
+        if (!c->queued) continue;
+        refill(c, &now);
+        for (int lane = 0; lane < LANE_COUNT; lane++) {
+            if (!c->lanes[lane].head) continue;
+            double w = blocked_for(c, lane);
+            if (wait < 0 || w < wait) wait = w;
+        }
+    }
+    if (wait <= 0) return (long long)wait;
+    // in sus, ca la trezire bucket-ul sa aiba deja destul
+    return (long long)(wait * 1e9) + 1;
+}
+
+void nfs_sched_flush(void) {
+    while (pick(1))
+        ;
+}
@@ -0,0 +1,53 @@
+#ifndef NFS_SCHED_H
+#define NFS_SCHED_H
+
+#include <rpc/rpc.h>
+
+// planificator in fata procedurilor: cererile UDP se citesc din socket in
+// cozi per client (adresa IP), iar serverul le executa pe rand, cate una:
+// intai cele de metadate (list, chdir, mkdir, blocari...), apoi cele care
+// muta date, in ordinea weighted fair queuing (costul in bytes / weight).
+// Un download mare nu mai tine pe loc un list venit intre doua chunk-uri.
+//
+// Limitele per client vin dintr-un fisier (-q), recitit la SIGHUP:
+//
+//     # client     optiuni
+//     *            weight=1
+//     10.0.0.5     weight=4
+//     10.0.0.9     rate=2m iops=200
+//
+// weight = partea din server (1..100), rate = bytes/s transferati (sufixe
+// k, m, g; metadatele nu se numara), iops = cereri/s; "*" e pt clientii
+// nelistati. Un client peste limita asteapta in coada lui, fara sa-i
+// opreasca pe ceilalti.
+//
+// La suprasarcina cozile nu cresc la nesfarsit: cand sunt pline, sau cand
+// cererile stau in coada peste tinta (CoDel), o parte din ele primesc pe loc
+// un raspuns "ocupat" (BUSY_MARK, nfs.x) in loc sa fie executate, iar clientul
+// reincearca dupa o pauza aleatoare, in loc sa astepte timeout-ul
+
+#define SCHED_QUEUE_MAX 256     // cereri in asteptare per client
+#define SCHED_TOTAL_MAX 4096    // ... si in total; peste, cererile se resping pe loc
+#define MAX_QOS_RULES 64
+
+// preia socket-ul transportului UDP al serverului (devine neblocant);
+// dispatch e nfs_1
+int nfs_sched_init(SVCXPRT *transp, void (*dispatch)(struct svc_req *, SVCXPRT *));
+
+// citeste regulile; la eroare raman cele vechi
+int nfs_sched_load(const char *file);
+
+// muta in cozi datagramele sosite
+void nfs_sched_receive(void);
+
+// executa urmatoarea cerere eligibila; 0 daca nu e niciuna
+int nfs_sched_dispatch(void);
+
+// -1 daca nu asteapta nimic, 0 daca o cerere e gata, altfel nanosecundele
+// pana cand o limita lasa sa treaca urmatoarea cerere
+long long nfs_sched_next_ns(void);
+
+// executa tot ce e in cozi, fara limite (inainte de predarea la un restart)
+void nfs_sched_flush(void);
+
+#endif
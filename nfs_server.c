@@ -1,3 +1,4 @@
+#define _GNU_SOURCE   // SEEK_DATA / SEEK_HOLE
 #include <errno.h>
 #include <stddef.h>
 #include <stdio.h>    // pt snprintf
@@ -6,10 +7,36 @@
 #include <rpc/rpc.h>
 #include <sys/types.h>
 #include <sys/stat.h>
-#include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <poll.h>
+#include <regex.h>
+#include <signal.h>
 #include <limits.h>
+#include <sched.h>
+#include <time.h>
 #include <unistd.h>   // pt rmdir
+#include <linux/filter.h>
+#include <netinet/in.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
 #include "nfs.h"
+#include "nfs_cas.h"
+#include "nfs_compress.h"
+#include "nfs_crc32c.h"
+#include "nfs_du.h"
+#include "nfs_export.h"
+#include "nfs_handoff.h"
+#include "nfs_hash.h"
+#include "nfs_lock.h"
+#include "nfs_mem.h"
+#include "nfs_sched.h"
+#include "nfs_shm.h"
+#include "nfs_store.h"
+#include "nfs_trace.h"
+#include "nfs_walk.h"
+#include "nfs_watch.h"
+#include "nfs_xdr_fast.h"
 
 // folder partajat
 #define SHARED_DIR "./shared"
@@ -28,83 +55,326 @@
 #define MYNFS_REMDIR_PROC 7
 #define MYNFS_READ_PROC 8
 #define MYNFS_WRITE_PROC 9
-#define MYNFS_READDIR_PROC 11   
+#define MYNFS_READDIR_PROC 10
+#define MYNFS_BULK_READ_PROC 11
+#define MYNFS_EXTENTS_PROC 12
+#define MYNFS_TRUNCATE_PROC 13
+#define MYNFS_SIGNATURES_PROC 14
+#define MYNFS_CHECKSUM_PROC 15
+#define MYNFS_CODECS_PROC 16
+#define MYNFS_HAS_CHUNKS_PROC 17
+#define MYNFS_PUT_CHUNK_PROC 18
+#define MYNFS_PUT_MANIFEST_PROC 19
+#define MYNFS_LOCK_PROC 20
+#define MYNFS_UNLOCK_PROC 21
+#define MYNFS_LEASE_PROC 22
+#define MYNFS_RENEW_PROC 23
+#define MYNFS_WATCH_PROC 24
+#define MYNFS_LIST_PROC 25
+#define MYNFS_FIND_PROC 26
+#define MYNFS_DU_PROC 27
+#define MYNFS_GETATTR_PROC 28
+
+#define SIG_BLOCK_DEFAULT 4096
+#define SIG_BLOCK_MAX (64 * 1024)
+
+#define MAX_RAW_CHUNK (64 * 1024)   // limita pt un chunk decomprimat
+#define BULK_MIN_BYTES 512          // max_bytes mai mic nu lasa loc nici de antet si un nume
 
 #define MAX_FILENAME_LENGTH 128
-#define MAX_FILE_SIZE 1024
 
+
+// helper pt construirea caii de pe server: exportul ales de primul component
+static int make_path(char *path, size_t pathlen, const char *rel) {
+    if (!path || pathlen == 0) return -1;
+    return nfs_export_resolve(rel, path, pathlen);
+}
+
+
+// continutul unui director: numele se adauga la cursorul de scriere, fara
+// sa se recalculeze lungimea a tot ce s-a scris deja
 typedef struct {
-    char filename[MAX_FILENAME_LENGTH];
-    char data[MAX_FILE_SIZE];
-    int size;
-} File;
+    char *buf;          // nume terminate cu '\0', unul dupa altul
+    size_t len, cap;
+    size_t *offs;       // unde incepe fiecare nume in buf
+    u_int count, offs_cap;
+    int failed;         // o adaugare a esuat la citirea directorului
+} name_list;
+
+static void name_list_free(name_list *l) {
+    free(l->buf);
+    free(l->offs);
+    memset(l, 0, sizeof(*l));
+}
 
-File files[MAX_FILES];
-int file_count = 0;
+static int name_list_add(name_list *l, const char *name) {
+    size_t n = strlen(name) + 1;
+    if (l->len + n > l->cap) {
+        size_t cap = l->cap ? l->cap : 4096;
+        while (cap < l->len + n) cap *= 2;
+        char *grown = realloc(l->buf, cap);
+        if (!grown) return -1;
+        l->buf = grown;
+        l->cap = cap;
+    }
+    if (l->count == l->offs_cap) {
+        u_int cap = l->offs_cap ? l->offs_cap * 2 : 64;
+        size_t *grown = realloc(l->offs, cap * sizeof(*grown));
+        if (!grown) return -1;
+        l->offs = grown;
+        l->offs_cap = cap;
+    }
+    memcpy(l->buf + l->len, name, n);
+    l->offs[l->count++] = l->len;
+    l->len += n;
+    return 0;
+}
 
+static const char *sort_base;
+static int cmp_offs(const void *a, const void *b) {
+    return strcmp(sort_base + *(const size_t *)a, sort_base + *(const size_t *)b);
+}
 
-// helper pt construirea unui absolute path 
-static int make_path(char *path, size_t pathlen, const char *rel) {
-    if (!path || pathlen == 0) return -1;
-    if (!rel || !*rel || strcmp(rel, ".") == 0) {
-        // doar pentru SHARED_DIR
-        int n = snprintf(path, pathlen, "%s", SHARED_DIR);
-        if (n < 0 || (size_t)n >= pathlen) return -1;
-        return 0;
+static int name_list_visit(const char *name, const struct stat *st, void *ctx) {
+    name_list *l = ctx;
+    if (name_list_add(l, name) != 0) {
+        l->failed = 1;
+        return 1;
+    }
+    return 0;
+}
+
+static int name_list_read(name_list *l, const char *dir, int sorted) {
+    if (nfs_store_readdir(dir, name_list_visit, l) != 0 || l->failed) return -1;
+
+    if (sorted && l->count > 1) {
+        sort_base = l->buf;
+        qsort(l->offs, l->count, sizeof(*l->offs), cmp_offs);
     }
-    if (rel[0] == '/')
-        rel++;
-    int n = snprintf(path, pathlen, "%s/%s", SHARED_DIR, rel);
-    if (n < 0 || (size_t)n >= pathlen) return -1;
     return 0;
 }
 
+// numele [from, to) cu '\n' dupa fiecare, ca in raspunsul ls
+static char *name_list_join(const name_list *l, u_int from, u_int to) {
+    size_t size = 1;
+    for (u_int i = from; i < to; i++) size += strlen(l->buf + l->offs[i]) + 1;
+    char *out = malloc(size);
+    if (!out) return NULL;
+
+    char *cursor = out;
+    for (u_int i = from; i < to; i++) {
+        size_t n = strlen(l->buf + l->offs[i]);
+        memcpy(cursor, l->buf + l->offs[i], n);
+        cursor[n] = '\n';
+        cursor += n + 1;
+    }
+    *cursor = '\0';
+    return out;
+}
 
 // ls_1 scaneaza directorul cerut relativ la SHARED_DIR
 char **ls_1_svc(char **argp, struct svc_req *req) {
-    static char buffer[64 * 1024];   // buffer pentru listare
     static char *result;
+    static char *joined;
     char path[PATH_MAX];
 
+    free(joined);
+    joined = NULL;
+    result = NULL;
+
     // daca se primeste NULL sau sir gol, folosim .
     const char *sub = (argp && *argp && **argp) ? *argp : ".";
 
     // calea reala pe server cu make_path
     if (make_path(path, sizeof(path), sub) != 0) {
-        result = NULL;
         return &result;
     }
 
-    buffer[0] = '\0';
+    name_list list = {0};
+    if (name_list_read(&list, path, 0) == 0)   // director inexistent sau fara permisiuni
+        joined = name_list_join(&list, 0, list.count);
+    name_list_free(&list);
+
+    result = joined;
+    return &result;
+}
+
+// list_1_svc: ls pe pagini; paginile urmatoare folosesc listarea deja facuta
+// cat timp directorul nu s-a schimbat
+list_result *mynfs_list_1_svc(list_args *argp, struct svc_req *req) {
+    static list_result result;
+    static name_list cached;
+    static char cached_path[PATH_MAX];
+    static struct stat cached_st;
+    static int cached_sorted = -1;
+    char path[PATH_MAX];
+    struct stat st;
 
-    DIR *d = opendir(path);
-    if (!d) {             // director inexistent sau fara permisiuni
-        result = NULL;    
+    xdr_free((xdrproc_t)xdr_list_result, (caddr_t)&result);
+    memset(&result, 0, sizeof(result));
+    if (argp == NULL || argp->dirname == NULL ||
+        make_path(path, sizeof(path), *argp->dirname ? argp->dirname : ".") != 0 ||
+        nfs_store_stat(path, &st) != 0) {
+        result.status = -1;
         return &result;
     }
 
-    struct dirent *dir;
-    while ((dir = readdir(d)) != NULL) {
-        if (strcmp(dir->d_name, ".") == 0 || strcmp(dir->d_name, "..") == 0)
-            continue;
-
-        size_t used = strlen(buffer);
-        size_t freeb = sizeof(buffer) - used - 2; // 1 pt '\n' + 1 pt '\0'
-        if (freeb == 0) break;
+    // cookie 0 = listare noua; altfel se reia doar daca directorul s-a schimbat
+    int stale = argp->cookie == 0 || cached_sorted != argp->sorted ||
+                strcmp(cached_path, path) != 0 || cached_st.st_dev != st.st_dev ||
+                cached_st.st_ino != st.st_ino ||
+                cached_st.st_mtim.tv_sec != st.st_mtim.tv_sec ||
+                cached_st.st_mtim.tv_nsec != st.st_mtim.tv_nsec;
+    if (stale) {
+        name_list_free(&cached);
+        cached_sorted = -1;
+        if (name_list_read(&cached, path, argp->sorted) != 0) {
+            perror("mynfs_list_1_svc opendir");
+            result.status = -1;
+            return &result;
+        }
+        snprintf(cached_path, sizeof(cached_path), "%s", path);
+        cached_st = st;
+        cached_sorted = argp->sorted;
+    }
 
-        int wrote = snprintf(buffer + used, freeb + 1, "%s\n", dir->d_name);
-        if (wrote < 0 || (size_t)wrote > freeb) break;
+    // antet: status, total, count, cookie, more, lungimea sirului
+    u_int budget = MAX_XFER_SIZE - 24;
+    u_int start = argp->cookie < cached.count ? argp->cookie : cached.count;
+    u_int end = start;
+    while (end < cached.count) {
+        u_int cost = (u_int)strlen(cached.buf + cached.offs[end]) + 1;
+        if (cost > budget) break;
+        budget -= cost;
+        end++;
     }
-    closedir(d);
 
-    result = buffer;  
+    result.names = name_list_join(&cached, start, end);
+    if (!result.names) {
+        result.status = -1;
+        return &result;
+    }
+    result.total = cached.count;
+    result.count = end - start;
+    result.cookie = end;
+    result.more = end < cached.count;
     return &result;
 }
 
-// xdr custom
-bool_t xdr_ls_result(XDR *xdrs, char **arr) {
-    u_int arr_len = file_count;
-    return xdr_array(xdrs, (char **)&arr, &arr_len, MAX_FILES, sizeof(char *), (xdrproc_t)xdr_string);
+// find: rezultatele ultimei cautari, sortate, ca paginile sa nu refaca parcurgerea
+static struct {
+    char key[PATH_MAX + 256];
+    find_entry *hits;
+    u_int count, cap;
+} found;
+
+typedef struct {
+    const find_args *args;
+    regex_t re;
+} find_ctx;
+
+static void found_clear(void) {
+    for (u_int i = 0; i < found.count; i++) free(found.hits[i].path);
+    free(found.hits);
+    memset(&found, 0, sizeof(found));
+}
+
+static int find_visit(const char *rel, const struct stat *st, void *arg) {
+    const find_ctx *f = arg;
+    const find_args *a = f->args;
+    int type = S_ISREG(st->st_mode) ? FIND_FILE : S_ISDIR(st->st_mode) ? FIND_DIR : FIND_ANY;
+    const char *name = strrchr(rel, '/');
+    name = name ? name + 1 : rel;
+
+    // filtrele nu opresc coborarea: un director respins poate avea copii potriviti
+    if (a->type != FIND_ANY && type != a->type) return 0;
+    if (*a->pattern && (a->regex ? regexec(&f->re, name, 0, NULL, 0)
+                                 : fnmatch(a->pattern, name, 0)) != 0)
+        return 0;
+    if (a->min_size && (u_quad_t)st->st_size < a->min_size) return 0;
+    if (a->max_size && (u_quad_t)st->st_size > a->max_size) return 0;
+    if (a->newer_than && st->st_mtime <= a->newer_than) return 0;
+    if (a->older_than && st->st_mtime >= a->older_than) return 0;
+
+    if (found.count == found.cap) {
+        u_int cap = found.cap ? found.cap * 2 : 256;
+        find_entry *grown = realloc(found.hits, cap * sizeof(*grown));
+        if (!grown) return 0;
+        found.hits = grown;
+        found.cap = cap;
+    }
+    find_entry *e = &found.hits[found.count];
+    if (!(e->path = strdup(rel))) return 0;
+    e->type = type;
+    e->size = (u_quad_t)st->st_size;
+    e->mtime = st->st_mtime;
+    found.count++;
+    return 0;
+}
+
+static int cmp_hits(const void *a, const void *b) {
+    return strcmp(((const find_entry *)a)->path, ((const find_entry *)b)->path);
+}
+
+// find_1_svc: cauta in subarborele lui dirname; cookie 0 = cautare noua
+find_result *mynfs_find_1_svc(find_args *argp, struct svc_req *req) {
+    static find_result result;
+    char path[PATH_MAX];
+    char key[sizeof(found.key)];
+
+    // caile din entries apartin lui found, doar vectorul e al rezultatului
+    free(result.entries.entries_val);
+    memset(&result, 0, sizeof(result));
+    if (argp == NULL || argp->dirname == NULL || argp->pattern == NULL ||
+        make_path(path, sizeof(path), *argp->dirname ? argp->dirname : ".") != 0) {
+        fprintf(stderr, "mynfs_find_1_svc: invalid arguments\n");
+        result.status = -1;
+        return &result;
+    }
+
+    snprintf(key, sizeof(key), "%s|%s|%d|%d|%llu|%llu|%lld|%lld", path, argp->pattern,
+             argp->regex, argp->type, (unsigned long long)argp->min_size,
+             (unsigned long long)argp->max_size, (long long)argp->newer_than,
+             (long long)argp->older_than);
+    if (argp->cookie == 0 || strcmp(key, found.key) != 0) {
+        find_ctx f;
+        f.args = argp;
+        if (argp->regex && *argp->pattern &&
+            regcomp(&f.re, argp->pattern, REG_EXTENDED | REG_NOSUB) != 0) {
+            fprintf(stderr, "mynfs_find_1_svc: bad regex %s\n", argp->pattern);
+            result.status = -1;
+            return &result;
+        }
+        found_clear();
+        int status = nfs_walk(path, find_visit, &f);
+        if (argp->regex && *argp->pattern) regfree(&f.re);
+        if (status != 0) {
+            perror("mynfs_find_1_svc open");
+            result.status = -1;
+            return &result;
+        }
+        qsort(found.hits, found.count, sizeof(*found.hits), cmp_hits);
+        snprintf(found.key, sizeof(found.key), "%s", key);
+    }
+
+    result.entries.entries_val = calloc(MAX_FIND_ENTRIES, sizeof(find_entry));
+    if (!result.entries.entries_val) {
+        result.status = -1;
+        return &result;
+    }
+    // antet: status, total, cookie, more, lungimea vectorului
+    u_int budget = MAX_XFER_SIZE - 20;
+    u_int i = argp->cookie < found.count ? argp->cookie : found.count;
+    for (; i < found.count && result.entries.entries_len < MAX_FIND_ENTRIES; i++) {
+        u_int cost = 4 + (((u_int)strlen(found.hits[i].path) + 3) & ~3u) + 4 + 8 + 8;
+        if (cost > budget) break;
+        budget -= cost;
+        result.entries.entries_val[result.entries.entries_len++] = found.hits[i];
+    }
+    result.total = found.count;
+    result.cookie = i;
+    result.more = i < found.count;
+    return &result;
 }
 
 
@@ -119,13 +389,21 @@ int *create_1_svc(char **filename, struct svc_req *req) {
         return &result;
     }
 
-    snprintf(path, sizeof(path), "%s/%s", SHARED_DIR, *filename);
-    FILE *f = fopen(path, "w");
-    if (f) {
-        fclose(f);
+    if (make_path(path, sizeof(path), *filename) != 0) {
+        fprintf(stderr, "create_1_svc: Failed to construct path for %s\n", *filename);
+        result = -1;
+        return &result;
+    }
+    if ((result = nfs_lock_conflict(0, path, 0, 0)) != 0 ||
+        (result = nfs_lease_conflict(0, path, 1)) != 0)
+        return &result;
+    nfs_store_file f;
+    if (nfs_store_open(path, STORE_WRITE | STORE_TRUNC, &f) == 0) {
+        nfs_store_close(&f);
+        nfs_du_invalidate(path);
         result = 0; // succes
     } else {
-        perror("create_1_svc fopen");
+        perror("create_1_svc open");
         result = -1; // eroare
     }
     return &result;
@@ -142,9 +420,18 @@ int *delete_1_svc(char **argp, struct svc_req *req) {
         return &result;
     }
 
-    snprintf(path, sizeof(path), "%s/%s", SHARED_DIR, *argp);
-    if (remove(path) == 0) {
+    if (make_path(path, sizeof(path), *argp) != 0) {
+        fprintf(stderr, "delete_1_svc: Failed to construct path for %s\n", *argp);
+        result = -1;
+        return &result;
+    }
+    if ((result = nfs_lock_conflict(0, path, 0, 0)) != 0 ||
+        (result = nfs_lease_conflict(0, path, 1)) != 0)
+        return &result;
+    if (nfs_store_remove(path, 0) == 0) {
         printf("delete_1_svc: deleted file %s\n", path);
+        nfs_lock_forget(path);
+        nfs_du_invalidate(path);
         result = 0;
     } else {
         perror("delete_1_svc remove");
@@ -154,21 +441,59 @@ int *delete_1_svc(char **argp, struct svc_req *req) {
 }
 
 
-// retrieve_file_1
-static void free_chunk(chunk *res) {
-    if (!res) return;
-    if (res->filename) {
-        free(res->filename);
-        res->filename = NULL;
+// serverul ocupat nu mai comprima, trimite datele asa cum sunt
+static int cpu_busy(void) {
+    static time_t checked;
+    static int busy;
+    time_t now = time(NULL);
+
+    if (now != checked) {
+        double load;
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        busy = getloadavg(&load, 1) == 1 && load >= (double)(cpus > 0 ? cpus : 1);
+        checked = now;
     }
-    if (res->data.data_val) {
-        free(res->data.data_val);
-        res->data.data_val = NULL;
+    return busy;
+}
+
+// CRC32C pe datele citite, inainte de compresie
+static void crc_chunk(chunk *res, const request *argp) {
+    res->has_crc = argp->want_crc;
+    res->crc = argp->want_crc ? nfs_crc32c(0, res->data.data_val, res->data.data_len) : 0;
+}
+
+// comprima payload-ul unui raspuns daca clientul accepta si castigam ceva
+static void compress_chunk(chunk *res, const request *argp) {
+    res->codec = CODEC_NONE;
+    if (argp->codec <= CODEC_NONE || argp->codec > CODEC_ZSTD || res->data.data_len == 0)
+        return;
+    if (!(nfs_codecs_supported() & (1 << argp->codec)) || cpu_busy())
+        return;
+
+    char *packed = malloc(res->data.data_len);
+    if (!packed) return;
+    u_int n = nfs_compress(argp->codec, argp->level, res->data.data_val,
+                           res->data.data_len, packed, res->data.data_len);
+    if (n == 0) {
+        free(packed);
+        return;
     }
+    free(res->data.data_val);
+    res->data.data_val = packed;
+    res->data.data_len = n;
+    res->codec = argp->codec;
 }
+
+// retrieve_file_1
 chunk *retrieve_file_1_svc(request *argp, struct svc_req *req) {
     static chunk result;
 
+    // valori pt caile de eroare, clientul se opreste imediat
+    result.eof = TRUE;
+    result.file_size = 0;
+    result.codec = CODEC_NONE;
+    result.has_crc = FALSE;
+
     if (argp == NULL || argp->filename == NULL) {
         fprintf(stderr, "retrieve_file_1_svc: received NULL request or filename\n");
         result.filename = NULL;
@@ -196,9 +521,8 @@ chunk *retrieve_file_1_svc(request *argp, struct svc_req *req) {
         return &result;
     }
 
-    FILE *file = fopen(path, "rb");
-    if (!file) {
-        fprintf(stderr, "retrieve_file_1_svc: Failed to open file %s\n", path);
+    // alt client are lease de scriere: e rechemat, cererea revine mai tarziu
+    if (nfs_lease_conflict(argp->client, path, 0) != 0) {
         if(result.filename) {
             free(result.filename);
         }
@@ -208,14 +532,15 @@ chunk *retrieve_file_1_svc(request *argp, struct svc_req *req) {
         result.filename = strdup(argp->filename);
         result.data.data_len = 0;
         result.data.data_val = NULL;
-        result.size = 0;
+        result.size = ERR_DELAY;
         result.dest_offset = 0;
+        result.eof = FALSE;
         return &result;
     }
 
-    if (fseek(file, argp->src_offset, SEEK_SET) != 0) {
-        fprintf(stderr, "retrieve_file_1_svc: Failed to seek in file %s\n", path);
-        fclose(file);
+    nfs_store_file file;
+    if (nfs_store_open(path, 0, &file) != 0) {
+        fprintf(stderr, "retrieve_file_1_svc: Failed to open file %s\n", path);
         if(result.filename) {
             free(result.filename);
         }
@@ -237,7 +562,7 @@ chunk *retrieve_file_1_svc(request *argp, struct svc_req *req) {
     result.data.data_val = malloc(argp->size);
     if (!result.data.data_val) {
         fprintf(stderr, "retrieve_file_1_svc: Memory allocation failed\n");
-        fclose(file);
+        nfs_store_close(&file);
         if(result.filename) {
             free(result.filename);
         }
@@ -248,8 +573,11 @@ chunk *retrieve_file_1_svc(request *argp, struct svc_req *req) {
         return &result;
     }
 
-    size_t read_bytes = fread(result.data.data_val, 1, argp->size, file);
-    fclose(file);
+    ssize_t got = nfs_store_pread(&file, result.data.data_val, argp->size, argp->src_offset);
+    size_t read_bytes = got > 0 ? (size_t)got : 0;
+    struct stat st;
+    off_t file_size = nfs_store_fstat(&file, &st) == 0 ? st.st_size : 0;
+    nfs_store_close(&file);
 
     if(result.filename) {
         free(result.filename);
@@ -258,6 +586,10 @@ chunk *retrieve_file_1_svc(request *argp, struct svc_req *req) {
     result.data.data_len = read_bytes;
     result.size = read_bytes;
     result.dest_offset = argp->dest_offset;
+    result.file_size = file_size;
+    result.eof = (off_t)argp->src_offset + (off_t)read_bytes >= file_size;
+    crc_chunk(&result, argp);
+    compress_chunk(&result, argp);
 
     return &result;
 }
@@ -283,33 +615,60 @@ int *send_file_1_svc(chunk *argp, struct svc_req *req) {
         return &result;
     }
 
-    FILE *file = fopen(path, "r+b");
-    if (!file) {
-        file = fopen(path, "w+b");  // daca nu extsta, il cream
-    }
-
-    if (file) {
-        if (fseek(file, argp->dest_offset, SEEK_SET) != 0) {
-            perror("send_file_1_svc fseek");
-            fclose(file);
+    // chunk comprimat de client, size e dimensiunea reala
+    char *data = argp->data.data_val;
+    u_int len = argp->data.data_len;
+    char *raw = NULL;
+    if (argp->codec != CODEC_NONE) {
+        if (argp->size <= 0 || argp->size > MAX_RAW_CHUNK ||
+            !(raw = malloc(argp->size)) ||
+            nfs_decompress(argp->codec, data, len, raw, argp->size) != 0) {
+            fprintf(stderr, "send_file_1_svc: cannot decompress chunk for %s\n", path);
+            free(raw);
             result = -1;
             return &result;
         }
+        data = raw;
+        len = argp->size;
+    }
+
+    // chunk stricat pe drum: nu se scrie, clientul il retrimite
+    if (argp->has_crc && nfs_crc32c(0, data, len) != argp->crc) {
+        fprintf(stderr, "send_file_1_svc: CRC32C mismatch for %s at offset %u\n", path, argp->dest_offset);
+        free(raw);
+        result = ERR_CHECKSUM;
+        return &result;
+    }
 
-        size_t written = fwrite(argp->data.data_val, 1, argp->data.data_len, file);
-        fclose(file);
+    // blocarile altor clienti resping scrierea, lease-urile lor o amana
+    result = nfs_lock_conflict(argp->client, path, argp->dest_offset, len ? len : 1);
+    if (result == 0)
+        result = nfs_lease_conflict(argp->client, path, 1);
+    if (result != 0) {
+        free(raw);
+        return &result;
+    }
 
-        if (written == argp->data.data_len) {
+    // daca nu exista, il cream
+    nfs_store_file file;
+    if (nfs_store_open(path, STORE_WRITE, &file) == 0) {
+        ssize_t put = nfs_store_pwrite(&file, data, len, argp->dest_offset);
+        size_t written = put > 0 ? (size_t)put : 0;
+        nfs_store_close(&file);
+        nfs_du_invalidate(path);
+
+        if (written == len) {
             printf("send_file_1_svc: wrote %zu bytes to %s at offset %d\n", written, path, argp->dest_offset);
             result = 0;
         } else {
-            fprintf(stderr, "send_file_1_svc: partial write (%zu/%u) to %s\n", written, argp->data.data_len, path);
+            fprintf(stderr, "send_file_1_svc: partial write (%zu/%u) to %s\n", written, len, path);
             result = -1;
         }
     } else {
-        perror("send_file_1_svc fopen");
+        perror("send_file_1_svc open");
         result = -1;
     }
+    free(raw);
     return &result;
 }
 
@@ -324,10 +683,15 @@ int *mynfs_mkdir_1_svc(char **argp, struct svc_req *req) {
         return &result;
     }
 
-    snprintf(path, sizeof(path), "%s/%s", SHARED_DIR, *argp);
+    if (make_path(path, sizeof(path), *argp) != 0) {
+        fprintf(stderr, "mynfs_mkdir_1_svc: Failed to construct path for %s\n", *argp);
+        result = -1;
+        return &result;
+    }
 
-    if (mkdir(path, 0777) == 0) {
+    if (nfs_store_mkdir(path) == 0) {
         printf("mynfs_mkdir_1_svc: created directory %s\n", path);
+        nfs_du_invalidate(path);
         result = 0;  // success
     } else {
         perror("mynfs_mkdir_1_svc mkdir");
@@ -350,6 +714,10 @@ chunk *mynfs_read_1_svc(request *argp, struct svc_req *req) {
     result.data.data_len = 0;
     result.size = 0;
     result.dest_offset = 0;
+    result.eof = TRUE;
+    result.file_size = 0;
+    result.codec = CODEC_NONE;
+    result.has_crc = FALSE;
 
     if (argp == NULL || argp->filename == NULL) {
         fprintf(stderr, "mynfs_read_1_svc: received NULL request or filename\n");
@@ -364,16 +732,16 @@ chunk *mynfs_read_1_svc(request *argp, struct svc_req *req) {
         return &result;
     }
 
-    FILE *file = fopen(path, "rb");
-    if (!file) {
-        fprintf(stderr, "mynfs_read_1_svc: Failed to open file %s\n", path);
+    if (nfs_lease_conflict(argp->client, path, 0) != 0) {
         result.filename = strdup(argp->filename);
+        result.size = ERR_DELAY;
+        result.eof = FALSE;
         return &result;
     }
 
-    if (fseek(file, argp->src_offset, SEEK_SET) != 0) {
-        fprintf(stderr, "mynfs_read_1_svc: Failed to seek in file %s\n", path);
-        fclose(file);
+    nfs_store_file file;
+    if (nfs_store_open(path, 0, &file) != 0) {
+        fprintf(stderr, "mynfs_read_1_svc: Failed to open file %s\n", path);
         result.filename = strdup(argp->filename);
         return &result;
     }
@@ -381,18 +749,25 @@ chunk *mynfs_read_1_svc(request *argp, struct svc_req *req) {
     result.data.data_val = malloc(argp->size);
     if (!result.data.data_val) {
         fprintf(stderr, "mynfs_read_1_svc: Memory allocation failed\n");
-        fclose(file);
+        nfs_store_close(&file);
         result.filename = strdup(argp->filename);
         return &result;
     }
 
-    size_t read_bytes = fread(result.data.data_val, 1, argp->size, file);
-    fclose(file);
+    ssize_t got = nfs_store_pread(&file, result.data.data_val, argp->size, argp->src_offset);
+    size_t read_bytes = got > 0 ? (size_t)got : 0;
+    struct stat st;
+    off_t file_size = nfs_store_fstat(&file, &st) == 0 ? st.st_size : 0;
+    nfs_store_close(&file);
 
     result.filename = strdup(argp->filename);
     result.data.data_len = read_bytes;
     result.size = read_bytes;
     result.dest_offset = argp->dest_offset;
+    result.file_size = file_size;
+    result.eof = (off_t)argp->src_offset + (off_t)read_bytes >= file_size;
+    crc_chunk(&result, argp);
+    compress_chunk(&result, argp);
     return &result;
 }
 
@@ -402,37 +777,6 @@ int *mynfs_write_1_svc(chunk *argp, struct svc_req *req) {
 }
 
 
-// remdir_1_svc (sterge director recursiv)
-static int recursive_remove(const char *path) {
-    struct stat statbuf;
-    if (stat(path, &statbuf) != 0) {
-        return -1;
-    }
-    if (S_ISDIR(statbuf.st_mode)) {
-        DIR *dir = opendir(path);
-        if (!dir) return -1;
-        struct dirent *entry;
-        int ret = 0;
-        while ((entry = readdir(dir)) != NULL) {
-            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
-                continue;
-            char child_path[PATH_MAX];
-            snprintf(child_path, sizeof(child_path), "%s/%s", path, entry->d_name);
-            if (recursive_remove(child_path) != 0) {
-                ret = -1;
-            }
-        }
-        closedir(dir);
-        if (rmdir(path) != 0) {
-            ret = -1;
-        }
-        return ret;
-    } else {
-        // nu e folder, sterge fisierul
-        return remove(path);
-    }
-}
-
 // remdir_1_svc
 int *mynfs_remdir_1_svc(char **argp, struct svc_req *req) {
     static int result;
@@ -444,27 +788,45 @@ int *mynfs_remdir_1_svc(char **argp, struct svc_req *req) {
         return &result;
     }
 
-    snprintf(path, sizeof(path), "%s/%s", SHARED_DIR, *argp);
-    if (recursive_remove(path) == 0) {
+    if (make_path(path, sizeof(path), *argp) != 0) {
+        fprintf(stderr, "mynfs_remdir_1_svc: Failed to construct path for %s\n", *argp);
+        result = -1;
+        return &result;
+    }
+    // si la esec partial o parte din subarbore a disparut deja
+    nfs_du_invalidate(path);
+    if (nfs_store_remove(path, 1) == 0) {
         printf("mynfs_remdir_1_svc: recursively removed directory %s\n", path);
         result = 0;  // success
     } else {
-        perror("mynfs_remdir_1_svc recursive_remove");
+        perror("mynfs_remdir_1_svc remove");
         result = -1;  // error
     }
     return &result;
 }
 
 
-// readdir_1_svc
+// readdir_1_svc: cel mult MAX_FILES nume
+typedef struct {
+    char (*buf)[MAX_FILENAME_LENGTH];
+    char **names;
+    int count;
+} readdir_fill;
+
+static int readdir_visit(const char *name, const struct stat *st, void *ctx) {
+    readdir_fill *f = ctx;
+    // copiere nume fisier in buffer
+    strncpy(f->buf[f->count], name, MAX_FILENAME_LENGTH - 1);
+    f->buf[f->count][MAX_FILENAME_LENGTH - 1] = '\0';
+    f->names[f->count] = f->buf[f->count];
+    return ++f->count == MAX_FILES;
+}
+
 readdir_result *mynfs_readdir_1_svc(readdir_args *argp, struct svc_req *req) {
     static readdir_result result;
     static char name_buf[MAX_FILES][MAX_FILENAME_LENGTH];
     static char *names[MAX_FILES];
-    DIR *d;
-    struct dirent *dir;
     char path[PATH_MAX];
-    int count = 0;
 
     // resetare rezultat si pointeri
     memset(&result, 0, sizeof(result));
@@ -479,187 +841,1402 @@ readdir_result *mynfs_readdir_1_svc(readdir_args *argp, struct svc_req *req) {
         return &result;
     }
 
-    snprintf(path, sizeof(path), "%s/%s", SHARED_DIR, argp->dirname);
-    d = opendir(path);
-    if (!d) {
-        perror("mynfs_readdir_1_svc opendir");
+    if (make_path(path, sizeof(path), argp->dirname) != 0) {
+        fprintf(stderr, "mynfs_readdir_1_svc: Failed to construct path for %s\n", argp->dirname);
         result.filenames.filenames_val = NULL;
         result.filenames.filenames_len = 0;
         return &result;
     }
-
-    while ((dir = readdir(d)) != NULL && count < MAX_FILES) {
-        if (strcmp(dir->d_name, ".") == 0 || strcmp(dir->d_name, "..") == 0)
-            continue;
-        // copiere nume fisier in buffer
-        strncpy(name_buf[count], dir->d_name, MAX_FILENAME_LENGTH - 1);
-        name_buf[count][MAX_FILENAME_LENGTH - 1] = '\0';
-        names[count] = name_buf[count];
-        count++;
+    readdir_fill fill = { name_buf, names, 0 };
+    if (nfs_store_readdir(path, readdir_visit, &fill) != 0) {
+        perror("mynfs_readdir_1_svc opendir");
+        result.filenames.filenames_val = NULL;
+        result.filenames.filenames_len = 0;
+        return &result;
     }
-    closedir(d);
 
     result.filenames.filenames_val = names;
-    result.filenames.filenames_len = count;
+    result.filenames.filenames_len = fill.count;
     return &result;
 }
 
-// RPC service dispatcher
-void nfs_1(struct svc_req *rqstp, register SVCXPRT *transp) {
-    switch (rqstp->rq_proc) {
-        case NULLPROC:
-            svc_sendreply(transp, (xdrproc_t)xdr_void, NULL);
-            return;
-        case LS_PROC: {
-            char *arg = NULL;
-            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
-                svcerr_decode(transp);
-                return;
-            }
-            char **ls_res = ls_1_svc(&arg, rqstp);
-            if (!svc_sendreply(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)ls_res)) {
-                svcerr_systemerr(transp);
-            }
-            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
-            return;
-        }
-        case CREATE_PROC: {
-            char *arg = NULL;
-            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
-                svcerr_decode(transp);
-                return;
-            }
-            int *res = create_1_svc(&arg, rqstp);
-            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
-                svcerr_systemerr(transp);
-            }
-            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
-            return;
-        }
-        case DELETE_PROC: {
-            char *arg = NULL;
-            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
-                svcerr_decode(transp);
-                return;
-            }
-            int *res = delete_1_svc(&arg, rqstp);
-            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
-                svcerr_systemerr(transp);
-            }
-            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
-            return;
-        }
-        case RETRIEVE_FILE_PROC: {
-            request req = {0};
-            if (!svc_getargs(transp, (xdrproc_t)xdr_request, (caddr_t)&req)) {
-                svcerr_decode(transp);
-                return;
-            }
-            chunk *res = retrieve_file_1_svc(&req, rqstp);
-            if (!svc_sendreply(transp, (xdrproc_t)xdr_chunk, (caddr_t)res)) {
-                svcerr_systemerr(transp);
-            }
-            xdr_free((xdrproc_t)xdr_request, (caddr_t)&req);   // elibereaza argumentele
-            xdr_free((xdrproc_t)xdr_chunk, (caddr_t)res);      // elibereaza rezultatul
-            return;
-        }
-        case SEND_FILE_PROC: {
-            chunk ch = {0};
-            if (!svc_getargs(transp, (xdrproc_t)xdr_chunk, (caddr_t)&ch)) {
-                svcerr_decode(transp);
-                return;
-            }
-            int *res = send_file_1_svc(&ch, rqstp);
-            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
-                svcerr_systemerr(transp);
-            }
-            svc_freeargs(transp, (xdrproc_t)xdr_chunk, (caddr_t)&ch);
-            return;
-        }
-        case MYNFS_WRITE_PROC: {
-            chunk ch = {0};
-            if (!svc_getargs(transp, (xdrproc_t)xdr_chunk, (caddr_t)&ch)) {
-                svcerr_decode(transp);
-                return;
-            }
-            int *res = mynfs_write_1_svc(&ch, rqstp);
-            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
-                svcerr_systemerr(transp);
-            }
-            svc_freeargs(transp, (xdrproc_t)xdr_chunk, (caddr_t)&ch);
-            return;
-        }
-        case MYNFS_MKDIR_PROC: {
-            char *arg = NULL;
-            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
-                svcerr_decode(transp);
-                return;
-            }
-            int *res = mynfs_mkdir_1_svc(&arg, rqstp);
-            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
-                svcerr_systemerr(transp);
-            }
-            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
-            return;
-        }
-        case MYNFS_REMDIR_PROC: {
-            char *arg = NULL;
-            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
-                svcerr_decode(transp);
-                return;
-            }
-            int *res = mynfs_remdir_1_svc(&arg, rqstp);
-            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
-                svcerr_systemerr(transp);
-            }
-            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
-            return;
-        }
-        case MYNFS_READDIR_PROC: {
-            readdir_args arg = {0};
-            if (!svc_getargs(transp, (xdrproc_t)xdr_readdir_args, (caddr_t)&arg)) {
-                svcerr_decode(transp);
-                return;
-            }
-            readdir_result *res = mynfs_readdir_1_svc(&arg, rqstp);
-            if (!svc_sendreply(transp, (xdrproc_t)xdr_readdir_result, (caddr_t)res)) {
-                svcerr_systemerr(transp);
-            }
-            xdr_free((xdrproc_t)xdr_readdir_args, (caddr_t)&arg);      
-            xdr_free((xdrproc_t)xdr_readdir_result, (caddr_t)res);      
-            return;
-        }
-            case MYNFS_READ_PROC: {
-        request req = {0};
-        if (!svc_getargs(transp, (xdrproc_t)xdr_request, (caddr_t)&req)) {
-            svcerr_decode(transp);
-            return;
-        }
-        chunk *res = mynfs_read_1_svc(&req, rqstp);
-        if (!svc_sendreply(transp, (xdrproc_t)xdr_chunk, (caddr_t)res)) {
-            svcerr_systemerr(transp);
-        }
-        xdr_free((xdrproc_t)xdr_request, (caddr_t)&req);  
-        xdr_free((xdrproc_t)xdr_chunk, (caddr_t)res);     
-        return;
+// bulk_read: costul XDR al unei intrari (nume + status + file_size + opaque)
+static u_int bulk_entry_cost(const char *name, u_int data_len) {
+    return 4 + (((u_int)strlen(name) + 3) & ~3u) + 4 + 4 + 4 + ((data_len + 3) & ~3u);
+}
+
+static int cmp_names(const void *a, const void *b) {
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+typedef struct {
+    const char *dir, *pattern;
+    char **names;
+    u_int n, cap;
+} bulk_glob_ctx;
+
+static int bulk_glob_visit(const char *name, const struct stat *st, void *ctx) {
+    bulk_glob_ctx *g = ctx;
+    if (g->pattern && *g->pattern && fnmatch(g->pattern, name, 0) != 0)
+        return 0;
+
+    struct stat child_st;
+    if (!st) {
+        char child[PATH_MAX];
+        snprintf(child, sizeof(child), "%s/%s", g->dir, name);
+        if (nfs_store_stat(child, &child_st) != 0) return 0;
+        st = &child_st;
     }
-        default:
-            svcerr_noproc(transp);
-            return;
+    if (!S_ISREG(st->st_mode)) return 0;
+
+    if (g->n == g->cap) {
+        g->cap = g->cap ? g->cap * 2 : 64;
+        char **tmp = realloc(g->names, g->cap * sizeof(char *));
+        if (!tmp) return 1;
+        g->names = tmp;
+    }
+    g->names[g->n] = strdup(name);
+    if (!g->names[g->n]) return 1;
+    g->n++;
+    return 0;
+}
+
+// numele fisierelor regulate din dir care se potrivesc cu pattern, sortate
+static char **bulk_glob(const char *dir, const char *pattern, u_int *count) {
+    bulk_glob_ctx g = { dir, pattern, NULL, 0, 0 };
+
+    *count = 0;
+    if (nfs_store_readdir(dir, bulk_glob_visit, &g) != 0) return NULL;
+
+    // ordine stabila intre apeluri, ca sa mearga cookie-ul
+    if (g.n > 1) qsort(g.names, g.n, sizeof(char *), cmp_names);
+    *count = g.n;
+    return g.names;
+}
+
+// umple o intrare; intoarce costul XDR sau 0 daca nu mai incape in budget
+static u_int bulk_fill_entry(bulk_entry *e, const char *name, const char *path,
+                             u_int budget, u_int max_bytes) {
+    struct stat st;
+    memset(e, 0, sizeof(*e));
+
+    // dimensiunea se ia de la fisierul deschis, un manifest are alta pe disc
+    // alt client are lease de scriere: e rechemat, intrarea se citeste mai tarziu
+    if (path[0] && nfs_lease_conflict(0, path, 0) != 0) {
+        u_int cost = bulk_entry_cost(name, 0);
+        if (cost > budget) return 0;
+        e->filename = strdup(name);
+        e->status = ERR_DELAY;
+        return cost;
+    }
+
+    nfs_store_file file;
+    int opened = path[0] && nfs_store_open(path, 0, &file) == 0;
+    if (!opened || nfs_store_fstat(&file, &st) != 0 || !S_ISREG(st.st_mode)) {
+        if (opened) nfs_store_close(&file);
+        u_int cost = bulk_entry_cost(name, 0);
+        if (cost > budget) return 0;
+        e->filename = strdup(name);
+        e->status = BULK_ERROR;
+        return cost;
+    }
+
+    u_int size = (u_int)st.st_size;
+    if ((off_t)size != st.st_size || bulk_entry_cost(name, size) > max_bytes) {
+        // nu ar incapea nici singur intr-un raspuns
+        nfs_store_close(&file);
+        u_int cost = bulk_entry_cost(name, 0);
+        if (cost > budget) return 0;
+        e->filename = strdup(name);
+        e->status = BULK_TOO_BIG;
+        e->file_size = size;
+        return cost;
+    }
+
+    u_int cost = bulk_entry_cost(name, size);
+    if (cost > budget) {
+        nfs_store_close(&file);
+        return 0;
+    }
+
+    e->filename = strdup(name);
+    e->file_size = size;
+    e->status = BULK_ERROR;
+
+    e->data.data_val = malloc(size ? size : 1);
+    if (!e->data.data_val) {
+        nfs_store_close(&file);
+        return bulk_entry_cost(name, 0);
+    }
+    ssize_t got = nfs_store_pread(&file, e->data.data_val, size, 0);
+    e->data.data_len = got > 0 ? (u_int)got : 0;
+    nfs_store_close(&file);
+
+    // citire scurta: clientul ar scrie un fisier trunchiat drept bun
+    if (got != (ssize_t)size) return cost;
+    e->status = BULK_OK;
+    return cost;
+}
+
+// bulk_read_1_svc: continutul mai multor fisiere mici intr-un singur raspuns
+bulk_result *mynfs_bulk_read_1_svc(bulk_args *argp, struct svc_req *req) {
+    static bulk_result result;
+    char dir[PATH_MAX];
+    char **names = NULL;
+    u_int total;
+
+    xdr_free((xdrproc_t)xdr_bulk_result, (caddr_t)&result);
+    memset(&result, 0, sizeof(result));
+
+    if (!argp) {
+        fprintf(stderr, "mynfs_bulk_read_1_svc: received NULL args\n");
+        return &result;
+    }
+
+    int by_glob = argp->paths.paths_len == 0;
+    if (by_glob) {
+        if (make_path(dir, sizeof(dir), argp->dirname) != 0) {
+            fprintf(stderr, "mynfs_bulk_read_1_svc: Failed to construct path for %s\n", argp->dirname);
+            return &result;
+        }
+        names = bulk_glob(dir, argp->pattern, &total);
+    } else {
+        total = argp->paths.paths_len;
+    }
+
+    u_int max_bytes = argp->max_bytes;
+    if (max_bytes == 0 || max_bytes > MAX_XFER_SIZE)
+        max_bytes = MAX_XFER_SIZE;
+    else if (max_bytes < BULK_MIN_BYTES)
+        max_bytes = BULK_MIN_BYTES;
+
+    result.entries.entries_val = calloc(MAX_BULK_FILES, sizeof(bulk_entry));
+    if (!result.entries.entries_val) {
+        fprintf(stderr, "mynfs_bulk_read_1_svc: Memory allocation failed\n");
+        goto out;
+    }
+
+    // antet raspuns: lungime array + cookie + more
+    u_int budget = max_bytes - 12;
+    u_int i = argp->cookie;
+    while (i < total && result.entries.entries_len < MAX_BULK_FILES) {
+        const char *name = by_glob ? names[i] : argp->paths.paths_val[i];
+        char path[PATH_MAX];
+        int ok = by_glob
+            ? snprintf(path, sizeof(path), "%s/%s", dir, name) < (int)sizeof(path)
+            : make_path(path, sizeof(path), name) == 0;
+        if (!ok) path[0] = '\0';
+
+        bulk_entry *e = &result.entries.entries_val[result.entries.entries_len];
+        u_int cost = bulk_fill_entry(e, name, path, budget, max_bytes - 12);
+        if (cost == 0) break;   // nu mai incape, se reia de la cookie
+
+        budget -= cost;
+        result.entries.entries_len++;
+        i++;
+    }
+    result.cookie = i;
+    result.more = i < total;
+
+out:
+    if (names) {
+        for (u_int k = 0; k < total; k++) free(names[k]);
+        free(names);
+    }
+    return &result;
+}
+
+// extents_1_svc: zonele cu date ale unui fisier, fara gaurile dintre ele
+extent_result *mynfs_extents_1_svc(request *argp, struct svc_req *req) {
+    static extent_result result;
+    char path[PATH_MAX];
+
+    xdr_free((xdrproc_t)xdr_extent_result, (caddr_t)&result);
+    memset(&result, 0, sizeof(result));
+    result.status = -1;
+
+    if (argp == NULL || argp->filename == NULL) {
+        fprintf(stderr, "mynfs_extents_1_svc: received NULL request or filename\n");
+        return &result;
+    }
+    if (make_path(path, sizeof(path), argp->filename) != 0) {
+        fprintf(stderr, "mynfs_extents_1_svc: Failed to construct path for %s\n", argp->filename);
+        return &result;
+    }
+
+    if (nfs_lease_conflict(argp->client, path, 0) != 0) {
+        result.status = ERR_DELAY;
+        return &result;
+    }
+    nfs_store_file file;
+    if (nfs_store_open(path, 0, &file) != 0) {
+        perror("mynfs_extents_1_svc open");
+        return &result;
+    }
+    struct stat st;
+    if (nfs_store_fstat(&file, &st) != 0 || !S_ISREG(st.st_mode)) {
+        nfs_store_close(&file);
+        return &result;
+    }
+    // extent-urile si file_size sunt u_int; peste s-ar trunchia in tacere
+    if ((uint64_t)st.st_size > UINT_MAX) {
+        nfs_store_close(&file);
+        result.status = ERR_TOO_BIG;
+        return &result;
+    }
+
+    result.extents.extents_val = calloc(MAX_EXTENTS, sizeof(extent));
+    if (!result.extents.extents_val) {
+        fprintf(stderr, "mynfs_extents_1_svc: Memory allocation failed\n");
+        nfs_store_close(&file);
+        return &result;
+    }
+
+    off_t size = st.st_size;
+    off_t pos = argp->src_offset, data, hole;
+    while (nfs_store_next_data(&file, pos, size, &data, &hole)) {
+        if (result.extents.extents_len == MAX_EXTENTS) {
+            result.more = TRUE;
+            break;
+        }
+        extent *e = &result.extents.extents_val[result.extents.extents_len++];
+        e->offset = (u_int)data;
+        e->length = (u_int)(hole - data);
+        pos = hole;
+    }
+    nfs_store_close(&file);
+
+    result.file_size = (u_int)size;
+    result.status = 0;
+    return &result;
+}
+
+// truncate_1_svc: seteaza dimensiunea, fisierul se creeaza daca lipseste
+int *mynfs_truncate_1_svc(request *argp, struct svc_req *req) {
+    static int result;
+    char path[PATH_MAX];
+
+    if (argp == NULL || argp->filename == NULL) {
+        fprintf(stderr, "mynfs_truncate_1_svc: received NULL request or filename\n");
+        result = -1;
+        return &result;
+    }
+    if (make_path(path, sizeof(path), argp->filename) != 0) {
+        fprintf(stderr, "mynfs_truncate_1_svc: Failed to construct path for %s\n", argp->filename);
+        result = -1;
+        return &result;
+    }
+
+    if ((result = nfs_lock_conflict(argp->client, path, argp->size, 0)) != 0 ||
+        (result = nfs_lease_conflict(argp->client, path, 1)) != 0)
+        return &result;
+
+    // aceeasi dimensiune (de ex. la sfarsitul unui push): manifestul ramane
+    struct stat st;
+    if (nfs_store_stat(path, &st) == 0 && S_ISREG(st.st_mode) && st.st_size == (off_t)argp->size) {
+        result = 0;
+        return &result;
+    }
+
+    nfs_store_file file;
+    if (nfs_store_open(path, STORE_WRITE, &file) != 0) {
+        perror("mynfs_truncate_1_svc open");
+        result = -1;
+        return &result;
+    }
+    // extinderea lasa o gaura, nu blocuri cu zero
+    result = nfs_store_ftruncate(&file, argp->size) == 0 ? 0 : -1;
+    nfs_du_invalidate(path);
+    if (result != 0) perror("mynfs_truncate_1_svc ftruncate");
+    nfs_store_close(&file);
+    return &result;
+}
+
+// signatures_1_svc: suma slaba + tare pt fiecare bloc, de la start_block
+sig_result *mynfs_signatures_1_svc(sig_args *argp, struct svc_req *req) {
+    static sig_result result;
+    char path[PATH_MAX];
+
+    xdr_free((xdrproc_t)xdr_sig_result, (caddr_t)&result);
+    memset(&result, 0, sizeof(result));
+    result.status = -1;
+
+    if (argp == NULL || argp->filename == NULL) {
+        fprintf(stderr, "mynfs_signatures_1_svc: received NULL request or filename\n");
+        return &result;
+    }
+    if (make_path(path, sizeof(path), argp->filename) != 0) {
+        fprintf(stderr, "mynfs_signatures_1_svc: Failed to construct path for %s\n", argp->filename);
+        return &result;
+    }
+
+    u_int block_size = argp->block_size ? argp->block_size : SIG_BLOCK_DEFAULT;
+    if (block_size < 512) block_size = 512;
+    if (block_size > SIG_BLOCK_MAX) block_size = SIG_BLOCK_MAX;
+
+    if (nfs_lease_conflict(argp->client, path, 0) != 0) {
+        result.status = ERR_DELAY;
+        return &result;
+    }
+    nfs_store_file file;
+    if (nfs_store_open(path, 0, &file) != 0) {
+        perror("mynfs_signatures_1_svc open");
+        return &result;
+    }
+    struct stat st;
+    unsigned char *buf = malloc(block_size);
+    result.sigs.sigs_val = calloc(MAX_SIGS, sizeof(block_sig));
+    if (nfs_store_fstat(&file, &st) != 0 || !buf || !result.sigs.sigs_val) {
+        fprintf(stderr, "mynfs_signatures_1_svc: cannot read %s\n", path);
+        free(buf);
+        nfs_store_close(&file);
+        return &result;
+    }
+
+    off_t pos = (off_t)argp->start_block * block_size;
+    while (pos < st.st_size) {
+        if (result.sigs.sigs_len == MAX_SIGS) {
+            result.more = TRUE;
+            break;
+        }
+        ssize_t n = nfs_store_pread(&file, buf, block_size, pos);
+        if (n <= 0) break;
+
+        block_sig *sig = &result.sigs.sigs_val[result.sigs.sigs_len++];
+        sig->weak = nfs_weak_sum(buf, (size_t)n);
+        sig->strong = nfs_strong_sum(buf, (size_t)n);
+        pos += n;
+    }
+    free(buf);
+    nfs_store_close(&file);
+
+    result.file_size = (u_int)st.st_size;
+    result.block_size = block_size;
+    result.status = 0;
+    return &result;
+}
+
+// sha256 sau crc32c (big endian in primii 4 bytes) pe [offset, offset + length),
+// length 0 = pana la sfarsit
+static int store_sum(nfs_store_file *f, off_t offset, off_t length, int algo, unsigned char *sum) {
+    unsigned char buf[64 * 1024];
+    nfs_sha256_ctx ctx;
+    uint32_t crc = 0;
+    nfs_sha256_init(&ctx);
+
+    off_t pos = offset;
+    while (length == 0 || pos < offset + length) {
+        size_t want = sizeof(buf);
+        if (length != 0 && offset + length - pos < (off_t)want)
+            want = (size_t)(offset + length - pos);
+        ssize_t n = nfs_store_pread(f, buf, want, pos);
+        if (n < 0) return -1;
+        if (n == 0) break;
+        if (algo == SUM_CRC32C) crc = nfs_crc32c(crc, buf, (size_t)n);
+        else nfs_sha256_update(&ctx, buf, (size_t)n);
+        pos += n;
+    }
+    if (algo != SUM_CRC32C) {
+        nfs_sha256_final(&ctx, sum);
+        return 0;
+    }
+    sum[0] = (unsigned char)(crc >> 24);
+    sum[1] = (unsigned char)(crc >> 16);
+    sum[2] = (unsigned char)(crc >> 8);
+    sum[3] = (unsigned char)crc;
+    return 0;
+}
+
+// checksum_1_svc: sha256 sau crc32c pe un interval sau pe tot fisierul
+sum_result *mynfs_checksum_1_svc(sum_args *argp, struct svc_req *req) {
+    static sum_result result;
+    char path[PATH_MAX];
+
+    memset(&result, 0, sizeof(result));
+    result.status = -1;
+
+    if (argp == NULL || argp->filename == NULL) {
+        fprintf(stderr, "mynfs_checksum_1_svc: received NULL request or filename\n");
+        return &result;
+    }
+    if (make_path(path, sizeof(path), argp->filename) != 0) {
+        fprintf(stderr, "mynfs_checksum_1_svc: Failed to construct path for %s\n", argp->filename);
+        return &result;
+    }
+
+    if (nfs_lease_conflict(argp->client, path, 0) != 0) {
+        result.status = ERR_DELAY;
+        return &result;
+    }
+    nfs_store_file file;
+    if (nfs_store_open(path, 0, &file) != 0) {
+        perror("mynfs_checksum_1_svc open");
+        return &result;
+    }
+    struct stat st;
+    if (nfs_store_fstat(&file, &st) == 0) {
+        if (store_sum(&file, argp->offset, argp->length, argp->algo, (unsigned char *)result.sum) == 0)
+            result.status = 0;
+        result.file_size = (u_int)st.st_size;
+    }
+    nfs_store_close(&file);
+    return &result;
+}
+
+// codecs_1_svc: ce compresii stie serverul
+int *mynfs_codecs_1_svc(void *argp, struct svc_req *req) {
+    static int result;
+    result = nfs_codecs_supported();
+    return &result;
+}
+
+// has_chunks_1_svc: pt fiecare hash, 1 daca chunk-ul e deja in depozit
+cas_have *mynfs_has_chunks_1_svc(cas_query *argp, struct svc_req *req) {
+    static cas_have result;
+    static char have[MAX_CAS_HASHES];
+
+    memset(&result, 0, sizeof(result));
+    if (!nfs_cas_enabled()) {
+        result.status = ERR_NO_CAS;
+        return &result;
+    }
+    if (argp == NULL) {
+        fprintf(stderr, "mynfs_has_chunks_1_svc: received NULL args\n");
+        result.status = -1;
+        return &result;
+    }
+
+    for (u_int i = 0; i < argp->hashes.hashes_len; i++)
+        have[i] = (char)nfs_cas_has((unsigned char *)argp->hashes.hashes_val[i]);
+    result.have.have_val = have;
+    result.have.have_len = argp->hashes.hashes_len;
+    return &result;
+}
+
+// put_chunk_1_svc: salveaza un chunk, verificat cu hash-ul lui
+int *mynfs_put_chunk_1_svc(cas_chunk *argp, struct svc_req *req) {
+    static int result;
+
+    if (!nfs_cas_enabled()) {
+        result = ERR_NO_CAS;
+        return &result;
+    }
+    if (argp == NULL || argp->size < 0 || argp->size > CAS_CHUNK_SIZE) {
+        fprintf(stderr, "mynfs_put_chunk_1_svc: invalid arguments\n");
+        result = -1;
+        return &result;
+    }
+
+    char raw[CAS_CHUNK_SIZE];
+    char *data = argp->data.data_val;
+    u_int len = argp->data.data_len;
+    if (argp->codec != CODEC_NONE) {
+        if (nfs_decompress(argp->codec, data, len, raw, argp->size) != 0) {
+            fprintf(stderr, "mynfs_put_chunk_1_svc: cannot decompress chunk\n");
+            result = -1;
+            return &result;
+        }
+        data = raw;
+        len = argp->size;
+    }
+
+    result = nfs_cas_put((unsigned char *)argp->hash, data, len);
+    return &result;
+}
+
+// radacina in care e depozitul deduplicat (-d)
+static char cas_home[PATH_MAX];
+
+// put_manifest_1_svc: o bucata din lista de chunk-uri; last publica fisierul
+int *mynfs_put_manifest_1_svc(cas_manifest *argp, struct svc_req *req) {
+    static int result;
+    char path[PATH_MAX];
+
+    if (!nfs_cas_enabled()) {
+        result = ERR_NO_CAS;
+        return &result;
+    }
+    if (argp == NULL || argp->filename == NULL) {
+        fprintf(stderr, "mynfs_put_manifest_1_svc: received NULL request or filename\n");
+        result = -1;
+        return &result;
+    }
+    if (make_path(path, sizeof(path), argp->filename) != 0) {
+        fprintf(stderr, "mynfs_put_manifest_1_svc: Failed to construct path for %s\n", argp->filename);
+        result = -1;
+        return &result;
+    }
+
+    // manifestul se scrie direct pe disc, pe langa backend, si doar in
+    // exportul cu depozitul (nfs_cas_gc nu cauta manifeste in alte radacini)
+    const nfs_export *exp = nfs_export_find(path);
+    if (!exp || exp->engine != &nfs_store_posix || nfs_export_find(cas_home) != exp) {
+        result = ERR_NO_CAS;
+        return &result;
+    }
+    if (exp->read_only) {
+        result = -1;
+        return &result;
+    }
+
+    if (argp->last &&
+        ((result = nfs_lock_conflict(argp->client, path, 0, 0)) != 0 ||
+         (result = nfs_lease_conflict(argp->client, path, 1)) != 0))
+        return &result;
+
+    result = nfs_cas_put_manifest(path, argp->file_size, argp->start,
+                                  (const unsigned char (*)[NFS_SHA256_LEN])argp->hashes.hashes_val,
+                                  argp->hashes.hashes_len, argp->last);
+    if (argp->last)
+        nfs_du_invalidate(path);
+    if (result == 0 && argp->last)
+        printf("mynfs_put_manifest_1_svc: stored %s (%u bytes, deduplicated)\n", path, argp->file_size);
+    return &result;
+}
+
+// lock_1_svc / unlock_1_svc: blocari pe intervale, per client
+int *mynfs_lock_1_svc(lock_args *argp, struct svc_req *req) {
+    static int result;
+    char path[PATH_MAX];
+
+    if (argp == NULL || argp->filename == NULL ||
+        make_path(path, sizeof(path), argp->filename) != 0) {
+        fprintf(stderr, "mynfs_lock_1_svc: invalid arguments\n");
+        result = -1;
+        return &result;
+    }
+    result = nfs_lock_acquire(argp->client, path, argp->offset, argp->length, argp->exclusive);
+    return &result;
+}
+
+int *mynfs_unlock_1_svc(lock_args *argp, struct svc_req *req) {
+    static int result;
+    char path[PATH_MAX];
+
+    if (argp == NULL || argp->filename == NULL ||
+        make_path(path, sizeof(path), argp->filename) != 0) {
+        fprintf(stderr, "mynfs_unlock_1_svc: invalid arguments\n");
+        result = -1;
+        return &result;
+    }
+    result = nfs_lock_release(argp->client, path, argp->offset, argp->length);
+    return &result;
+}
+
+// lease_1_svc: lease de citire/scriere pe tot fisierul, sau predarea lui
+lease_result *mynfs_lease_1_svc(lease_args *argp, struct svc_req *req) {
+    static lease_result result;
+    char path[PATH_MAX];
+
+    memset(&result, 0, sizeof(result));
+    if (argp == NULL || argp->filename == NULL ||
+        make_path(path, sizeof(path), argp->filename) != 0) {
+        fprintf(stderr, "mynfs_lease_1_svc: invalid arguments\n");
+        result.status = -1;
+        return &result;
+    }
+
+    result.status = nfs_lease_acquire(argp->client, path, argp->filename, argp->type);
+    if (result.status != 0 || argp->type == LEASE_NONE) return &result;
+
+    // clientul afla si dimensiunea, ca sa stie daca merita sa tina fisierul
+    struct stat st;
+    if (nfs_store_stat(path, &st) == 0) result.file_size = (u_int)st.st_size;
+    result.type = argp->type;
+    result.seconds = LEASE_SECONDS;
+    return &result;
+}
+
+// renew_1_svc: tine in viata starea clientului, anunta lease-urile rechemate
+renew_result *mynfs_renew_1_svc(u_quad_t *argp, struct svc_req *req) {
+    static renew_result result;
+
+    xdr_free((xdrproc_t)xdr_renew_result, (caddr_t)&result);
+    memset(&result, 0, sizeof(result));
+    if (argp == NULL || *argp == 0) {
+        result.status = -1;
+        return &result;
+    }
+
+    result.recalled.recalled_val = calloc(MAX_RECALLS, sizeof(filename_t));
+    if (!result.recalled.recalled_val) {
+        result.status = -1;
+        return &result;
+    }
+    result.recalled.recalled_len = nfs_lease_renew(*argp, result.recalled.recalled_val, MAX_RECALLS);
+    return &result;
+}
+
+// watch_1_svc: schimbarile din director de la cookie-ul clientului incoace
+watch_result *mynfs_watch_1_svc(watch_args *argp, struct svc_req *req) {
+    static watch_result result;
+    char path[PATH_MAX];
+
+    xdr_free((xdrproc_t)xdr_watch_result, (caddr_t)&result);
+    memset(&result, 0, sizeof(result));
+    if (argp == NULL || argp->dirname == NULL ||
+        make_path(path, sizeof(path), argp->dirname) != 0) {
+        fprintf(stderr, "mynfs_watch_1_svc: invalid arguments\n");
+        result.status = -1;
+        return &result;
+    }
+
+    if (nfs_watch_poll(path, argp->cookie, MAX_XFER_SIZE, &result) != 0)
+        result.status = -1;
+    return &result;
+}
+
+// du_1_svc: spatiul ocupat de directorul cerut, cu tot ce e sub el
+du_result *mynfs_du_1_svc(char **argp, struct svc_req *req) {
+    static du_result result;
+    char path[PATH_MAX];
+
+    memset(&result, 0, sizeof(result));
+    if (argp == NULL || make_path(path, sizeof(path), *argp) != 0 ||
+        nfs_du(path, &result) != 0) {
+        fprintf(stderr, "mynfs_du_1_svc: cannot measure %s\n", argp && *argp ? *argp : "");
+        result.status = -1;
+    }
+    return &result;
+}
+
+// getattr_1_svc: dimensiunea (a fisierului, nu a manifestului) si mtime
+attr_result *mynfs_getattr_1_svc(char **argp, struct svc_req *req) {
+    static attr_result result;
+    char path[PATH_MAX];
+    struct stat st;
+
+    memset(&result, 0, sizeof(result));
+    if (argp == NULL || make_path(path, sizeof(path), *argp) != 0 || nfs_store_stat(path, &st) != 0) {
+        result.status = -1;
+        return &result;
+    }
+    result.type = S_ISREG(st.st_mode) ? FIND_FILE : S_ISDIR(st.st_mode) ? FIND_DIR : FIND_ANY;
+    result.file_size = (u_int)st.st_size;
+    result.mtime = st.st_mtim.tv_sec;
+    result.mtime_nsec = (u_int)st.st_mtim.tv_nsec;
+    return &result;
+}
+
+// RPC service dispatcher
+void nfs_1(struct svc_req *rqstp, register SVCXPRT *transp) {
+    switch (rqstp->rq_proc) {
+        case NULLPROC:
+            svc_sendreply(transp, (xdrproc_t)xdr_void, NULL);
+            return;
+        case LS_PROC: {
+            char *arg = NULL;
+            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            char **ls_res = ls_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)ls_res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
+            return;
+        }
+        case CREATE_PROC: {
+            char *arg = NULL;
+            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = create_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
+            return;
+        }
+        case DELETE_PROC: {
+            char *arg = NULL;
+            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = delete_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
+            return;
+        }
+        case RETRIEVE_FILE_PROC: {
+            request req = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_request_fast, (caddr_t)&req)) {
+                svcerr_decode(transp);
+                return;
+            }
+            chunk *res = retrieve_file_1_svc(&req, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_chunk_fast, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            xdr_free((xdrproc_t)xdr_request_fast, (caddr_t)&req);   // elibereaza argumentele
+            xdr_free((xdrproc_t)xdr_chunk, (caddr_t)res);      // elibereaza rezultatul
+            return;
+        }
+        case SEND_FILE_PROC: {
+            chunk ch = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_chunk_borrow, (caddr_t)&ch)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = send_file_1_svc(&ch, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_chunk_borrow, (caddr_t)&ch);
+            return;
+        }
+        case MYNFS_WRITE_PROC: {
+            chunk ch = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_chunk_borrow, (caddr_t)&ch)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = mynfs_write_1_svc(&ch, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_chunk_borrow, (caddr_t)&ch);
+            return;
+        }
+        case MYNFS_MKDIR_PROC: {
+            char *arg = NULL;
+            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = mynfs_mkdir_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_REMDIR_PROC: {
+            char *arg = NULL;
+            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = mynfs_remdir_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_READDIR_PROC: {
+            readdir_args arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_readdir_args, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            readdir_result *res = mynfs_readdir_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_readdir_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            // rezultatul e static (name_buf), doar argumentele se elibereaza
+            xdr_free((xdrproc_t)xdr_readdir_args, (caddr_t)&arg);
+            return;
+        }
+            case MYNFS_READ_PROC: {
+        request req = {0};
+        if (!svc_getargs(transp, (xdrproc_t)xdr_request_fast, (caddr_t)&req)) {
+            svcerr_decode(transp);
+            return;
+        }
+        chunk *res = mynfs_read_1_svc(&req, rqstp);
+        if (!svc_sendreply(transp, (xdrproc_t)xdr_chunk_fast, (caddr_t)res)) {
+            svcerr_systemerr(transp);
+        }
+        xdr_free((xdrproc_t)xdr_request_fast, (caddr_t)&req);  
+        xdr_free((xdrproc_t)xdr_chunk, (caddr_t)res);     
+        return;
+    }
+        case MYNFS_BULK_READ_PROC: {
+            bulk_args arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_bulk_args, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            bulk_result *res = mynfs_bulk_read_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_bulk_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_bulk_args, (caddr_t)&arg);
+            xdr_free((xdrproc_t)xdr_bulk_result, (caddr_t)res);
+            return;
+        }
+        case MYNFS_EXTENTS_PROC: {
+            request req = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_request_fast, (caddr_t)&req)) {
+                svcerr_decode(transp);
+                return;
+            }
+            extent_result *res = mynfs_extents_1_svc(&req, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_extent_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            xdr_free((xdrproc_t)xdr_request_fast, (caddr_t)&req);
+            xdr_free((xdrproc_t)xdr_extent_result, (caddr_t)res);
+            return;
+        }
+        case MYNFS_TRUNCATE_PROC: {
+            request req = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_request_fast, (caddr_t)&req)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = mynfs_truncate_1_svc(&req, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            xdr_free((xdrproc_t)xdr_request_fast, (caddr_t)&req);
+            return;
+        }
+        case MYNFS_SIGNATURES_PROC: {
+            sig_args arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_sig_args, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            sig_result *res = mynfs_signatures_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_sig_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_sig_args, (caddr_t)&arg);
+            xdr_free((xdrproc_t)xdr_sig_result, (caddr_t)res);
+            return;
+        }
+        case MYNFS_CHECKSUM_PROC: {
+            sum_args arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_sum_args, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            sum_result *res = mynfs_checksum_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_sum_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_sum_args, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_CODECS_PROC: {
+            if (!svc_getargs(transp, (xdrproc_t)xdr_void, NULL)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = mynfs_codecs_1_svc(NULL, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            return;
+        }
+        case MYNFS_HAS_CHUNKS_PROC: {
+            cas_query arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_cas_query, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            cas_have *res = mynfs_has_chunks_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_cas_have, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_cas_query, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_PUT_CHUNK_PROC: {
+            cas_chunk arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_cas_chunk, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = mynfs_put_chunk_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_cas_chunk, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_PUT_MANIFEST_PROC: {
+            cas_manifest arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_cas_manifest, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = mynfs_put_manifest_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_cas_manifest, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_LOCK_PROC:
+        case MYNFS_UNLOCK_PROC: {
+            lock_args arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_lock_args, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            int *res = rqstp->rq_proc == MYNFS_LOCK_PROC
+                ? mynfs_lock_1_svc(&arg, rqstp) : mynfs_unlock_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_int, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_lock_args, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_LEASE_PROC: {
+            lease_args arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_lease_args, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            lease_result *res = mynfs_lease_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_lease_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_lease_args, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_RENEW_PROC: {
+            u_quad_t arg = 0;
+            if (!svc_getargs(transp, (xdrproc_t)xdr_u_quad_t, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            renew_result *res = mynfs_renew_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_renew_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            return;
+        }
+        case MYNFS_WATCH_PROC: {
+            watch_args arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_watch_args, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            watch_result *res = mynfs_watch_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_watch_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_watch_args, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_LIST_PROC: {
+            list_args arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_list_args, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            list_result *res = mynfs_list_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_list_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_list_args, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_FIND_PROC: {
+            find_args arg = {0};
+            if (!svc_getargs(transp, (xdrproc_t)xdr_find_args, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            find_result *res = mynfs_find_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_find_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_find_args, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_DU_PROC: {
+            char *arg = NULL;
+            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            du_result *res = mynfs_du_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_du_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
+            return;
+        }
+        case MYNFS_GETATTR_PROC: {
+            char *arg = NULL;
+            if (!svc_getargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg)) {
+                svcerr_decode(transp);
+                return;
+            }
+            attr_result *res = mynfs_getattr_1_svc(&arg, rqstp);
+            if (!svc_sendreply(transp, (xdrproc_t)xdr_attr_result, (caddr_t)res)) {
+                svcerr_systemerr(transp);
+            }
+            svc_freeargs(transp, (xdrproc_t)xdr_wrapstring, (caddr_t)&arg);
+            return;
+        }
+        default:
+            svcerr_noproc(transp);
+            return;
     }
 }
 
 
 
 
+// kill -USR1: contoarele backend-ului de stocare, pt comparatii intre backend-uri;
+// cu -t si cererile urmarite (nfs_trace), scrise in serve
+static volatile sig_atomic_t dump_pending = 0;
+
+static void report_store(int sig) {
+    (void)sig;
+    nfs_store_report(STDERR_FILENO);
+    dump_pending = 1;
+}
+
+// semnalele pt procesul serverului, tratate in serve intre doua cereri:
+// SIGHUP reciteste exporturile, SIGUSR2 reporneste fara pierderi (nfs_handoff),
+// SIGTERM / SIGINT opresc serverul dupa cererea in curs
+static volatile sig_atomic_t reload_pending = 0, restart_pending = 0, stop_pending = 0;
+
+static void on_signal(int sig) {
+    if (sig == SIGHUP) reload_pending = 1;
+    else if (sig == SIGUSR2) restart_pending = 1;
+    else stop_pending = 1;
+}
+
+static const char *config_file = NULL;          // -c
+static const nfs_store_ops *default_engine = &nfs_store_posix;
+static const char *snapshot_file = NULL;        // -s
+static const char *qos_file = NULL;             // -q
+static const char *trace_file = NULL;           // -t
+static char **server_argv;
+
+// -w: procese worker, fiecare cu socket-ul lui pe acelasi port (SO_REUSEPORT),
+// deci kernelul imparte clientii intre ele si nu mai trece totul printr-o
+// singura coada de receptie. Implicit kernelul alege dupa adresa si port, iar
+// un client cu transferuri pe mai multe conexiuni (stripes) ar ajunge la mai
+// multi workeri; de aceea alegerea se face doar dupa adresa IP (reuseport_by_host),
+// si starea per client (upload-uri, cookie-urile watch) ramane intr-un singur
+// proces. Blocarile si lease-urile sunt in memoria comuna (nfs_shm), iar
+// cache-ul du e per proces, golit cand alt worker schimba ceva (nfs_du_share)
+#define MAX_WORKERS 64
+#define WORKER_SHM_SIZE (64 << 20)
+
+static pid_t workers[MAX_WORKERS];  // in worker-ul 0, ceilalti
+static int worker_count = 0;
+static int worker_index = 0;        // 0 = procesul pornit, cel inregistrat la rpcbind
+
+static void pin_cpu(int index) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cpus, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) perror("sched_setaffinity");
+}
+
+// datagrama merge la socket-ul (worker-ul) cu indexul intors: un hash al
+// adresei sursa IPv4, deci toate porturile unui client ajung la acelasi worker
+static int reuseport_by_host(int sock, int count) {
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_NET_OFF + 12),     // saddr din antetul IPv4
+        BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 2654435761u),
+        BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, (u_int)count),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+    struct sock_fprog prog = { sizeof(code) / sizeof(code[0]), code };
+    return setsockopt(sock, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+}
+
+// creeaza socket-urile si porneste worker-ii; intoarce socket-ul procesului
+// curent, sau -1
+static int start_workers(int count) {
+    if (nfs_mem_enabled()) {
+        fprintf(stderr, "Error: -w cannot be used with in-memory exports, each worker would have its own.\n");
+        return -1;
+    }
+    if (nfs_shm_init(WORKER_SHM_SIZE) != 0 || nfs_lock_share() != 0 || nfs_du_share() != 0) {
+        fprintf(stderr, "Error: cannot set up memory shared between workers.\n");
+        return -1;
+    }
+    nfs_export_disk_only();
+
+    int socks[MAX_WORKERS];
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    for (int i = 0; i < count; i++) {
+        int one = 1;
+        socks[i] = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        // primul primeste un port liber, ceilalti se leaga de acelasi
+        if (socks[i] < 0 || setsockopt(socks[i], SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0 ||
+            bind(socks[i], (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            perror("start_workers socket");
+            return -1;
+        }
+        if (i == 0) {
+            socklen_t len = sizeof(addr);
+            if (getsockname(socks[0], (struct sockaddr *)&addr, &len) != 0) {
+                perror("start_workers getsockname");
+                return -1;
+            }
+        }
+    }
+    // socket-urile intra in grup in ordinea bind-urilor, deci indexul i e worker-ul i
+    if (reuseport_by_host(socks[0], count) != 0) {
+        perror("start_workers SO_ATTACH_REUSEPORT_CBPF");
+        return -1;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    for (int i = 1; i < count; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("start_workers fork");
+            return -1;
+        }
+        if (pid == 0) {
+            worker_index = i;
+            worker_count = 0;
+            for (int j = 0; j < count; j++)
+                if (j != i) close(socks[j]);
+            // fara worker-ul 0 nu mai e nimeni inregistrat la rpcbind
+            prctl(PR_SET_PDEATHSIG, SIGTERM);
+            if (getppid() == 1) exit(0);
+            pin_cpu(i);
+            return socks[i];
+        }
+        workers[worker_count++] = pid;
+        close(socks[i]);
+    }
+    pin_cpu(0);
+    printf("Started %d workers on UDP port %d.\n", count, ntohs(addr.sin_port));
+    return socks[0];
+}
+
+// worker-ul 0 transmite semnalele primite si celorlalti
+static void signal_workers(int sig) {
+    for (int i = 0; i < worker_count; i++) kill(workers[i], sig);
+}
+
+static void reload_exports(void) {
+    if (!config_file && !qos_file)
+        printf("SIGHUP: no config file (-c / -q), nothing to reload.\n");
+    if (config_file) {
+        if (nfs_export_load(config_file, default_engine) == 0)
+            printf("Reloaded %s.\n", config_file);
+        else
+            fprintf(stderr, "Error: %s not reloaded, keeping the old exports.\n", config_file);
+    }
+    if (qos_file) {
+        if (nfs_sched_load(qos_file) == 0)
+            printf("Reloaded %s.\n", qos_file);
+        else
+            fprintf(stderr, "Error: %s not reloaded, keeping the old limits.\n", qos_file);
+    }
+}
+
+// ca svc_run, dar semnalele ajung doar in ppoll, deci niciodata in mijlocul
+// unei cereri, iar cererile trec prin planificator (nfs_sched); cat timp sunt
+// directoare de incalzit din instantaneu, se recalculeaza cate unul cand nu
+// asteapta nicio cerere
+static void serve(int sock) {
+    sigset_t handled, waiting;
+    sigemptyset(&handled);
+    sigaddset(&handled, SIGHUP);
+    sigaddset(&handled, SIGUSR2);
+    sigaddset(&handled, SIGTERM);
+    sigaddset(&handled, SIGINT);
+    sigaddset(&handled, SIGUSR1);
+    sigprocmask(SIG_BLOCK, &handled, &waiting);
+    // dupa un restart masca vine blocata de la procesul vechi
+    sigdelset(&waiting, SIGHUP);
+    sigdelset(&waiting, SIGUSR2);
+    sigdelset(&waiting, SIGTERM);
+    sigdelset(&waiting, SIGINT);
+    sigdelset(&waiting, SIGUSR1);
+    signal(SIGHUP, on_signal);
+    signal(SIGUSR2, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGINT, on_signal);
+
+    int peer = -1;      // succesorul, in timpul unui restart
+    int warming = 1;
+    struct pollfd *fds = NULL;
+    int cap = 0;
+    for (;;) {
+        if (stop_pending) {
+            if (nfs_trace_enabled()) nfs_trace_dump(worker_index);
+            if (worker_index > 0) exit(0);
+            signal_workers(SIGTERM);
+            if (snapshot_file && nfs_snapshot_save(snapshot_file) == 0)
+                printf("Saved %s.\n", snapshot_file);
+            printf("Stopping.\n");
+            fflush(stdout);
+            pmap_unset(NFS_PROGRAM, NFS_VERSION_1);
+            exit(0);
+        }
+        if (reload_pending) {
+            reload_pending = 0;
+            signal_workers(SIGHUP);
+            reload_exports();
+        }
+        if (dump_pending) {
+            dump_pending = 0;
+            signal_workers(SIGUSR1);
+            if (nfs_trace_enabled()) nfs_trace_dump(worker_index);
+        }
+        if (restart_pending) {
+            restart_pending = 0;
+            if (peer >= 0)
+                printf("SIGUSR2: a restart is already in progress.\n");
+            else if (nfs_mem_enabled())
+                fprintf(stderr, "Error: not restarting, the in-memory exports would be lost.\n");
+            else if (nfs_shm_enabled())
+                fprintf(stderr, "Error: not restarting, running with worker processes (-w).\n");
+            else
+                peer = nfs_handoff_start(sock, server_argv);
+        }
+        fflush(stdout);
+
+        // svc_pollfd se poate muta intre iteratii; succesorul e la coada
+        int nsvc = svc_max_pollfd;
+        if (nsvc + 1 > cap) {
+            cap = nsvc + 1;
+            struct pollfd *grown = realloc(fds, cap * sizeof(*fds));
+            if (!grown) {
+                perror("serve realloc");
+                return;
+            }
+            fds = grown;
+        }
+        memcpy(fds, svc_pollfd, nsvc * sizeof(*fds));
+        fds[nsvc].fd = peer;
+        fds[nsvc].events = POLLIN;
+        fds[nsvc].revents = 0;
+
+        // cu cereri gata nu se asteapta; cu unele oprite de limite, doar pana trec
+        long long next = nfs_sched_next_ns();
+        struct timespec timeout = { 0, 0 };
+        if (next > 0 && !warming) {
+            timeout.tv_sec = next / 1000000000;
+            timeout.tv_nsec = next % 1000000000;
+        }
+        int n = ppoll(fds, nsvc + 1, next >= 0 || warming ? &timeout : NULL, &waiting);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("serve ppoll");
+            return;
+        }
+        int idle = n == 0;
+        if (peer >= 0 && fds[nsvc].revents) {
+            n--;
+            // cererile primite pana acum au raspuns; restul raman in socket
+            nfs_sched_flush();
+            if (nfs_handoff_finish(peer)) {
+                if (nfs_trace_enabled()) nfs_trace_dump(worker_index);
+                exit(0);
+            }
+            peer = -1;
+        }
+        // socket-ul serverului il citeste planificatorul, nu svc
+        for (int i = 0; i < nsvc; i++) {
+            if (fds[i].fd == sock && fds[i].revents) {
+                nfs_sched_receive();
+                fds[i].revents = 0;
+                n--;
+            }
+        }
+        if (n > 0) svc_getreq_poll(fds, n);
+
+        // cate o cerere pe iteratie, ca una sosita intre timp sa-si ia locul in coada
+        if (nfs_sched_dispatch()) idle = 0;
+        if (idle && warming) warming = nfs_du_warm();
+    }
+}
+
 // activare server
-int main() {
+int main(int argc, char *argv[]) {
+
+    // -c: exporturile dintr-un fisier de configurare (vezi nfs_export.h)
+    // -d: fisierele urcate se pastreaza deduplicat, pe chunk-uri
+    // -m: exporturile fara engine= pornesc goale in memorie, nimic pe disc
+    // -q: ponderile si limitele per client (vezi nfs_sched.h)
+    // -s: la oprire cache-ul du se salveaza aici, la pornire se incalzeste din el
+    // -t: cererile se urmaresc si se scriu aici la kill -USR1 / oprire (vezi nfs_trace.h)
+    // -w: numarul de procese worker; 0 = cate unul pe procesor
+    int dedup = 0, in_mem = 0, nworkers = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:dmq:s:t:w:")) != -1) {
+        if (opt == 'c') {
+            config_file = optarg;
+        } else if (opt == 'd' && !in_mem) {
+            dedup = 1;
+        } else if (opt == 'm' && !dedup) {
+            in_mem = 1;
+        } else if (opt == 'q') {
+            qos_file = optarg;
+        } else if (opt == 's') {
+            snapshot_file = optarg;
+        } else if (opt == 't') {
+            trace_file = optarg;
+        } else if (opt == 'w' && (nworkers = atoi(optarg)) >= 0 && nworkers <= MAX_WORKERS) {
+            if (nworkers == 0) {
+                long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+                nworkers = cpus < 1 ? 1 : cpus > MAX_WORKERS ? MAX_WORKERS : (int)cpus;
+            }
+        } else {
+            fprintf(stderr, "Usage: %s [-c config] [-d | -m] [-q qos] [-s snapshot] [-t trace] [-w workers]\n", argv[0]);
+            exit(1);
+        }
+    }
+    server_argv = argv;
+    int inherited = nfs_handoff_socket();
+
+    default_engine = in_mem ? &nfs_store_mem : &nfs_store_posix;
+    if ((config_file ? nfs_export_load(config_file, default_engine)
+                     : nfs_export_single(SHARED_DIR, default_engine)) != 0) {
+        fprintf(stderr, "Error: cannot set up the exports.\n");
+        exit(1);
+    }
+    if (qos_file && nfs_sched_load(qos_file) != 0) {
+        fprintf(stderr, "Error: cannot read the client limits.\n");
+        exit(1);
+    }
+    if (trace_file && nfs_trace_init(trace_file) != 0) exit(1);
+    if (dedup) {
+        // un singur depozit, in radacina exportului implicit de la pornire
+        if (make_path(cas_home, sizeof(cas_home), ".") != 0 ||
+            nfs_store_for(cas_home) != &nfs_store_posix || nfs_cas_init(cas_home) != 0) {
+            fprintf(stderr, "Error: cannot create the chunk store, the default export must be on disk.\n");
+            exit(1);
+        }
+        // la un restart procesul vechi poate avea o incarcare deduplicata neterminata
+        if (inherited < 0) nfs_cas_gc();
+        printf("Deduplicated storage enabled in %s/%s.\n", cas_home, NFS_CAS_DIR);
+    }
+    if (inherited < 0 && snapshot_file && nfs_snapshot_load(snapshot_file) != 0)
+        fprintf(stderr, "Warning: cannot read %s, starting cold.\n", snapshot_file);
+
+    // la un restart inregistrarea din rpcbind ramane, portul e acelasi
+    if (inherited < 0) pmap_unset(NFS_PROGRAM, NFS_VERSION_1);
 
-    pmap_unset(NFS_PROGRAM, NFS_VERSION_1);
+    // cu -w fiecare worker continua de aici cu socket-ul lui
+    int sock = inherited >= 0 ? inherited : RPC_ANYSOCK;
+    if (inherited < 0 && nworkers > 1 && (sock = start_workers(nworkers)) < 0) exit(1);
 
     // RPC server handle
     SVCXPRT *transp;
-    transp = svcudp_create(RPC_ANYSOCK);
+    transp = svcudp_create(sock);
     if (transp == NULL) {
         fprintf(stderr, "Error: Unable to create RPC service.\n");
         exit(1);
@@ -667,15 +2244,23 @@ int main() {
     printf("RPC service handle created successfully.\n");
 
     // inregistrare serviciu cu RPC
-    if (!svc_register(transp, NFS_PROGRAM, NFS_VERSION_1, nfs_1, IPPROTO_UDP)) {
+    // portul e deja la rpcbind dupa un restart, sau il anunta worker-ul 0
+    int proto = inherited >= 0 || worker_index > 0 ? 0 : IPPROTO_UDP;
+    if (!svc_register(transp, NFS_PROGRAM, NFS_VERSION_1, nfs_1, proto)) {
         fprintf(stderr, "Unable to register (NFS_PROGRAM, NFS_VERSION_1, IPPROTO_UDP).\n");
         exit(1);
     }
     printf("Service registered successfully with program number %d and version %d.\n", NFS_PROGRAM, NFS_VERSION_1);
 
+    signal(SIGUSR1, report_store);
+    if (nfs_sched_init(transp, nfs_1) != 0) exit(1);
+
+    // procesul vechi se opreste abia acum, dupa ce preda starea
+    if (inherited >= 0 && nfs_handoff_accept() != 0) exit(1);
+
     // pornire
     printf("Starting svc_run...\n");
-    svc_run();  // server loop
+    serve(transp->xp_fd);  // server loop
 
     // caz de eroare
     fprintf(stderr, "Error: svc_run returned\n");
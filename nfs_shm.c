@@ -0,0 +1,120 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "nfs_shm.h"
+
+#define SHM_ALIGN 16
+#define SHM_CLASSES 8       // cate dimensiuni diferite de bloc se refolosesc
+
+typedef struct shm_block {
+    size_t len;             // fara antet, multiplu de SHM_ALIGN
+    struct shm_block *next; // doar cat e in lista libera
+} shm_block;
+
+#define SHM_HEADER ((sizeof(shm_block) + SHM_ALIGN - 1) & ~(size_t)(SHM_ALIGN - 1))
+
+typedef struct {
+    pthread_mutex_t mu;
+    size_t size, used;
+    struct {
+        size_t len;
+        shm_block *head;
+    } free_lists[SHM_CLASSES];
+} shm_arena;
+
+static shm_arena *arena = NULL;
+
+int nfs_shm_init(size_t size) {
+    void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        perror("nfs_shm_init mmap");
+        return -1;
+    }
+    shm_arena *a = mem;
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    // un worker mort cu mutexul luat nu trebuie sa-i blocheze pe ceilalti
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    int err = pthread_mutex_init(&a->mu, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (err) {
+        fprintf(stderr, "nfs_shm_init: %s\n", strerror(err));
+        munmap(mem, size);
+        return -1;
+    }
+    a->size = size;
+    a->used = (sizeof(*a) + SHM_ALIGN - 1) & ~(size_t)(SHM_ALIGN - 1);
+    arena = a;
+    return 0;
+}
+
+int nfs_shm_enabled(void) {
+    return arena != NULL;
+}
+
+void nfs_shm_lock(void) {
+    if (!arena) return;
+    if (pthread_mutex_lock(&arena->mu) == EOWNERDEAD)
+        pthread_mutex_consistent(&arena->mu);
+}
+
+void nfs_shm_unlock(void) {
+    if (arena) pthread_mutex_unlock(&arena->mu);
+}
+
+void *nfs_shm_alloc(size_t len) {
+    if (!arena) return calloc(1, len);
+
+    len = (len + SHM_ALIGN - 1) & ~(size_t)(SHM_ALIGN - 1);
+    void *p = NULL;
+    nfs_shm_lock();
+    for (int i = 0; i < SHM_CLASSES; i++) {
+        if (arena->free_lists[i].len == len && arena->free_lists[i].head) {
+            shm_block *b = arena->free_lists[i].head;
+            arena->free_lists[i].head = b->next;
+            p = (char *)b + SHM_HEADER;
+            break;
+        }
+    }
+    if (!p && arena->used + SHM_HEADER + len <= arena->size) {
+        shm_block *b = (shm_block *)((char *)arena + arena->used);
+        b->len = len;
+        arena->used += SHM_HEADER + len;
+        p = (char *)b + SHM_HEADER;
+    }
+    nfs_shm_unlock();
+    if (p) memset(p, 0, len);
+    else errno = ENOMEM;
+    return p;
+}
+
+void nfs_shm_free(void *p) {
+    if (!p) return;
+    if (!arena) {
+        free(p);
+        return;
+    }
+
+    shm_block *b = (shm_block *)((char *)p - SHM_HEADER);
+    nfs_shm_lock();
+    int slot = -1;
+    for (int i = 0; i < SHM_CLASSES; i++) {
+        if (arena->free_lists[i].len == b->len) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && arena->free_lists[i].len == 0) slot = i;
+    }
+    // o dimensiune in plus fata de SHM_CLASSES nu se mai refoloseste
+    if (slot >= 0) {
+        arena->free_lists[slot].len = b->len;
+        b->next = arena->free_lists[slot].head;
+        arena->free_lists[slot].head = b;
+    }
+    nfs_shm_unlock();
+}
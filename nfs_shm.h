@@ -0,0 +1,23 @@
+#ifndef NFS_SHM_H
+#define NFS_SHM_H
+
+#include <stddef.h>
+
+// memorie comuna pt procesele worker (-w): zona se mapeaza inainte de fork,
+// deci pointerii din ea sunt valabili in toate procesele. Starea care trebuie
+// vazuta de toti (blocari, lease-uri) se aloca de aici si se modifica doar
+// intre nfs_shm_lock / nfs_shm_unlock. Fara nfs_shm_init functiile se
+// comporta ca calloc / free, iar blocarea nu face nimic
+
+int nfs_shm_init(size_t size);
+int nfs_shm_enabled(void);
+
+// umpluta cu zero; NULL cand zona e plina
+void *nfs_shm_alloc(size_t len);
+void nfs_shm_free(void *p);
+
+// un singur mutex pt toata zona, recursiv
+void nfs_shm_lock(void);
+void nfs_shm_unlock(void);
+
+#endif
@@ -0,0 +1,213 @@
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "nfs_export.h"
+#include "nfs_store.h"
+#include "nfs_trace.h"
+#include "nfs_walk.h"
+
+// backend-urile cunoscute, cu contoarele lor
+static struct {
+    const nfs_store_ops *ops;
+    nfs_store_stats stats;
+} backends[] = {
+    { &nfs_store_posix },
+    { &nfs_store_mem },
+};
+#define BACKEND_COUNT (int)(sizeof(backends) / sizeof(backends[0]))
+
+static const char *op_names[STORE_OP_COUNT] = {
+    "open", "read", "write", "stat", "truncate", "readdir", "mkdir", "remove"
+};
+
+const nfs_store_ops *nfs_store_by_name(const char *name) {
+    for (int i = 0; i < BACKEND_COUNT; i++)
+        if (strcmp(backends[i].ops->name, name) == 0) return backends[i].ops;
+    return NULL;
+}
+
+static nfs_store_stats *stats_of(const nfs_store_ops *ops) {
+    for (int i = 0; i < BACKEND_COUNT; i++)
+        if (backends[i].ops == ops) return &backends[i].stats;
+    return &backends[0].stats;
+}
+
+const nfs_store_ops *nfs_store_for(const char *path) {
+    const nfs_export *e = nfs_export_find(path);
+    return e ? e->engine : &nfs_store_posix;
+}
+
+// scrierile intr-un export read-only
+static int read_only(const char *path) {
+    const nfs_export *e = nfs_export_find(path);
+    if (e && e->read_only) {
+        errno = EROFS;
+        return 1;
+    }
+    return 0;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void count(const nfs_store_ops *ops, int op, uint64_t start, int failed) {
+    nfs_store_stats *st = stats_of(ops);
+    uint64_t end = now_ns();
+    st->calls[op]++;
+    st->nsec[op] += end - start;
+    nfs_trace_stage(TRACE_IO, start, end);
+    if (failed) st->errors[op]++;
+}
+
+int nfs_store_open(const char *path, int flags, nfs_store_file *f) {
+    f->ops = nfs_store_for(path);
+    if (flags && read_only(path)) return -1;
+    uint64_t t = now_ns();
+    int ret = f->ops->open(path, flags, f);
+    count(f->ops, STORE_OP_OPEN, t, ret != 0);
+    return ret;
+}
+
+void nfs_store_close(nfs_store_file *f) {
+    f->ops->close(f);
+}
+
+ssize_t nfs_store_pread(nfs_store_file *f, void *buf, size_t len, off_t off) {
+    uint64_t t = now_ns();
+    ssize_t got = f->ops->pread(f, buf, len, off);
+    count(f->ops, STORE_OP_READ, t, got < 0);
+    if (got > 0) stats_of(f->ops)->bytes_read += (uint64_t)got;
+    return got;
+}
+
+ssize_t nfs_store_pwrite(nfs_store_file *f, const void *buf, size_t len, off_t off) {
+    uint64_t t = now_ns();
+    ssize_t put = f->ops->pwrite(f, buf, len, off);
+    count(f->ops, STORE_OP_WRITE, t, put < 0);
+    if (put > 0) stats_of(f->ops)->bytes_written += (uint64_t)put;
+    return put;
+}
+
+int nfs_store_fstat(nfs_store_file *f, struct stat *st) {
+    uint64_t t = now_ns();
+    int ret = f->ops->fstat(f, st);
+    count(f->ops, STORE_OP_STAT, t, ret != 0);
+    return ret;
+}
+
+int nfs_store_ftruncate(nfs_store_file *f, off_t size) {
+    uint64_t t = now_ns();
+    int ret = f->ops->ftruncate(f, size);
+    count(f->ops, STORE_OP_TRUNCATE, t, ret != 0);
+    return ret;
+}
+
+// parte din citire, se numara acolo
+int nfs_store_next_data(nfs_store_file *f, off_t pos, off_t size, off_t *start, off_t *end) {
+    uint64_t t = now_ns();
+    int ret = f->ops->next_data(f, pos, size, start, end);
+    count(f->ops, STORE_OP_READ, t, 0);
+    return ret;
+}
+
+int nfs_store_stat(const char *path, struct stat *st) {
+    const nfs_store_ops *ops = nfs_store_for(path);
+    uint64_t t = now_ns();
+    int ret = ops->stat(path, st);
+    count(ops, STORE_OP_STAT, t, ret != 0);
+    return ret;
+}
+
+int nfs_store_mkdir(const char *path) {
+    if (read_only(path)) return -1;
+    const nfs_store_ops *ops = nfs_store_for(path);
+    uint64_t t = now_ns();
+    int ret = ops->mkdir(path);
+    count(ops, STORE_OP_MKDIR, t, ret != 0);
+    return ret;
+}
+
+int nfs_store_remove(const char *path, int recursive) {
+    if (read_only(path)) return -1;
+    // radacina unui export ramane, chiar daca se goleste
+    const nfs_export *e = nfs_export_find(path);
+    char key[PATH_MAX];
+    nfs_path_normalize(path, key, sizeof(key));
+    if (e && strcmp(e->key, key) == 0) {
+        errno = EBUSY;
+        return -1;
+    }
+    const nfs_store_ops *ops = nfs_store_for(path);
+    uint64_t t = now_ns();
+    int ret = ops->remove(path, recursive);
+    count(ops, STORE_OP_REMOVE, t, ret != 0);
+    return ret;
+}
+
+// timpul include si fn, adica ce face procedura cu fiecare intrare
+int nfs_store_readdir(const char *dir, nfs_store_dir_fn fn, void *ctx) {
+    const nfs_store_ops *ops = nfs_store_for(dir);
+    uint64_t t = now_ns();
+    int ret = ops->readdir(dir, fn, ctx);
+    count(ops, STORE_OP_READDIR, t, ret != 0);
+    return ret;
+}
+
+const nfs_store_stats *nfs_store_get_stats(const nfs_store_ops *ops) {
+    return stats_of(ops);
+}
+
+// fara stdio, ca sa mearga din handler-ul de semnal
+static char *put_str(char *p, char *end, const char *s) {
+    while (*s && p < end) *p++ = *s++;
+    return p;
+}
+
+static char *put_num(char *p, char *end, uint64_t v) {
+    char digits[24];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n && p < end) *p++ = digits[--n];
+    return p;
+}
+
+void nfs_store_report(int fd) {
+    char buf[2048];
+    char *p = buf, *end = buf + sizeof(buf);
+    for (int i = 0; i < BACKEND_COUNT; i++) {
+        const nfs_store_stats *st = &backends[i].stats;
+        uint64_t calls = 0;
+        for (int op = 0; op < STORE_OP_COUNT; op++) calls += st->calls[op];
+        if (!calls) continue;
+
+        p = put_str(p, end, "store ");
+        p = put_str(p, end, backends[i].ops->name);
+        p = put_str(p, end, ": read ");
+        p = put_num(p, end, st->bytes_read);
+        p = put_str(p, end, " B, written ");
+        p = put_num(p, end, st->bytes_written);
+        p = put_str(p, end, " B\n");
+        for (int op = 0; op < STORE_OP_COUNT; op++) {
+            if (!st->calls[op]) continue;
+            p = put_str(p, end, "  ");
+            p = put_str(p, end, op_names[op]);
+            p = put_str(p, end, ": ");
+            p = put_num(p, end, st->calls[op]);
+            p = put_str(p, end, " calls, ");
+            p = put_num(p, end, st->errors[op]);
+            p = put_str(p, end, " failed, ");
+            p = put_num(p, end, st->nsec[op] / 1000);
+            p = put_str(p, end, " us\n");
+        }
+    }
+    ssize_t ignored = write(fd, buf, (size_t)(p - buf));
+    (void)ignored;
+}
@@ -0,0 +1,91 @@
+#ifndef NFS_STORE_H
+#define NFS_STORE_H
+
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+// accesul procedurilor serverului la fisierele partajate trece printr-un
+// backend (tabela de functii): pe disc (nfs_store_posix.c, cu depozitul
+// deduplicat daca e activ) sau in memorie (nfs_store_mem.c). Un backend nou
+// se adauga in lista din nfs_store.c si se alege per export, fara sa se
+// atinga procedurile. Scrierile intr-un export read-only dau EROFS.
+// Erorile se intorc ca la apelurile POSIX, cu -1 si errno
+
+#define STORE_WRITE 1   // fisierul se creeaza daca lipseste
+#define STORE_TRUNC 2   // continutul vechi se pierde
+
+typedef struct nfs_store_ops nfs_store_ops;
+
+// un fisier deschis traieste doar cat un apel
+typedef struct {
+    const nfs_store_ops *ops;   // backend-ul exportului in care e fisierul
+    int fd;                     // pe disc
+    void *obj;                  // in memorie
+} nfs_store_file;
+
+// pt fiecare intrare din director, fara . / .. / .cas; st poate fi NULL
+// (pe disc), cine are nevoie de el face nfs_store_stat. Nonzero opreste listarea
+typedef int (*nfs_store_dir_fn)(const char *name, const struct stat *st, void *ctx);
+
+struct nfs_store_ops {
+    const char *name;
+    int (*open)(const char *path, int flags, nfs_store_file *f);
+    void (*close)(nfs_store_file *f);
+    ssize_t (*pread)(nfs_store_file *f, void *buf, size_t len, off_t off);
+    ssize_t (*pwrite)(nfs_store_file *f, const void *buf, size_t len, off_t off);
+    int (*fstat)(nfs_store_file *f, struct stat *st);
+    int (*ftruncate)(nfs_store_file *f, off_t size);
+    // urmatoarea zona cu date de la pos, pana la size; 0 daca nu mai sunt
+    int (*next_data)(nfs_store_file *f, off_t pos, off_t size, off_t *start, off_t *end);
+    // ca lstat, cu dimensiunea vazuta de clienti
+    int (*stat)(const char *path, struct stat *st);
+    int (*mkdir)(const char *path);
+    // fisier sau director gol; cu recursive, tot subarborele
+    int (*remove)(const char *path, int recursive);
+    int (*readdir)(const char *dir, nfs_store_dir_fn fn, void *ctx);
+};
+
+extern const nfs_store_ops nfs_store_posix;
+extern const nfs_store_ops nfs_store_mem;
+
+// contoare pt compararea backend-urilor: apeluri si timpul petrecut in ele
+enum {
+    STORE_OP_OPEN, STORE_OP_READ, STORE_OP_WRITE, STORE_OP_STAT,
+    STORE_OP_TRUNCATE, STORE_OP_READDIR, STORE_OP_MKDIR, STORE_OP_REMOVE,
+    STORE_OP_COUNT
+};
+
+typedef struct {
+    uint64_t calls[STORE_OP_COUNT];
+    uint64_t nsec[STORE_OP_COUNT];
+    uint64_t errors[STORE_OP_COUNT];
+    uint64_t bytes_read, bytes_written;
+} nfs_store_stats;
+
+// backend-ul dupa numele din configurare; NULL daca nu exista
+const nfs_store_ops *nfs_store_by_name(const char *name);
+
+// backend-ul exportului in care se afla path (nfs_export_find)
+const nfs_store_ops *nfs_store_for(const char *path);
+
+int nfs_store_open(const char *path, int flags, nfs_store_file *f);
+void nfs_store_close(nfs_store_file *f);
+ssize_t nfs_store_pread(nfs_store_file *f, void *buf, size_t len, off_t off);
+ssize_t nfs_store_pwrite(nfs_store_file *f, const void *buf, size_t len, off_t off);
+int nfs_store_fstat(nfs_store_file *f, struct stat *st);
+int nfs_store_ftruncate(nfs_store_file *f, off_t size);
+int nfs_store_next_data(nfs_store_file *f, off_t pos, off_t size, off_t *start, off_t *end);
+int nfs_store_stat(const char *path, struct stat *st);
+int nfs_store_mkdir(const char *path);
+int nfs_store_remove(const char *path, int recursive);
+int nfs_store_readdir(const char *dir, nfs_store_dir_fn fn, void *ctx);
+
+// contoarele unui backend, adunate de la pornire
+const nfs_store_stats *nfs_store_get_stats(const nfs_store_ops *ops);
+
+// scrie pe fd contoarele backend-urilor folosite; doar cu write(), se poate
+// apela si dintr-un handler de semnal
+void nfs_store_report(int fd);
+
+#endif
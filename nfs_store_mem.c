@@ -0,0 +1,62 @@
+#include "nfs_mem.h"
+#include "nfs_store.h"
+
+// backend-ul din memorie (serverul pornit cu -m), peste nfs_mem
+
+static int mem_open(const char *path, int flags, nfs_store_file *f) {
+    f->fd = -1;
+    f->obj = flags ? nfs_mem_create(path, flags & STORE_TRUNC) : nfs_mem_lookup(path);
+    return f->obj ? 0 : -1;
+}
+
+static void mem_close(nfs_store_file *f) {
+    f->obj = NULL;
+}
+
+static ssize_t mem_pread(nfs_store_file *f, void *buf, size_t len, off_t off) {
+    return nfs_mem_pread(f->obj, buf, len, off);
+}
+
+static ssize_t mem_pwrite(nfs_store_file *f, const void *buf, size_t len, off_t off) {
+    return nfs_mem_pwrite(f->obj, buf, len, off);
+}
+
+static int mem_fstat(nfs_store_file *f, struct stat *st) {
+    nfs_mem_stat(f->obj, st);
+    return 0;
+}
+
+static int mem_ftruncate(nfs_store_file *f, off_t size) {
+    return nfs_mem_truncate(f->obj, size);
+}
+
+static int mem_next_data(nfs_store_file *f, off_t pos, off_t size, off_t *start, off_t *end) {
+    (void)size;
+    return nfs_mem_next_data(f->obj, pos, start, end);
+}
+
+static int mem_stat(const char *path, struct stat *st) {
+    nfs_mem_node *n = nfs_mem_lookup(path);
+    if (!n) return -1;
+    nfs_mem_stat(n, st);
+    return 0;
+}
+
+static int mem_remove(const char *path, int recursive) {
+    return nfs_mem_remove(path, recursive);
+}
+
+const nfs_store_ops nfs_store_mem = {
+    .name = "mem",
+    .open = mem_open,
+    .close = mem_close,
+    .pread = mem_pread,
+    .pwrite = mem_pwrite,
+    .fstat = mem_fstat,
+    .ftruncate = mem_ftruncate,
+    .next_data = mem_next_data,
+    .stat = mem_stat,
+    .mkdir = nfs_mem_mkdir,
+    .remove = mem_remove,
+    .readdir = nfs_mem_readdir,
+};
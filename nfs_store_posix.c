@@ -0,0 +1,135 @@
+#define _GNU_SOURCE   // SEEK_DATA / SEEK_HOLE
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "nfs_cas.h"
+#include "nfs_store.h"
+
+// backend-ul pe disc; cu depozitul deduplicat activ, un manifest se vede ca
+// fisierul pe care il descrie
+
+static int posix_open(const char *path, int flags, nfs_store_file *f) {
+    f->fd = -1;
+    f->obj = NULL;
+    if (!flags) {
+        // un manifest se citeste ca fisierul pe care il descrie
+        f->fd = nfs_cas_open(path);
+        return f->fd >= 0 ? 0 : -1;
+    }
+    // fisierul deduplicat redevine obisnuit inainte de scriere; golit, nu mai conteaza
+    if (!(flags & STORE_TRUNC) && nfs_cas_unpack(path) != 0) return -1;
+    f->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC | (flags & STORE_TRUNC ? O_TRUNC : 0), 0666);
+    return f->fd >= 0 ? 0 : -1;
+}
+
+static void posix_close(nfs_store_file *f) {
+    if (f->fd >= 0) close(f->fd);
+    f->fd = -1;
+}
+
+static ssize_t posix_pread(nfs_store_file *f, void *buf, size_t len, off_t off) {
+    return pread(f->fd, buf, len, off);
+}
+
+static ssize_t posix_pwrite(nfs_store_file *f, const void *buf, size_t len, off_t off) {
+    return pwrite(f->fd, buf, len, off);
+}
+
+static int posix_fstat(nfs_store_file *f, struct stat *st) {
+    return fstat(f->fd, st);
+}
+
+static int posix_ftruncate(nfs_store_file *f, off_t size) {
+    return ftruncate(f->fd, size);
+}
+
+static int posix_next_data(nfs_store_file *f, off_t pos, off_t size, off_t *start, off_t *end) {
+    if (pos >= size) return 0;
+    off_t data = lseek(f->fd, pos, SEEK_DATA);
+    if (data < 0) {
+        if (errno == ENXIO) return 0;   // doar gaura pana la sfarsit
+        data = pos;                     // fs fara SEEK_DATA, totul e date
+    }
+    off_t hole = lseek(f->fd, data, SEEK_HOLE);
+    if (hole < 0 || hole > size) hole = size;
+    *start = data;
+    *end = hole;
+    return 1;
+}
+
+static int posix_stat(const char *path, struct stat *st) {
+    if (lstat(path, st) != 0) return -1;
+    st->st_size = nfs_cas_size(AT_FDCWD, path, st);
+    return 0;
+}
+
+static int posix_mkdir(const char *path) {
+    return mkdir(path, 0777);
+}
+
+static int remove_tree(const char *path) {
+    struct stat statbuf;
+    if (stat(path, &statbuf) != 0) {
+        return -1;
+    }
+    if (S_ISDIR(statbuf.st_mode)) {
+        DIR *dir = opendir(path);
+        if (!dir) return -1;
+        struct dirent *entry;
+        int ret = 0;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+                continue;
+            char child_path[PATH_MAX];
+            snprintf(child_path, sizeof(child_path), "%s/%s", path, entry->d_name);
+            if (remove_tree(child_path) != 0) {
+                ret = -1;
+            }
+        }
+        closedir(dir);
+        if (rmdir(path) != 0) {
+            ret = -1;
+        }
+        return ret;
+    } else {
+        // nu e folder, sterge fisierul
+        return remove(path);
+    }
+}
+
+static int posix_remove(const char *path, int recursive) {
+    return recursive ? remove_tree(path) : remove(path);
+}
+
+static int posix_readdir(const char *dir, nfs_store_dir_fn fn, void *ctx) {
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0 ||
+            strcmp(entry->d_name, NFS_CAS_DIR) == 0)
+            continue;
+        if (fn(entry->d_name, NULL, ctx) != 0) break;
+    }
+    closedir(d);
+    return 0;
+}
+
+const nfs_store_ops nfs_store_posix = {
+    .name = "posix",
+    .open = posix_open,
+    .close = posix_close,
+    .pread = posix_pread,
+    .pwrite = posix_pwrite,
+    .fstat = posix_fstat,
+    .ftruncate = posix_ftruncate,
+    .next_data = posix_next_data,
+    .stat = posix_stat,
+    .mkdir = posix_mkdir,
+    .remove = posix_remove,
+    .readdir = posix_readdir,
+};
@@ -0,0 +1,184 @@
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "nfs_trace.h"
+
+static nfs_trace_rec *ring = NULL;
+static uint64_t written = 0;        // inregistrari terminate de la pornire
+static nfs_trace_rec *cur = NULL;
+static const char *trace_file;
+
+// numele procedurilor, dupa numarul din nfs.x
+static const char *proc_names[] = {
+    "null", "ls", "create", "delete", "retrieve_file", "send_file", "mkdir", "remdir",
+    "read", "write", "readdir", "bulk_read", "extents", "truncate", "signatures",
+    "checksum", "codecs", "has_chunks", "put_chunk", "put_manifest", "lock", "unlock",
+    "lease", "renew", "watch", "list", "find", "du", "getattr"
+};
+#define PROC_NAMES (sizeof(proc_names) / sizeof(proc_names[0]))
+
+static const char *stage_names[TRACE_STAGES] = {
+    "recv", "queue", "decode", "handler", "io", "encode", "send"
+};
+
+int nfs_trace_init(const char *file) {
+    ring = calloc(TRACE_RECORDS, sizeof(*ring));
+    if (!ring) {
+        perror("nfs_trace_init");
+        return -1;
+    }
+    trace_file = file;
+    return 0;
+}
+
+int nfs_trace_enabled(void) {
+    return ring != NULL;
+}
+
+uint64_t nfs_trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void nfs_trace_begin(uint32_t xid, uint32_t proc, int lane, const struct sockaddr_storage *from,
+                     uint64_t recv, uint64_t recv_dur, uint32_t bytes_in) {
+    if (!ring) return;
+    cur = &ring[written % TRACE_RECORDS];
+    memset(cur, 0, sizeof(*cur));
+    cur->xid = xid;
+    cur->proc = (uint16_t)proc;
+    cur->lane = (uint8_t)lane;
+    cur->family = from->ss_family;
+    if (from->ss_family == AF_INET) {
+        const struct sockaddr_in *in = (const struct sockaddr_in *)from;
+        memcpy(cur->addr, &in->sin_addr, 4);
+        cur->port = ntohs(in->sin_port);
+    } else if (from->ss_family == AF_INET6) {
+        const struct sockaddr_in6 *in6 = (const struct sockaddr_in6 *)from;
+        memcpy(cur->addr, &in6->sin6_addr, 16);
+        cur->port = ntohs(in6->sin6_port);
+    }
+    cur->bytes_in = bytes_in;
+    cur->start[TRACE_RECV] = recv;
+    cur->dur[TRACE_RECV] = recv_dur;
+}
+
+void nfs_trace_stage(int stage, uint64_t start, uint64_t end) {
+    if (!cur) return;
+    if (stage == TRACE_IO && cur->start[stage]) {
+        cur->dur[stage] += end - start;
+        return;
+    }
+    cur->start[stage] = start;
+    cur->dur[stage] = end - start;
+}
+
+void nfs_trace_bytes_out(uint32_t bytes) {
+    if (cur) cur->bytes_out += bytes;
+}
+
+void nfs_trace_end(int status) {
+    if (!cur) return;
+    cur->status = (uint8_t)status;
+    cur = NULL;
+    written++;
+}
+
+static void write_binary(FILE *f, uint64_t first, uint64_t count) {
+    nfs_trace_header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+    h.version = TRACE_VERSION;
+    h.record_size = sizeof(nfs_trace_rec);
+    h.count = (uint32_t)count;
+    h.pid = (uint32_t)getpid();
+    fwrite(&h, sizeof(h), 1, f);
+    for (uint64_t i = first; i < first + count; i++)
+        fwrite(&ring[i % TRACE_RECORDS], sizeof(nfs_trace_rec), 1, f);
+}
+
+static void put_event(FILE *f, const char *name, const char *cat, uint64_t start, uint64_t dur,
+                      int pid) {
+    fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+               "\"pid\":%d,\"tid\":0}", name, cat, start / 1e3, dur / 1e3, pid);
+}
+
+// chrome://tracing: etapele de pe firul serverului sunt imbricate in cererea
+// lor; asteptarea in coada se suprapune intre cereri, deci e eveniment async
+static void write_json(FILE *f, uint64_t first, uint64_t count) {
+    int pid = (int)getpid();
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+               "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+               "\"args\":{\"name\":\"nfs_server %d\"}}", pid, pid);
+    for (uint64_t i = first; i < first + count; i++) {
+        const nfs_trace_rec *r = &ring[i % TRACE_RECORDS];
+        char host[INET6_ADDRSTRLEN] = "?";
+        if (r->family == AF_INET || r->family == AF_INET6)
+            inet_ntop(r->family, r->addr, host, sizeof(host));
+        char name[64];
+        const char *proc = r->proc < PROC_NAMES ? proc_names[r->proc] : "unknown";
+        snprintf(name, sizeof(name), "%s%s", proc, r->status == TRACE_REJECTED ? " rejected" : "");
+
+        put_event(f, stage_names[TRACE_RECV], "net", r->start[TRACE_RECV], r->dur[TRACE_RECV], pid);
+        if (r->start[TRACE_QUEUE]) {
+            fprintf(f, ",\n{\"name\":\"queue\",\"cat\":\"queue\",\"ph\":\"b\",\"id\":%llu,"
+                       "\"ts\":%.3f,\"pid\":%d,\"tid\":0}",
+                    (unsigned long long)i, r->start[TRACE_QUEUE] / 1e3, pid);
+            fprintf(f, ",\n{\"name\":\"queue\",\"cat\":\"queue\",\"ph\":\"e\",\"id\":%llu,"
+                       "\"ts\":%.3f,\"pid\":%d,\"tid\":0}",
+                    (unsigned long long)i, (r->start[TRACE_QUEUE] + r->dur[TRACE_QUEUE]) / 1e3, pid);
+        }
+
+        // cererea: procedura, sau doar raspunsul "ocupat" daca a fost respinsa
+        uint64_t start = r->start[TRACE_HANDLER], end = start + r->dur[TRACE_HANDLER];
+        if (!start) {
+            start = r->start[TRACE_ENCODE];
+            end = r->start[TRACE_SEND] ? r->start[TRACE_SEND] + r->dur[TRACE_SEND]
+                                       : start + r->dur[TRACE_ENCODE];
+        }
+        if (start)
+            fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"request\",\"ph\":\"X\",\"ts\":%.3f,"
+                       "\"dur\":%.3f,\"pid\":%d,\"tid\":0,\"args\":{\"client\":\"%s:%u\","
+                       "\"xid\":%u,\"lane\":\"%s\",\"bytes_in\":%u,\"bytes_out\":%u,"
+                       "\"queue_us\":%.3f,\"io_us\":%.3f}}",
+                    name, start / 1e3, (end - start) / 1e3, pid, host, r->port, r->xid,
+                    r->lane ? "transfer" : "metadata", r->bytes_in, r->bytes_out,
+                    r->dur[TRACE_QUEUE] / 1e3, r->dur[TRACE_IO] / 1e3);
+        for (int s = TRACE_DECODE; s < TRACE_STAGES; s++)
+            if (s != TRACE_HANDLER && r->start[s])
+                put_event(f, stage_names[s], "stage", r->start[s], r->dur[s], pid);
+    }
+    fprintf(f, "\n]}\n");
+}
+
+int nfs_trace_dump(int worker) {
+    if (!ring) return -1;
+    char path[4096], tmp[4112];
+    if (worker > 0) snprintf(path, sizeof(path), "%s.%d", trace_file, worker);
+    else snprintf(path, sizeof(path), "%s", trace_file);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    FILE *f = fopen(tmp, "w");
+    if (!f) {
+        fprintf(stderr, "Error: cannot write %s: %s\n", tmp, strerror(errno));
+        return -1;
+    }
+    uint64_t count = written < TRACE_RECORDS ? written : TRACE_RECORDS;
+    uint64_t first = written - count;
+    size_t len = strlen(trace_file);
+    if (len > 5 && strcmp(trace_file + len - 5, ".json") == 0) write_json(f, first, count);
+    else write_binary(f, first, count);
+    int failed = ferror(f);
+    if (fclose(f) != 0 || failed || rename(tmp, path) != 0) {
+        fprintf(stderr, "Error: cannot write %s: %s\n", path, strerror(errno));
+        unlink(tmp);
+        return -1;
+    }
+    printf("Trace: %llu requests written to %s.\n", (unsigned long long)count, path);
+    return 0;
+}
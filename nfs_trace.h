@@ -0,0 +1,82 @@
+#ifndef NFS_TRACE_H
+#define NFS_TRACE_H
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+// urmarirea fiecarei cereri prin server, fara printf pe calea cererii: cand
+// a sosit, cat a stat in coada, decodarea argumentelor, procedura, timpul in
+// backend-ul de stocare, codarea si trimiterea raspunsului. Inregistrarile
+// intra intr-un inel de TRACE_RECORDS (cele vechi se suprascriu) si se scriu
+// in fisier doar la cerere (kill -USR1) si la oprire.
+//
+// Serverul executa cererile pe un singur fir (workerii -w sunt procese),
+// asa ca fiecare proces are inelul lui si il scrie fara blocari.
+//
+// Fisierul e JSON pt chrome://tracing / Perfetto daca numele se termina in
+// .json, altfel binar: un nfs_trace_header urmat de count inregistrari
+// nfs_trace_rec, de la cea mai veche, in ordinea bytes a masinii. Cu -w,
+// worker-ul N > 0 scrie in fisier.N
+
+#define TRACE_RECORDS 16384
+#define TRACE_MAGIC "NFSTRACE"
+#define TRACE_VERSION 1
+
+// etapele, in ordinea in care apar
+enum {
+    TRACE_RECV,         // recvfrom
+    TRACE_QUEUE,        // in coada planificatorului
+    TRACE_DECODE,       // argumentele (svc_getargs)
+    TRACE_HANDLER,      // procedura, cu tot ce urmeaza
+    TRACE_IO,           // apelurile nfs_store_*, adunate, de la primul
+    TRACE_ENCODE,       // raspunsul (xdr_replymsg)
+    TRACE_SEND,         // sendto
+    TRACE_STAGES
+};
+
+enum { TRACE_DONE, TRACE_REJECTED };
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t count;
+    uint32_t pid;
+} nfs_trace_header;
+
+typedef struct {
+    uint32_t xid;
+    uint16_t proc;
+    uint8_t lane;               // 0 metadate, 1 transferuri (nfs_sched)
+    uint8_t status;             // TRACE_DONE / TRACE_REJECTED
+    uint16_t family;            // AF_INET / AF_INET6
+    uint16_t port;
+    uint8_t addr[16];           // adresa clientului, IPv4 in primii 4 bytes
+    uint32_t bytes_in, bytes_out;
+    // CLOCK_MONOTONIC in ns; start 0 = etapa nu a avut loc
+    uint64_t start[TRACE_STAGES];
+    uint64_t dur[TRACE_STAGES];
+} nfs_trace_rec;
+
+// -t: aloca inelul; fara apel, restul functiilor nu fac nimic
+int nfs_trace_init(const char *file);
+int nfs_trace_enabled(void);
+
+uint64_t nfs_trace_now(void);
+
+// deschide inregistrarea cererii care se executa acum; recv e inceputul
+// lui recvfrom, recv_dur cat a durat
+void nfs_trace_begin(uint32_t xid, uint32_t proc, int lane, const struct sockaddr_storage *from,
+                     uint64_t recv, uint64_t recv_dur, uint32_t bytes_in);
+
+// o etapa a cererii curente; TRACE_IO se aduna
+void nfs_trace_stage(int stage, uint64_t start, uint64_t end);
+void nfs_trace_bytes_out(uint32_t bytes);
+
+// inchide inregistrarea curenta
+void nfs_trace_end(int status);
+
+// scrie inelul in fisier; worker 0 = fara sufix
+int nfs_trace_dump(int worker);
+
+#endif
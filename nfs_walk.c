@@ -0,0 +1,146 @@
+#define _GNU_SOURCE   // O_DIRECTORY
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "nfs_cas.h"
+#include "nfs_mem.h"
+#include "nfs_store.h"
+#include "nfs_walk.h"
+
+typedef struct walk_dir {
+    char *rel;
+    struct walk_dir *next;
+} walk_dir;
+
+typedef struct {
+    int root_fd;
+    nfs_walk_fn visit;
+    void *ctx;
+    pthread_mutex_t lock;       // coada, busy si apelurile visit
+    pthread_cond_t cond;
+    walk_dir *queue;
+    int busy;                   // directoare in coada sau in lucru
+} walk_state;
+
+// cu lock tinut
+static void push(walk_state *w, const char *rel) {
+    walk_dir *d = malloc(sizeof(*d));
+    if (!d || !(d->rel = strdup(rel))) {
+        free(d);
+        return;
+    }
+    d->next = w->queue;
+    w->queue = d;
+    w->busy++;
+    pthread_cond_signal(&w->cond);
+}
+
+// "./shared/./a/../b" si "./shared/b" trebuie sa fie aceeasi cheie
+void nfs_path_normalize(const char *in, char *out, size_t outlen) {
+    size_t len = 0;
+    out[0] = '\0';
+    while (*in) {
+        while (*in == '/') in++;
+        const char *seg = in;
+        while (*in && *in != '/') in++;
+        size_t n = in - seg;
+
+        if (n == 0 || (n == 1 && seg[0] == '.')) continue;
+        if (n == 2 && seg[0] == '.' && seg[1] == '.') {
+            char *slash = strrchr(out, '/');
+            len = slash ? (size_t)(slash - out) : 0;
+            out[len] = '\0';
+            continue;
+        }
+        if (len + n + 2 > outlen) break;
+        if (len) out[len++] = '/';
+        memcpy(out + len, seg, n);
+        len += n;
+        out[len] = '\0';
+    }
+}
+
+static void walk_one(walk_state *w, const char *rel) {
+    int fd = openat(w->root_fd, *rel ? rel : ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return;
+    DIR *d = fdopendir(fd);
+    if (!d) {
+        close(fd);
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0 ||
+            (!*rel && strcmp(entry->d_name, NFS_CAS_DIR) == 0))
+            continue;
+
+        struct stat st;
+        if (fstatat(fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+        st.st_size = nfs_cas_size(fd, entry->d_name, &st);
+
+        char child[PATH_MAX];
+        int n = *rel ? snprintf(child, sizeof(child), "%s/%s", rel, entry->d_name)
+                     : snprintf(child, sizeof(child), "%s", entry->d_name);
+        if (n < 0 || (size_t)n >= sizeof(child)) continue;
+
+        pthread_mutex_lock(&w->lock);
+        if (w->visit(child, &st, w->ctx) == 0 && S_ISDIR(st.st_mode))
+            push(w, child);
+        pthread_mutex_unlock(&w->lock);
+    }
+    closedir(d);
+}
+
+static void *worker(void *arg) {
+    walk_state *w = arg;
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (!w->queue && w->busy > 0) pthread_cond_wait(&w->cond, &w->lock);
+        if (!w->queue) break;   // busy == 0: nu mai are cine sa adauge
+
+        walk_dir *d = w->queue;
+        w->queue = d->next;
+        pthread_mutex_unlock(&w->lock);
+        walk_one(w, d->rel);
+        free(d->rel);
+        free(d);
+        pthread_mutex_lock(&w->lock);
+        if (--w->busy == 0) pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+int nfs_walk(const char *root, nfs_walk_fn visit, void *ctx) {
+    // in memorie nu e nimic de asteptat, parcurgerea ramane pe un fir
+    if (nfs_store_for(root) == &nfs_store_mem) return nfs_mem_walk(root, visit, ctx);
+
+    walk_state w;
+    memset(&w, 0, sizeof(w));
+    w.root_fd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (w.root_fd < 0) return -1;
+    w.visit = visit;
+    w.ctx = ctx;
+    pthread_mutex_init(&w.lock, NULL);
+    pthread_cond_init(&w.cond, NULL);
+    push(&w, "");
+
+    // firul apelant lucreaza si el; daca nu se pot crea fire, merge si singur
+    pthread_t tids[WALK_THREADS - 1];
+    int started = 0;
+    for (int i = 0; i < WALK_THREADS - 1; i++)
+        if (pthread_create(&tids[started], NULL, worker, &w) == 0) started++;
+    worker(&w);
+    for (int i = 0; i < started; i++) pthread_join(tids[i], NULL);
+
+    pthread_mutex_destroy(&w.lock);
+    pthread_cond_destroy(&w.cond);
+    close(w.root_fd);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef NFS_WALK_H
+#define NFS_WALK_H
+
+#include <stddef.h>
+#include <sys/stat.h>
+
+// parcurgere in paralel a unui subarbore: WALK_THREADS fire iau directoare
+// dintr-o coada comuna si le citesc cu fstatat fata de fd-ul directorului.
+// Legaturile simbolice nu se urmeaza, iar .cas din radacina e sarit
+
+#define WALK_THREADS 4
+
+// cheie unica pt o cale: fara "." si "//", cu ".." rezolvat
+void nfs_path_normalize(const char *in, char *out, size_t outlen);
+
+// apelat pe rand (niciodata din doua fire deodata) pt fiecare intrare; rel e
+// calea fata de radacina, st_size e dimensiunea vazuta de clienti.
+// Pt un director, nonzero = nu se coboara in el
+typedef int (*nfs_walk_fn)(const char *rel, const struct stat *st, void *ctx);
+
+// -1 daca root nu se poate deschide; cu serverul in memorie merge prin nfs_mem_walk
+int nfs_walk(const char *root, nfs_walk_fn visit, void *ctx);
+
+#endif
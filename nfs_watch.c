@@ -0,0 +1,194 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <time.h>
+#include <unistd.h>
+#include "nfs_cas.h"
+#include "nfs_mem.h"
+#include "nfs_store.h"
+#include "nfs_watch.h"
+
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+#define MAX_WATCH_DIRS 256
+#define OVERFLOW_WD -1          // coada inotify a pierdut evenimente, pt toate directoarele
+#define MEM_WD_BASE (1 << 30)   // directoarele din memorie, peste wd-urile de la inotify
+
+typedef struct {
+    int wd;
+    int type;                   // EV_*
+    char name[MAX_FILENAME_LENGTH + 1];
+} log_entry;
+
+static log_entry event_log[WATCH_LOG_SIZE];
+static u_int next_seq = 1;      // cookie-ul 0 e rezervat pt abonare
+static u_int oldest_seq = 1;    // cel mai vechi eveniment inca in jurnal
+
+static struct {
+    int wd;
+    time_t last_poll;
+} dirs[MAX_WATCH_DIRS];
+static int dir_count = 0;
+static int inotify_fd = -1;
+
+static void log_event(int wd, int type, const char *name) {
+    // scrierea pe chunk-uri da un IN_MODIFY pt fiecare chunk
+    if (next_seq > oldest_seq) {
+        log_entry *last = &event_log[(next_seq - 1) % WATCH_LOG_SIZE];
+        if (last->wd == wd && last->type == type && strcmp(last->name, name) == 0) return;
+    }
+    log_entry *e = &event_log[next_seq % WATCH_LOG_SIZE];
+    e->wd = wd;
+    e->type = type;
+    snprintf(e->name, sizeof(e->name), "%s", name);
+    next_seq++;
+    if (next_seq - oldest_seq > WATCH_LOG_SIZE) oldest_seq = next_seq - WATCH_LOG_SIZE;
+}
+
+static void forget_dir(int wd) {
+    for (int i = 0; i < dir_count; i++) {
+        if (dirs[i].wd == wd) {
+            dirs[i] = dirs[--dir_count];
+            return;
+        }
+    }
+}
+
+// tot ce s-a strans in coada inotify de la ultimul apel
+static void drain(void) {
+    char buf[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t n;
+    while ((n = read(inotify_fd, buf, sizeof(buf))) > 0) {
+        for (char *p = buf; p < buf + n; ) {
+            struct inotify_event *ev = (struct inotify_event *)p;
+            p += sizeof(*ev) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                log_event(OVERFLOW_WD, 0, "");
+                continue;
+            }
+            if (ev->mask & IN_IGNORED) {
+                forget_dir(ev->wd);
+                continue;
+            }
+            if (ev->len == 0 || strcmp(ev->name, NFS_CAS_DIR) == 0) continue;
+
+            int type = EV_MODIFY;
+            if (ev->mask & IN_CREATE) type = EV_CREATE;
+            else if (ev->mask & IN_DELETE) type = EV_DELETE;
+            else if (ev->mask & IN_MOVED_FROM) type = EV_RENAME_FROM;
+            else if (ev->mask & IN_MOVED_TO) type = EV_RENAME_TO;
+            log_event(ev->wd, type, ev->name);
+        }
+    }
+}
+
+// 1 daca directorul era deja urmarit
+static int touch_dir(int wd) {
+    time_t now = time(NULL);
+    for (int i = 0; i < dir_count; i++) {
+        if (dirs[i].wd == wd) {
+            dirs[i].last_poll = now;
+            return 1;
+        }
+    }
+    if (dir_count < MAX_WATCH_DIRS) {
+        dirs[dir_count].wd = wd;
+        dirs[dir_count].last_poll = now;
+        dir_count++;
+    }
+    return 0;
+}
+
+// directoarele pe care nu le mai cere nimeni nu mai tin evenimente in jurnal
+static void sweep(void) {
+    time_t now = time(NULL);
+    for (int i = 0; i < dir_count; ) {
+        if (now - dirs[i].last_poll > WATCH_IDLE) {
+            if (dirs[i].wd < MEM_WD_BASE) inotify_rm_watch(inotify_fd, dirs[i].wd);
+            dirs[i] = dirs[--dir_count];
+        } else {
+            i++;
+        }
+    }
+}
+
+void nfs_watch_note(ino_t dir, int type, const char *name) {
+    for (int i = 0; i < dir_count; i++) {
+        if (dirs[i].wd == MEM_WD_BASE + (int)dir) {
+            log_event(dirs[i].wd, type, name);
+            return;
+        }
+    }
+}
+
+// wd-ul directorului: de la inotify, sau in memorie dupa inode-ul nodului
+static int dir_wd(const char *dir) {
+    if (nfs_store_for(dir) == &nfs_store_mem) {
+        struct stat st;
+        nfs_mem_node *n = nfs_mem_lookup(dir);
+        if (!n) return -1;
+        nfs_mem_stat(n, &st);
+        return S_ISDIR(st.st_mode) ? MEM_WD_BASE + (int)st.st_ino : -1;
+    }
+
+    // acelasi inode da acelasi wd, oricum ar fi scrisa calea
+    int wd = inotify_add_watch(inotify_fd, dir, WATCH_MASK);
+    if (wd < 0) perror("nfs_watch_poll inotify_add_watch");
+    return wd;
+}
+
+int nfs_watch_poll(const char *dir, u_int cookie, u_int budget, watch_result *res) {
+    if (nfs_store_for(dir) != &nfs_store_mem) {
+        if (inotify_fd < 0) {
+            inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (inotify_fd < 0) {
+                perror("nfs_watch_poll inotify_init1");
+                return -1;
+            }
+        }
+        drain();
+    }
+    sweep();
+
+    int wd = dir_wd(dir);
+    if (wd < 0) return -1;
+    int known = touch_dir(wd);
+
+    res->cookie = next_seq;
+    if (cookie == 0) return 0;
+    if (!known || cookie < oldest_seq || cookie > next_seq) {
+        // watch-ul expirase sau jurnalul s-a rotit peste cookie
+        res->overflow = TRUE;
+        return 0;
+    }
+
+    res->events.events_val = calloc(MAX_EVENTS, sizeof(watch_event));
+    if (!res->events.events_val) return -1;
+
+    // antet: status, cookie, overflow, lungime array, more
+    budget = budget > 20 ? budget - 20 : 0;
+    u_int seq;
+    for (seq = cookie; seq < next_seq; seq++) {
+        log_entry *e = &event_log[seq % WATCH_LOG_SIZE];
+        if (e->wd == OVERFLOW_WD) {
+            res->overflow = TRUE;
+            continue;
+        }
+        if (e->wd != wd) continue;
+
+        u_int cost = 4 + 4 + (((u_int)strlen(e->name) + 3) & ~3u);
+        if (res->events.events_len == MAX_EVENTS || cost > budget) {
+            res->more = TRUE;
+            break;
+        }
+        watch_event *out = &res->events.events_val[res->events.events_len++];
+        out->type = e->type;
+        out->name = strdup(e->name);
+        budget -= cost;
+    }
+    res->cookie = seq;
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef NFS_WATCH_H
+#define NFS_WATCH_H
+
+#include <sys/types.h>
+#include "nfs.h"
+
+// schimbari in directoare, prin inotify; evenimentele se pastreaza intr-un
+// jurnal circular numerotat, iar fiecare client citeste de la cookie-ul lui.
+// Un director nu mai e urmarit daca nimeni nu l-a mai cerut de WATCH_IDLE s
+
+#define WATCH_LOG_SIZE 4096
+#define WATCH_IDLE 120
+
+// umple res cu evenimentele din dir de la cookie incoace, in limita a
+// budget bytes XDR; cookie 0 = doar abonarea. -1 daca dir nu se poate urmari
+int nfs_watch_poll(const char *dir, u_int cookie, u_int budget, watch_result *res);
+
+// cu serverul in memorie nu exista inotify: evenimentul vine de la nfs_mem
+void nfs_watch_note(ino_t dir, int type, const char *name);
+
+#endif
@@ -12,56 +12,80 @@ xdr_request (XDR *xdrs, request *objp)
 
 
 	if (xdrs->x_op == XDR_ENCODE) {
-		 if (!xdr_string (xdrs, &objp->filename, FILENAME_LENGTH))
+		 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
 			 return FALSE;
-		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
 		if (buf == NULL) {
-			 if (!xdr_int (xdrs, &objp->start))
+			 if (!xdr_u_int (xdrs, &objp->size))
 				 return FALSE;
-			 if (!xdr_int (xdrs, &objp->src_offset))
+			 if (!xdr_u_int (xdrs, &objp->src_offset))
 				 return FALSE;
-			 if (!xdr_int (xdrs, &objp->dest_offset))
+			 if (!xdr_u_int (xdrs, &objp->dest_offset))
 				 return FALSE;
-			 if (!xdr_int (xdrs, &objp->size))
+			 if (!xdr_int (xdrs, &objp->codec))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->level))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->want_crc))
 				 return FALSE;
+
 		} else {
-			IXDR_PUT_LONG(buf, objp->start);
-			IXDR_PUT_LONG(buf, objp->src_offset);
-			IXDR_PUT_LONG(buf, objp->dest_offset);
-			IXDR_PUT_LONG(buf, objp->size);
+		IXDR_PUT_U_LONG(buf, objp->size);
+		IXDR_PUT_U_LONG(buf, objp->src_offset);
+		IXDR_PUT_U_LONG(buf, objp->dest_offset);
+		IXDR_PUT_LONG(buf, objp->codec);
+		IXDR_PUT_LONG(buf, objp->level);
+		IXDR_PUT_BOOL(buf, objp->want_crc);
 		}
+		 if (!xdr_u_quad_t (xdrs, &objp->client))
+			 return FALSE;
 		return TRUE;
 	} else if (xdrs->x_op == XDR_DECODE) {
-		 if (!xdr_string (xdrs, &objp->filename, FILENAME_LENGTH))
+		 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
 			 return FALSE;
-		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
 		if (buf == NULL) {
-			 if (!xdr_int (xdrs, &objp->start))
+			 if (!xdr_u_int (xdrs, &objp->size))
 				 return FALSE;
-			 if (!xdr_int (xdrs, &objp->src_offset))
+			 if (!xdr_u_int (xdrs, &objp->src_offset))
 				 return FALSE;
-			 if (!xdr_int (xdrs, &objp->dest_offset))
+			 if (!xdr_u_int (xdrs, &objp->dest_offset))
 				 return FALSE;
-			 if (!xdr_int (xdrs, &objp->size))
+			 if (!xdr_int (xdrs, &objp->codec))
 				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->level))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->want_crc))
+				 return FALSE;
+
 		} else {
-			objp->start = IXDR_GET_LONG(buf);
-			objp->src_offset = IXDR_GET_LONG(buf);
-			objp->dest_offset = IXDR_GET_LONG(buf);
-			objp->size = IXDR_GET_LONG(buf);
+		objp->size = IXDR_GET_U_LONG(buf);
+		objp->src_offset = IXDR_GET_U_LONG(buf);
+		objp->dest_offset = IXDR_GET_U_LONG(buf);
+		objp->codec = IXDR_GET_LONG(buf);
+		objp->level = IXDR_GET_LONG(buf);
+		objp->want_crc = IXDR_GET_BOOL(buf);
 		}
+		 if (!xdr_u_quad_t (xdrs, &objp->client))
+			 return FALSE;
 	 return TRUE;
 	}
 
-	 if (!xdr_string (xdrs, &objp->filename, FILENAME_LENGTH))
+	 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
 		 return FALSE;
-	 if (!xdr_int (xdrs, &objp->start))
+	 if (!xdr_u_int (xdrs, &objp->size))
 		 return FALSE;
-	 if (!xdr_int (xdrs, &objp->src_offset))
+	 if (!xdr_u_int (xdrs, &objp->src_offset))
 		 return FALSE;
-	 if (!xdr_int (xdrs, &objp->dest_offset))
+	 if (!xdr_u_int (xdrs, &objp->dest_offset))
 		 return FALSE;
-	 if (!xdr_int (xdrs, &objp->size))
+	 if (!xdr_int (xdrs, &objp->codec))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->level))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->want_crc))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->client))
 		 return FALSE;
 	return TRUE;
 }
@@ -71,23 +95,302 @@ xdr_chunk (XDR *xdrs, chunk *objp)
 {
 	register int32_t *buf;
 
-	 if (!xdr_string (xdrs, &objp->filename, FILENAME_LENGTH))
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 7 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->size))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->dest_offset))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->eof))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->file_size))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->codec))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->has_crc))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->crc))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->size);
+		IXDR_PUT_U_LONG(buf, objp->dest_offset);
+		IXDR_PUT_BOOL(buf, objp->eof);
+		IXDR_PUT_U_LONG(buf, objp->file_size);
+		IXDR_PUT_LONG(buf, objp->codec);
+		IXDR_PUT_BOOL(buf, objp->has_crc);
+		IXDR_PUT_U_LONG(buf, objp->crc);
+		}
+		 if (!xdr_u_quad_t (xdrs, &objp->client))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 7 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->size))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->dest_offset))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->eof))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->file_size))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->codec))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->has_crc))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->crc))
+				 return FALSE;
+
+		} else {
+		objp->size = IXDR_GET_LONG(buf);
+		objp->dest_offset = IXDR_GET_U_LONG(buf);
+		objp->eof = IXDR_GET_BOOL(buf);
+		objp->file_size = IXDR_GET_U_LONG(buf);
+		objp->codec = IXDR_GET_LONG(buf);
+		objp->has_crc = IXDR_GET_BOOL(buf);
+		objp->crc = IXDR_GET_U_LONG(buf);
+		}
+		 if (!xdr_u_quad_t (xdrs, &objp->client))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
 		 return FALSE;
-	 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, DATA_LENGTH))
+	 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
 		 return FALSE;
 	 if (!xdr_int (xdrs, &objp->size))
 		 return FALSE;
-	 if (!xdr_int (xdrs, &objp->dest_offset))
+	 if (!xdr_u_int (xdrs, &objp->dest_offset))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->eof))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->file_size))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->codec))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->has_crc))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->crc))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->client))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_extent (XDR *xdrs, extent *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_int (xdrs, &objp->offset))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->length))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_extent_result (XDR *xdrs, extent_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->file_size))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->extents.extents_val, (u_int *) &objp->extents.extents_len, MAX_EXTENTS,
+		sizeof (extent), (xdrproc_t) xdr_extent))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->more))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_sig_args (XDR *xdrs, sig_args *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->block_size))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->start_block))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->client))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_block_sig (XDR *xdrs, block_sig *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_int (xdrs, &objp->weak))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->strong))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_sig_result (XDR *xdrs, sig_result *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->file_size))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->block_size))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->status);
+		IXDR_PUT_U_LONG(buf, objp->file_size);
+		IXDR_PUT_U_LONG(buf, objp->block_size);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->sigs.sigs_val, (u_int *) &objp->sigs.sigs_len, MAX_SIGS,
+			sizeof (block_sig), (xdrproc_t) xdr_block_sig))
+			 return FALSE;
+		 if (!xdr_bool (xdrs, &objp->more))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->file_size))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->block_size))
+				 return FALSE;
+
+		} else {
+		objp->status = IXDR_GET_LONG(buf);
+		objp->file_size = IXDR_GET_U_LONG(buf);
+		objp->block_size = IXDR_GET_U_LONG(buf);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->sigs.sigs_val, (u_int *) &objp->sigs.sigs_len, MAX_SIGS,
+			sizeof (block_sig), (xdrproc_t) xdr_block_sig))
+			 return FALSE;
+		 if (!xdr_bool (xdrs, &objp->more))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->file_size))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->block_size))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->sigs.sigs_val, (u_int *) &objp->sigs.sigs_len, MAX_SIGS,
+		sizeof (block_sig), (xdrproc_t) xdr_block_sig))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->more))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_sum_args (XDR *xdrs, sum_args *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_u_int (xdrs, &objp->offset))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->length))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->algo))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_U_LONG(buf, objp->offset);
+		IXDR_PUT_U_LONG(buf, objp->length);
+		IXDR_PUT_LONG(buf, objp->algo);
+		}
+		 if (!xdr_u_quad_t (xdrs, &objp->client))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_u_int (xdrs, &objp->offset))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->length))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->algo))
+				 return FALSE;
+
+		} else {
+		objp->offset = IXDR_GET_U_LONG(buf);
+		objp->length = IXDR_GET_U_LONG(buf);
+		objp->algo = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_u_quad_t (xdrs, &objp->client))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->offset))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->length))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->algo))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->client))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_sum_result (XDR *xdrs, sum_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->file_size))
+		 return FALSE;
+	 if (!xdr_opaque (xdrs, objp->sum, SUM_SIZE))
 		 return FALSE;
 	return TRUE;
 }
 
 bool_t
-xdr_opendir_args (XDR *xdrs, opendir_args *objp)
+xdr_filename_t (XDR *xdrs, filename_t *objp)
 {
 	register int32_t *buf;
 
-	 if (!xdr_string (xdrs, &objp->dirname, DIRNAME_LENGTH))
+	 if (!xdr_string (xdrs, objp, MAX_FILENAME_LENGTH))
 		 return FALSE;
 	return TRUE;
 }
@@ -97,7 +400,7 @@ xdr_readdir_args (XDR *xdrs, readdir_args *objp)
 {
 	register int32_t *buf;
 
-	 if (!xdr_string (xdrs, &objp->dirname, DIRNAME_LENGTH))
+	 if (!xdr_string (xdrs, &objp->dirname, MAX_PATH_LENGTH))
 		 return FALSE;
 	return TRUE;
 }
@@ -107,9 +410,590 @@ xdr_readdir_result (XDR *xdrs, readdir_result *objp)
 {
 	register int32_t *buf;
 
-	 if (!xdr_string (xdrs, &objp->filenames, MAX_FILES))
+	 if (!xdr_array (xdrs, (char **)&objp->filenames.filenames_val, (u_int *) &objp->filenames.filenames_len, MAX_FILES,
+		sizeof (filename_t), (xdrproc_t) xdr_filename_t))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_bulk_args (XDR *xdrs, bulk_args *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_array (xdrs, (char **)&objp->paths.paths_val, (u_int *) &objp->paths.paths_len, MAX_BULK_FILES,
+		sizeof (filename_t), (xdrproc_t) xdr_filename_t))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->dirname, MAX_PATH_LENGTH))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->pattern, MAX_FILENAME_LENGTH))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->cookie))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->max_bytes))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_bulk_entry (XDR *xdrs, bulk_entry *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_filename_t (xdrs, &objp->filename))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->file_size))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_bulk_result (XDR *xdrs, bulk_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_array (xdrs, (char **)&objp->entries.entries_val, (u_int *) &objp->entries.entries_len, MAX_BULK_FILES,
+		sizeof (bulk_entry), (xdrproc_t) xdr_bulk_entry))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->cookie))
 		 return FALSE;
 	 if (!xdr_bool (xdrs, &objp->more))
 		 return FALSE;
 	return TRUE;
 }
+
+bool_t
+xdr_cas_hash (XDR *xdrs, cas_hash objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_opaque (xdrs, objp, SUM_SIZE))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_cas_query (XDR *xdrs, cas_query *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_array (xdrs, (char **)&objp->hashes.hashes_val, (u_int *) &objp->hashes.hashes_len, MAX_CAS_HASHES,
+		sizeof (cas_hash), (xdrproc_t) xdr_cas_hash))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_cas_have (XDR *xdrs, cas_have *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->have.have_val, (u_int *) &objp->have.have_len, MAX_CAS_HASHES))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_cas_chunk (XDR *xdrs, cas_chunk *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_cas_hash (xdrs, objp->hash))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->size))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->codec))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_cas_manifest (XDR *xdrs, cas_manifest *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->file_size))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->start))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->hashes.hashes_val, (u_int *) &objp->hashes.hashes_len, MAX_CAS_HASHES,
+		sizeof (cas_hash), (xdrproc_t) xdr_cas_hash))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->last))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->client))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_lock_args (XDR *xdrs, lock_args *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_quad_t (xdrs, &objp->client))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->offset))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->length))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->exclusive))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_lease_args (XDR *xdrs, lease_args *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_quad_t (xdrs, &objp->client))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->filename, MAX_FILENAME_LENGTH))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->type))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_lease_result (XDR *xdrs, lease_result *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->type))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->seconds))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->file_size))
+				 return FALSE;
+		} else {
+			IXDR_PUT_LONG(buf, objp->status);
+			IXDR_PUT_LONG(buf, objp->type);
+			IXDR_PUT_U_LONG(buf, objp->seconds);
+			IXDR_PUT_U_LONG(buf, objp->file_size);
+		}
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->type))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->seconds))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->file_size))
+				 return FALSE;
+		} else {
+			objp->status = IXDR_GET_LONG(buf);
+			objp->type = IXDR_GET_LONG(buf);
+			objp->seconds = IXDR_GET_U_LONG(buf);
+			objp->file_size = IXDR_GET_U_LONG(buf);
+		}
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->type))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->seconds))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->file_size))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_renew_result (XDR *xdrs, renew_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->recalled.recalled_val, (u_int *) &objp->recalled.recalled_len, MAX_RECALLS,
+		sizeof (filename_t), (xdrproc_t) xdr_filename_t))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_watch_args (XDR *xdrs, watch_args *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_string (xdrs, &objp->dirname, MAX_PATH_LENGTH))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->cookie))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_watch_event (XDR *xdrs, watch_event *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->type))
+		 return FALSE;
+	 if (!xdr_filename_t (xdrs, &objp->name))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_watch_result (XDR *xdrs, watch_result *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->cookie))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->overflow))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->status);
+		IXDR_PUT_U_LONG(buf, objp->cookie);
+		IXDR_PUT_BOOL(buf, objp->overflow);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->events.events_val, (u_int *) &objp->events.events_len, MAX_EVENTS,
+			sizeof (watch_event), (xdrproc_t) xdr_watch_event))
+			 return FALSE;
+		 if (!xdr_bool (xdrs, &objp->more))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->cookie))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->overflow))
+				 return FALSE;
+
+		} else {
+		objp->status = IXDR_GET_LONG(buf);
+		objp->cookie = IXDR_GET_U_LONG(buf);
+		objp->overflow = IXDR_GET_BOOL(buf);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->events.events_val, (u_int *) &objp->events.events_len, MAX_EVENTS,
+			sizeof (watch_event), (xdrproc_t) xdr_watch_event))
+			 return FALSE;
+		 if (!xdr_bool (xdrs, &objp->more))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->cookie))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->overflow))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->events.events_val, (u_int *) &objp->events.events_len, MAX_EVENTS,
+		sizeof (watch_event), (xdrproc_t) xdr_watch_event))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->more))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_list_args (XDR *xdrs, list_args *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_string (xdrs, &objp->dirname, MAX_PATH_LENGTH))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->cookie))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->sorted))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_list_result (XDR *xdrs, list_result *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 5 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->total))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->count))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->cookie))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->more))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->status);
+		IXDR_PUT_U_LONG(buf, objp->total);
+		IXDR_PUT_U_LONG(buf, objp->count);
+		IXDR_PUT_U_LONG(buf, objp->cookie);
+		IXDR_PUT_BOOL(buf, objp->more);
+		}
+		 if (!xdr_string (xdrs, &objp->names, ~0))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 5 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->total))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->count))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->cookie))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->more))
+				 return FALSE;
+
+		} else {
+		objp->status = IXDR_GET_LONG(buf);
+		objp->total = IXDR_GET_U_LONG(buf);
+		objp->count = IXDR_GET_U_LONG(buf);
+		objp->cookie = IXDR_GET_U_LONG(buf);
+		objp->more = IXDR_GET_BOOL(buf);
+		}
+		 if (!xdr_string (xdrs, &objp->names, ~0))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->total))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->count))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->cookie))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->more))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->names, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_find_args (XDR *xdrs, find_args *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_string (xdrs, &objp->dirname, MAX_PATH_LENGTH))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->pattern, MAX_FILENAME_LENGTH))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->regex))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->type))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->min_size))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->max_size))
+		 return FALSE;
+	 if (!xdr_quad_t (xdrs, &objp->newer_than))
+		 return FALSE;
+	 if (!xdr_quad_t (xdrs, &objp->older_than))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->cookie))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_find_entry (XDR *xdrs, find_entry *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_string (xdrs, &objp->path, MAX_PATH_LENGTH))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->type))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->size))
+		 return FALSE;
+	 if (!xdr_quad_t (xdrs, &objp->mtime))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_find_result (XDR *xdrs, find_result *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->total))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->cookie))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->more))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->status);
+		IXDR_PUT_U_LONG(buf, objp->total);
+		IXDR_PUT_U_LONG(buf, objp->cookie);
+		IXDR_PUT_BOOL(buf, objp->more);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->entries.entries_val, (u_int *) &objp->entries.entries_len, MAX_FIND_ENTRIES,
+			sizeof (find_entry), (xdrproc_t) xdr_find_entry))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->total))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->cookie))
+				 return FALSE;
+			 if (!xdr_bool (xdrs, &objp->more))
+				 return FALSE;
+
+		} else {
+		objp->status = IXDR_GET_LONG(buf);
+		objp->total = IXDR_GET_U_LONG(buf);
+		objp->cookie = IXDR_GET_U_LONG(buf);
+		objp->more = IXDR_GET_BOOL(buf);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->entries.entries_val, (u_int *) &objp->entries.entries_len, MAX_FIND_ENTRIES,
+			sizeof (find_entry), (xdrproc_t) xdr_find_entry))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->total))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->cookie))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->more))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->entries.entries_val, (u_int *) &objp->entries.entries_len, MAX_FIND_ENTRIES,
+		sizeof (find_entry), (xdrproc_t) xdr_find_entry))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_du_result (XDR *xdrs, du_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->bytes))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->blocks))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->files))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->dirs))
+		 return FALSE;
+	 if (!xdr_bool (xdrs, &objp->cached))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_attr_result (XDR *xdrs, attr_result *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->type))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->file_size))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->status);
+		IXDR_PUT_LONG(buf, objp->type);
+		IXDR_PUT_U_LONG(buf, objp->file_size);
+		}
+		 if (!xdr_quad_t (xdrs, &objp->mtime))
+			 return FALSE;
+		 if (!xdr_u_int (xdrs, &objp->mtime_nsec))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->status))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->type))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->file_size))
+				 return FALSE;
+
+		} else {
+		objp->status = IXDR_GET_LONG(buf);
+		objp->type = IXDR_GET_LONG(buf);
+		objp->file_size = IXDR_GET_U_LONG(buf);
+		}
+		 if (!xdr_quad_t (xdrs, &objp->mtime))
+			 return FALSE;
+		 if (!xdr_u_int (xdrs, &objp->mtime_nsec))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->status))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->type))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->file_size))
+		 return FALSE;
+	 if (!xdr_quad_t (xdrs, &objp->mtime))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->mtime_nsec))
+		 return FALSE;
+	return TRUE;
+}
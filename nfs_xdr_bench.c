@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "nfs.h"
+#include "nfs_xdr_fast.h"
+
+// rutinele din nfs_xdr_fast.c fata de cele generate din nfs.x: intai verifica
+// ca scriu aceiasi bytes si citesc aceleasi valori, apoi masoara ns/operatie
+// pe xdrmem. Se construieste cu "make -f Makefile.nfs nfs_xdr_bench" (-O2,
+// fara ASan); ./nfs_xdr_bench [iteratii] iese cu 1 daca rutinele difera
+
+#define NAME "dir/some/file_name.bin"
+#define PAYLOAD 8189                // nu e multiplu de 4, deci are si completare
+
+static char wire[MAX_XFER_SIZE * 2], wire2[MAX_XFER_SIZE * 2];
+static char payload[PAYLOAD];
+static int failed = 0;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void check(const char *what, int ok) {
+    printf("%-36s %s\n", what, ok ? "ok" : "DIFFERENT");
+    if (!ok) failed = 1;
+}
+
+static u_int encode(xdrproc_t proc, void *obj, char *buf, u_int size) {
+    XDR x;
+    xdrmem_create(&x, buf, size, XDR_ENCODE);
+    if (!proc(&x, obj)) return 0;
+    return xdr_getpos(&x);
+}
+
+static int decode(xdrproc_t proc, void *obj, char *buf, u_int len) {
+    XDR x;
+    xdrmem_create(&x, buf, len, XDR_DECODE);
+    return proc(&x, obj);
+}
+
+static int same_chunk(const chunk *a, const chunk *b) {
+    return strcmp(a->filename, b->filename) == 0 && a->data.data_len == b->data.data_len &&
+           memcmp(a->data.data_val, b->data.data_val, a->data.data_len) == 0 &&
+           a->size == b->size && a->dest_offset == b->dest_offset && a->eof == b->eof &&
+           a->file_size == b->file_size && a->codec == b->codec && a->has_crc == b->has_crc &&
+           a->crc == b->crc && a->client == b->client;
+}
+
+static void compare(request *r, chunk *c) {
+    u_int len = encode((xdrproc_t)xdr_request, r, wire, sizeof(wire));
+    u_int fast = encode((xdrproc_t)xdr_request_fast, r, wire2, sizeof(wire2));
+    check("request encode", len && len == fast && memcmp(wire, wire2, len) == 0);
+
+    request q;
+    memset(&q, 0, sizeof(q));
+    int ok = decode((xdrproc_t)xdr_request_fast, &q, wire, len);
+    check("request decode", ok && strcmp(q.filename, r->filename) == 0 && q.size == r->size &&
+                            q.src_offset == r->src_offset && q.dest_offset == r->dest_offset &&
+                            q.codec == r->codec && q.level == r->level &&
+                            q.want_crc == r->want_crc && q.client == r->client);
+    xdr_free((xdrproc_t)xdr_request_fast, (char *)&q);
+
+    // completarea trebuie scrisa cu zero, nu lasata cum era in buffer
+    memset(wire2, 0x55, sizeof(wire2));
+    len = encode((xdrproc_t)xdr_chunk, c, wire, sizeof(wire));
+    fast = encode((xdrproc_t)xdr_chunk_fast, c, wire2, sizeof(wire2));
+    check("chunk encode", len && len == fast && memcmp(wire, wire2, len) == 0);
+
+    chunk d;
+    memset(&d, 0, sizeof(d));
+    ok = decode((xdrproc_t)xdr_chunk_fast, &d, wire, len);
+    check("chunk decode", ok && same_chunk(&d, c));
+    xdr_free((xdrproc_t)xdr_chunk_fast, (char *)&d);
+
+    memset(&d, 0, sizeof(d));
+    ok = decode((xdrproc_t)xdr_chunk_borrow, &d, wire, len);
+    check("chunk borrow", ok && same_chunk(&d, c) && d.data.data_val >= wire &&
+                          d.data.data_val < wire + len);
+    xdr_free((xdrproc_t)xdr_chunk_borrow, (char *)&d);
+
+    // un mesaj taiat se respinge la fel
+    chunk g, f;
+    memset(&g, 0, sizeof(g));
+    memset(&f, 0, sizeof(f));
+    int gen = decode((xdrproc_t)xdr_chunk, &g, wire, len - 4);
+    ok = decode((xdrproc_t)xdr_chunk_fast, &f, wire, len - 4);
+    check("chunk truncated", !gen && !ok);
+    xdr_free((xdrproc_t)xdr_chunk, (char *)&g);
+    xdr_free((xdrproc_t)xdr_chunk, (char *)&f);
+}
+
+static void bench(const char *name, int n, enum xdr_op op, xdrproc_t proc, void *obj, size_t size,
+                  char *buf, u_int len) {
+    XDR x;
+    double start = now();
+    for (int i = 0; i < n; i++) {
+        xdrmem_create(&x, buf, len, op);
+        proc(&x, obj);
+        if (op == XDR_DECODE) {
+            xdr_free(proc, obj);
+            memset(obj, 0, size);
+        }
+    }
+    printf("%-36s %7.1f ns\n", name, (now() - start) * 1e9 / n);
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 2000000;
+    if (n <= 0) {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+    for (int i = 0; i < PAYLOAD; i++) payload[i] = (char)(i * 7);
+
+    request r;
+    memset(&r, 0, sizeof(r));
+    r.filename = NAME;
+    r.size = 8192;
+    r.src_offset = 123456;
+    r.dest_offset = 7;
+    r.codec = CODEC_LZ4;
+    r.level = 3;
+    r.want_crc = 1;
+    r.client = 0x1122334455667788ull;
+
+    chunk c;
+    memset(&c, 0, sizeof(c));
+    c.filename = NAME;
+    c.data.data_val = payload;
+    c.data.data_len = PAYLOAD;
+    c.size = PAYLOAD;
+    c.dest_offset = 99;
+    c.eof = 1;
+    c.file_size = 1 << 20;
+    c.has_crc = 1;
+    c.crc = 0xdeadbeef;
+    c.client = 42;
+
+    compare(&r, &c);
+    if (failed) return 1;
+
+    // mesajele codate o data, pt decodari
+    static char request_wire[256], chunk_wire[sizeof(wire)];
+    u_int request_len = encode((xdrproc_t)xdr_request, &r, request_wire, sizeof(request_wire));
+    u_int chunk_len = encode((xdrproc_t)xdr_chunk, &c, chunk_wire, sizeof(chunk_wire));
+    request rq;
+    chunk cq;
+    memset(&rq, 0, sizeof(rq));
+    memset(&cq, 0, sizeof(cq));
+
+    printf("\n%d iterations, ns per call:\n", n);
+    bench("request encode rpcgen", n, XDR_ENCODE, (xdrproc_t)xdr_request, &r, sizeof(r),
+          wire, sizeof(wire));
+    bench("request encode fast", n, XDR_ENCODE, (xdrproc_t)xdr_request_fast, &r, sizeof(r),
+          wire, sizeof(wire));
+    bench("request decode rpcgen", n, XDR_DECODE, (xdrproc_t)xdr_request, &rq, sizeof(rq),
+          request_wire, request_len);
+    bench("request decode fast", n, XDR_DECODE, (xdrproc_t)xdr_request_fast, &rq, sizeof(rq),
+          request_wire, request_len);
+    bench("chunk 8K encode rpcgen", n, XDR_ENCODE, (xdrproc_t)xdr_chunk, &c, sizeof(c),
+          wire, sizeof(wire));
+    bench("chunk 8K encode fast", n, XDR_ENCODE, (xdrproc_t)xdr_chunk_fast, &c, sizeof(c),
+          wire, sizeof(wire));
+    bench("chunk 8K decode rpcgen", n, XDR_DECODE, (xdrproc_t)xdr_chunk, &cq, sizeof(cq),
+          chunk_wire, chunk_len);
+    bench("chunk 8K decode fast", n, XDR_DECODE, (xdrproc_t)xdr_chunk_fast, &cq, sizeof(cq),
+          chunk_wire, chunk_len);
+    bench("chunk 8K decode borrow", n, XDR_DECODE, (xdrproc_t)xdr_chunk_borrow, &cq, sizeof(cq),
+          chunk_wire, chunk_len);
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nfs_xdr_fast.h"
+
+// cuvinte XDR ocupate de n bytes opaci, cu tot cu completare
+#define UNITS(n) (((n) + BYTES_PER_XDR_UNIT - 1) / BYTES_PER_XDR_UNIT)
+
+// campurile fixe de dupa nume (request) si de dupa date (chunk); hyper = 2 cuvinte
+#define REQUEST_FIXED 8
+#define CHUNK_FIXED 9
+
+// peste atat lungimea nu mai incape in argumentul lui XDR_INLINE
+#define MAX_INLINE (INT32_MAX - 64 * BYTES_PER_XDR_UNIT)
+
+static int32_t *put_opaque(int32_t *buf, const char *p, u_int len) {
+    IXDR_PUT_U_LONG(buf, len);
+    if (len % BYTES_PER_XDR_UNIT) buf[UNITS(len) - 1] = 0;  // completarea cu zero
+    memcpy(buf, p, len);
+    return buf + UNITS(len);
+}
+
+static int32_t *put_hyper(int32_t *buf, u_quad_t v) {
+    IXDR_PUT_U_LONG(buf, (u_long)(v >> 32));
+    IXDR_PUT_U_LONG(buf, (u_long)(v & 0xffffffffu));
+    return buf;
+}
+
+static u_quad_t get_hyper(int32_t **buf) {
+    u_quad_t hi = (u_quad_t)IXDR_GET_U_LONG(*buf);
+    u_quad_t lo = (u_quad_t)IXDR_GET_U_LONG(*buf);
+    return hi << 32 | lo;
+}
+
+// ca xdr_string: foloseste bufferul apelantului daca are unul
+static bool_t take_name(char **name, const int32_t *src, u_int len) {
+    if (!*name && !(*name = malloc(len + 1))) return FALSE;
+    memcpy(*name, src, len);
+    (*name)[len] = '\0';
+    return TRUE;
+}
+
+bool_t xdr_request_fast(XDR *xdrs, request *objp) {
+    int32_t *buf;
+
+    if (xdrs->x_op == XDR_ENCODE) {
+        if (!objp->filename) return xdr_request(xdrs, objp);
+        size_t len = strlen(objp->filename);
+        if (len > MAX_FILENAME_LENGTH) return FALSE;
+        buf = XDR_INLINE(xdrs, (1 + UNITS(len) + REQUEST_FIXED) * BYTES_PER_XDR_UNIT);
+        if (!buf) return xdr_request(xdrs, objp);
+        buf = put_opaque(buf, objp->filename, (u_int)len);
+        IXDR_PUT_U_LONG(buf, objp->size);
+        IXDR_PUT_U_LONG(buf, objp->src_offset);
+        IXDR_PUT_U_LONG(buf, objp->dest_offset);
+        IXDR_PUT_LONG(buf, objp->codec);
+        IXDR_PUT_LONG(buf, objp->level);
+        IXDR_PUT_BOOL(buf, objp->want_crc);
+        put_hyper(buf, objp->client);
+        return TRUE;
+    }
+    if (xdrs->x_op != XDR_DECODE) return xdr_request(xdrs, objp);
+
+    u_int pos = XDR_GETPOS(xdrs);
+    if (!(buf = XDR_INLINE(xdrs, BYTES_PER_XDR_UNIT))) return xdr_request(xdrs, objp);
+    u_int len = IXDR_GET_U_LONG(buf);
+    if (len > MAX_FILENAME_LENGTH) return FALSE;
+    if (!(buf = XDR_INLINE(xdrs, (UNITS(len) + REQUEST_FIXED) * BYTES_PER_XDR_UNIT)))
+        return XDR_SETPOS(xdrs, pos) && xdr_request(xdrs, objp);
+    if (!take_name(&objp->filename, buf, len)) return FALSE;
+    buf += UNITS(len);
+    objp->size = IXDR_GET_U_LONG(buf);
+    objp->src_offset = IXDR_GET_U_LONG(buf);
+    objp->dest_offset = IXDR_GET_U_LONG(buf);
+    objp->codec = IXDR_GET_LONG(buf);
+    objp->level = IXDR_GET_LONG(buf);
+    objp->want_crc = IXDR_GET_BOOL(buf);
+    objp->client = get_hyper(&buf);
+    return TRUE;
+}
+
+static bool_t chunk_encode(XDR *xdrs, chunk *objp) {
+    if (!objp->filename || (!objp->data.data_val && objp->data.data_len) ||
+        objp->data.data_len > MAX_INLINE)
+        return xdr_chunk(xdrs, objp);
+    size_t len = strlen(objp->filename);
+    if (len > MAX_FILENAME_LENGTH) return FALSE;
+    u_int dlen = objp->data.data_len;
+    int32_t *buf = XDR_INLINE(xdrs, (2 + UNITS(len) + UNITS(dlen) + CHUNK_FIXED) * BYTES_PER_XDR_UNIT);
+    if (!buf) return xdr_chunk(xdrs, objp);
+    buf = put_opaque(buf, objp->filename, (u_int)len);
+    buf = put_opaque(buf, objp->data.data_val, dlen);
+    IXDR_PUT_LONG(buf, objp->size);
+    IXDR_PUT_U_LONG(buf, objp->dest_offset);
+    IXDR_PUT_BOOL(buf, objp->eof);
+    IXDR_PUT_U_LONG(buf, objp->file_size);
+    IXDR_PUT_LONG(buf, objp->codec);
+    IXDR_PUT_BOOL(buf, objp->has_crc);
+    IXDR_PUT_U_LONG(buf, objp->crc);
+    put_hyper(buf, objp->client);
+    return TRUE;
+}
+
+// numele si datele au lungimi variabile, deci trei verificari: lungimea
+// numelui, numele cu lungimea datelor, datele cu restul campurilor
+static bool_t chunk_decode(XDR *xdrs, chunk *objp, int borrow) {
+    u_int pos = XDR_GETPOS(xdrs);
+    int32_t *buf = XDR_INLINE(xdrs, BYTES_PER_XDR_UNIT);
+    if (!buf) return !borrow && xdr_chunk(xdrs, objp);
+    u_int len = IXDR_GET_U_LONG(buf);
+    if (len > MAX_FILENAME_LENGTH) return FALSE;
+
+    int32_t *name = XDR_INLINE(xdrs, (UNITS(len) + 1) * BYTES_PER_XDR_UNIT);
+    u_int dlen = 0;
+    if (name) {
+        buf = name + UNITS(len);
+        dlen = IXDR_GET_U_LONG(buf);
+        if (dlen > MAX_INLINE) return FALSE;
+        buf = XDR_INLINE(xdrs, (UNITS(dlen) + CHUNK_FIXED) * BYTES_PER_XDR_UNIT);
+    }
+    if (!name || !buf) {
+        // pe loc nu se poate decat din memorie
+        if (borrow) return FALSE;
+        return XDR_SETPOS(xdrs, pos) && xdr_chunk(xdrs, objp);
+    }
+
+    if (!take_name(&objp->filename, name, len)) return FALSE;
+    // ca xdr_bytes: fara date, data_val ramane cum era
+    if (dlen && borrow) {
+        objp->data.data_val = (char *)buf;
+    } else if (dlen) {
+        if (!objp->data.data_val && !(objp->data.data_val = malloc(dlen))) return FALSE;
+        memcpy(objp->data.data_val, buf, dlen);
+    }
+    objp->data.data_len = dlen;
+    buf += UNITS(dlen);
+    objp->size = IXDR_GET_LONG(buf);
+    objp->dest_offset = IXDR_GET_U_LONG(buf);
+    objp->eof = IXDR_GET_BOOL(buf);
+    objp->file_size = IXDR_GET_U_LONG(buf);
+    objp->codec = IXDR_GET_LONG(buf);
+    objp->has_crc = IXDR_GET_BOOL(buf);
+    objp->crc = IXDR_GET_U_LONG(buf);
+    objp->client = get_hyper(&buf);
+    return TRUE;
+}
+
+bool_t xdr_chunk_fast(XDR *xdrs, chunk *objp) {
+    if (xdrs->x_op == XDR_ENCODE) return chunk_encode(xdrs, objp);
+    if (xdrs->x_op == XDR_DECODE) return chunk_decode(xdrs, objp, 0);
+    return xdr_chunk(xdrs, objp);
+}
+
+bool_t xdr_chunk_borrow(XDR *xdrs, chunk *objp) {
+    if (xdrs->x_op == XDR_ENCODE) return chunk_encode(xdrs, objp);
+    if (xdrs->x_op == XDR_DECODE) return chunk_decode(xdrs, objp, 1);
+    // datele sunt ale bufferului de receptie
+    free(objp->filename);
+    objp->filename = NULL;
+    objp->data.data_val = NULL;
+    objp->data.data_len = 0;
+    return TRUE;
+}
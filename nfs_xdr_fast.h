@@ -0,0 +1,21 @@
+#ifndef NFS_XDR_FAST_H
+#define NFS_XDR_FAST_H
+
+#include "nfs.h"
+
+// codare XDR scrisa de mana pt structurile de pe calea de citire / scriere.
+// Acelasi format pe fir ca rutinele rpcgen din nfs_xdr.c, dar cu o singura
+// verificare de spatiu (XDR_INLINE) pt toata partea fixa si memcpy pt nume
+// si date, in loc de un apel xdr_* pe camp. Cand bufferul nu permite
+// (flux care nu e in memorie, spatiu insuficient) se cade pe rutina generata
+
+// inlocuiesc xdr_request / xdr_chunk, inclusiv la XDR_FREE
+bool_t xdr_request_fast(XDR *xdrs, request *objp);
+bool_t xdr_chunk_fast(XDR *xdrs, chunk *objp);
+
+// decodare pe loc: data indica direct in bufferul de receptie, fara copie.
+// Valabil doar pana cand bufferul se refoloseste (pe UDP, la svc_sendreply);
+// eliberarea cu aceeasi rutina elibereaza doar numele
+bool_t xdr_chunk_borrow(XDR *xdrs, chunk *objp);
+
+#endif